@@ -22,6 +22,12 @@ struct Constants
   uint2    window_extent;
   float2   window_pos;
   uint32_t cursor_index;
+  uint32_t drag_cache_index;
+  float    render_scale;
+  float    drag_cache_scale;
+  uint32_t window_shadow_index;
+  uint32_t distance_field_atlas_index;
+  uint32_t glyph_atlas_index;
 };
 
 enum : uint32_t
@@ -37,9 +43,26 @@ enum : uint32_t
   type_path_line,
   type_path_bezier,
 
-  type_image
+  type_image,
+
+  type_drag_cache,
+  type_window_shadow,
+  type_distance_field,
+  type_layer,
+  type_glyph
 };
 
+// pixel shader permutations, PERMUTATION is defined by compiler for each pipeline
+#define permutation_generic   0
+#define permutation_rectangle 1
+#define permutation_circle    2
+#define permutation_primitive 3
+#define permutation_image     4
+
+#ifndef PERMUTATION
+#define PERMUTATION permutation_generic
+#endif
+
 enum : uint32_t
 {
   op_none,
@@ -47,11 +70,6 @@ enum : uint32_t
   op_discard
 };
 
-enum : uint32_t
-{
-  // flag_window_shadow = 0b1
-};
-
 struct ShapeProperty
 {
   uint32_t type;
@@ -59,11 +77,6 @@ struct ShapeProperty
   float    thickness;
   uint32_t op;
   uint32_t flags;
-
-  // bool use_window_shadow()
-  // {
-  //   return bool(flags & flag_window_shadow);
-  // }
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -109,6 +122,29 @@ uint32_t get_uint(inout uint32_t offset)
 
 #include "sdf.h"
 
+// window shadow is a 9-slice image, every quad samples its slice of the image
+float4 get_window_shadow_color(float2 uv, uint32_t offset)
+{
+  float4 slice = buffer.Load<float4>(offset);
+  return images[constants.window_shadow_index].Sample(g_sampler, lerp(slice.xy, slice.zw, uv));
+}
+
+// drag cache may be larger than window and rendered at lower scale, so it is read by pixel rather than uv
+// with bilinear filtering, which is exact load when scale is 1
+// it is rendered with alpha blending onto transparent target, so its color is premultiplied,
+// restore straight color, blending it again then gives same result as rendering the content directly
+float4 get_drag_cache_color(float2 pos)
+{
+  float2 p = (pos - constants.window_pos) * constants.drag_cache_scale - 0.5;
+  int2   i = int2(floor(p));
+  float2 f = p - i;
+  Texture2D image = images[constants.drag_cache_index];
+  float4 color = lerp(lerp(image.Load(int3(i,              0)), image.Load(int3(i + int2(1, 0), 0)), f.x),
+                      lerp(image.Load(int3(i + int2(0, 1), 0)), image.Load(int3(i + int2(1, 1), 0)), f.x), f.y);
+  if (color.a == 0) discard;
+  return float4(color.rgb / color.a, color.a);
+}
+
 float4 get_color(float4 color, float w, float d, float t)
 {
   float value;
@@ -129,6 +165,45 @@ float4 get_color(float4 color, float w, float d, float t)
   return float4(color.rgb, color.a * alpha);
 }
 
+// distance baked into atlas is thresholded same as analytic one, bilinear filtering keeps it exact along edges
+float4 get_distance_field_color(float4 color, float2 pos, float2 uv, float thickness, uint32_t offset)
+{
+  float4 rect = buffer.Load<float4>(offset);
+  float  d    = images[constants.distance_field_atlas_index].Sample(g_sampler, lerp(rect.xy, rect.zw, uv)).r;
+  float  w    = length(float2(ddx_fine(pos.x), ddy_fine(pos.y)));
+  return get_color(color, w, d, thickness);
+}
+
+// layer is rendered with alpha blending onto transparent target like drag cache, so its color is premultiplied
+// layer image may be larger than layer, uv spans the layer only, opacity of composite is its alpha
+float4 get_layer_color(float2 uv, float opacity, uint32_t offset)
+{
+  Texture2D image  = images[get_uint(offset)];
+  float2    extent = buffer.Load<float2>(offset);
+  float2    size;
+  image.GetDimensions(size.x, size.y);
+  float4 color = image.Sample(g_sampler, uv * extent / size);
+  if (color.a == 0) discard;
+  return float4(color.rgb / color.a, color.a * opacity);
+}
+
+float median(float3 v)
+{
+  return max(min(v.r, v.g), min(max(v.r, v.g), v.b));
+}
+
+// median of msdf channels keeps corners of glyph sharp at any size, distance range is in window pixels
+// coverage is centered on outline, so text keeps its weight rather than growing by the anti-aliased pixel
+float4 get_glyph_color(float4 color, float2 pos, float2 uv, float thickness, uint32_t offset)
+{
+  float4 rect  = buffer.Load<float4>(offset);
+  float  range = buffer.Load<float>(offset + sizeof(float4));
+  float3 msdf  = images[constants.glyph_atlas_index].Sample(g_sampler, lerp(rect.xy, rect.zw, uv)).rgb;
+  float  w     = length(float2(ddx_fine(pos.x), ddy_fine(pos.y)));
+  float  d     = (0.5 - median(msdf)) * range;
+  return get_color(color, w, d + w * 0.5, thickness);
+}
+
 float get_distance_parition(float2 pos, inout uint offset)
 {
   float d;
@@ -153,14 +228,28 @@ float get_distance_parition(float2 pos, inout uint offset)
   return d;
 }
 
-float get_sd(float2 pos, uint32_t type, inout uint32_t offset)
+float sd_rectangle(float2 pos, inout uint32_t offset)
+{
+  float2 p0 = get_point(offset);
+  float2 p1 = get_point(offset);
+  float2 extent_div2 = (p1 - p0) * 0.5;
+  float2 center = p0 + extent_div2;
+  return sdBox(pos - center,extent_div2);
+}
+
+float sd_circle(float2 pos, inout uint32_t offset)
+{
+  float2 center = get_point(offset);
+  float  radius = get_float(offset);
+  return sdCircle(pos - center, radius);
+}
+
+// shapes which are not specialized by own permutation and have no loop
+float get_primitive_sd(float2 pos, uint32_t type, inout uint32_t offset)
 {
   float d = -3.4028235e+38;
   switch (type)
   {
-  default:
-    return 0;
-
   case type_triangle:
   {
     float2 p0 = get_point(offset);
@@ -170,24 +259,6 @@ float get_sd(float2 pos, uint32_t type, inout uint32_t offset)
     break;
   }
 
-  case type_rectangle:
-  {
-    float2 p0 = get_point(offset);
-    float2 p1 = get_point(offset);
-    float2 extent_div2 = (p1 - p0) * 0.5;
-    float2 center = p0 + extent_div2;
-    d = sdBox(pos - center,extent_div2);
-    break;
-  }
-
-  case type_circle:
-  {
-    float2 center = get_point(offset);
-    float  radius = get_float(offset);
-    d = sdCircle(pos - center, radius);
-    break;
-  }
-
   case type_line:
   {
     float2 p0 = get_point(offset);
@@ -204,6 +275,28 @@ float get_sd(float2 pos, uint32_t type, inout uint32_t offset)
     d = sdBezier(pos, p0, p1, p2);
     break;
   }
+  }
+  return d;
+}
+
+float get_sd(float2 pos, uint32_t type, inout uint32_t offset)
+{
+  float d = -3.4028235e+38;
+  switch (type)
+  {
+  default:
+    return 0;
+
+  case type_triangle:
+  case type_line:
+  case type_bezier:
+    return get_primitive_sd(pos, type, offset);
+
+  case type_rectangle:
+    return sd_rectangle(pos, offset);
+
+  case type_circle:
+    return sd_circle(pos, offset);
 
   case type_path:
   {
@@ -255,18 +348,58 @@ float4 ps(PSParameter args) : SV_TARGET
 {
   uint32_t offset = args.buffer_offset;
 
+  // shapes are in window pixels, target may be rendered at lower scale
+  float2 pos = args.pos.xy / constants.render_scale;
+
   ShapeProperty shape_property = get_shape_property(offset);
 
+#if PERMUTATION == permutation_image
+  if (shape_property.type == type_cursor)
+    return images[constants.cursor_index].Sample(g_sampler, args.uv);
+  if (shape_property.type == type_drag_cache)
+    return get_drag_cache_color(pos);
+  if (shape_property.type == type_window_shadow)
+    return get_window_shadow_color(args.uv, offset);
+  if (shape_property.type == type_distance_field)
+    return get_distance_field_color(args.color, pos, args.uv, shape_property.thickness, offset);
+  if (shape_property.type == type_layer)
+    return get_layer_color(args.uv, args.color.a, offset);
+  if (shape_property.type == type_glyph)
+    return get_glyph_color(args.color, pos, args.uv, shape_property.thickness, offset);
+  return images[get_uint(offset)].Sample(g_sampler, args.uv);
+#else
   float4 color = args.color;
-
+  float  w     = length(float2(ddx_fine(pos.x), ddy_fine(pos.y)));
+
+#if PERMUTATION == permutation_rectangle
+  float d = sd_rectangle(pos, offset);
+#elif PERMUTATION == permutation_circle
+  float d = sd_circle(pos, offset);
+#elif PERMUTATION == permutation_primitive
+  float d = get_primitive_sd(pos, shape_property.type, offset);
+#else
   if (shape_property.type == type_cursor)
     return images[constants.cursor_index].Sample(g_sampler, args.uv);
 
   if (shape_property.type == type_image)
     return images[get_uint(offset)].Sample(g_sampler, args.uv);
 
-  float w = length(float2(ddx_fine(args.pos.x), ddy_fine(args.pos.y)));
-  float d = get_sd(args.pos.xy, shape_property.type, offset);
+  if (shape_property.type == type_drag_cache)
+    return get_drag_cache_color(pos);
+
+  if (shape_property.type == type_window_shadow)
+    return get_window_shadow_color(args.uv, offset);
+
+  if (shape_property.type == type_distance_field)
+    return get_distance_field_color(color, pos, args.uv, shape_property.thickness, offset);
+
+  if (shape_property.type == type_layer)
+    return get_layer_color(args.uv, color.a, offset);
+
+  if (shape_property.type == type_glyph)
+    return get_glyph_color(color, pos, args.uv, shape_property.thickness, offset);
+
+  float d = get_sd(pos, shape_property.type, offset);
 
   while (shape_property.op != op_none)
   {
@@ -274,16 +407,23 @@ float4 ps(PSParameter args) : SV_TARGET
     {
       shape_property = get_shape_property(offset);
       color = shape_property.color;
-      d     = min(d, get_sd(args.pos.xy, shape_property.type, offset));
+      d     = min(d, get_sd(pos, shape_property.type, offset));
     }
     else if (shape_property.op == op_discard)
     {
       ShapeProperty discard_shape_property = get_shape_property(offset);
-      float discard_d = get_sd(args.pos.xy, discard_shape_property.type, offset);
+      float discard_d = get_sd(pos, discard_shape_property.type, offset);
       if (discard_d < 0) discard;
       break;
     }
   }
+#endif
 
+  // baking pass of distance field atlas only stores distance, see DistanceFieldAtlas
+#ifdef DISTANCE_FIELD_BAKE
+  return float4(d, 0, 0, 0);
+#else
   return get_color(color, w, d, shape_property.thickness);
+#endif
+#endif
 }
@@ -2,7 +2,16 @@
 
 namespace vn {
 
-void init() noexcept;
+struct InitOptions
+{
+  // opaque shapes are drawn front to back with depth write first, so hidden pixels of later passes are rejected by early depth test
+  bool depth_test{ true };
+  // every window queries pipeline statistics per frame and logs pixel shader invocations per redrawn pixel at close,
+  // compare it with depth_test on and off to measure overdraw
+  bool overdraw_stats{};
+};
+
+void init(InitOptions const& options = {}) noexcept;
 
 void destroy() noexcept;
 
@@ -11,6 +11,7 @@ inline void err_if(bool b, std::string_view msg) noexcept
   if (b)
   {
     error(msg);
+    flush_log();
     exit(EXIT_FAILURE);
   }
 }
@@ -21,6 +22,7 @@ inline void err_if(bool b, std::format_string<T...> const fmt, T&&... args) noex
   if (b)
   {
     error(fmt, std::forward<T>(args)...);
+    flush_log();
     exit(EXIT_FAILURE);
   }
 }
@@ -1,7 +1,22 @@
 #pragma once
 
 #include <print>
+#include <format>
+#include <string>
 #include <string_view>
+#include <tuple>
+#include <array>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <chrono>
+#include <bit>
+#include <unordered_set>
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
 
 namespace vn {
 
@@ -11,52 +26,534 @@ namespace vn {
 #define ConsoleColor_Orange(x) "\033[38;5;208m" x "\033[0m"
 #define ConsoleColor_Blue(x)   "\033[34m"       x "\033[0m"
 
+////////////////////////////////////////////////////////////////////////////////
+///                                Level
+////////////////////////////////////////////////////////////////////////////////
+
+enum class LogLevel : uint8_t
+{
+  debug,
+  info,
+  warn,
+  error,
+  none,
+};
+
+// logs under VN_LOG_LEVEL are stripped in compile time
+// 0: debug, 1: info, 2: warn, 3: error, 4: none
+#ifndef VN_LOG_LEVEL
+#ifdef NDEBUG
+#define VN_LOG_LEVEL 1
+#else
+#define VN_LOG_LEVEL 0
+#endif
+#endif
+
+constexpr auto Min_Log_Level = static_cast<LogLevel>(VN_LOG_LEVEL);
+
+enum class LogMode
+{
+  text,   // formatted colored text to stderr
+  binary, // compact records to file, format strings are written once and arguments are not formatted
+};
+
+////////////////////////////////////////////////////////////////////////////////
+///                               Record
+////////////////////////////////////////////////////////////////////////////////
+
+namespace detail {
+
+// non-owning strings are copied, they may be dangling when background thread formats them
+template <typename T>
+using log_arg_t = std::conditional_t<
+  std::is_convertible_v<T, std::string_view> && !std::is_null_pointer_v<std::decay_t<T>>,
+  std::string,
+  std::decay_t<T>>;
+
+enum class LogArgTag : uint8_t
+{
+  boolean,
+  character,
+  int64,
+  uint64,
+  float64,
+  string,
+};
+
+template <typename T>
+inline void append_bytes(std::string& out, T const& v) noexcept
+{
+  out.append(reinterpret_cast<char const*>(&v), sizeof(v));
+}
+
+template <typename T>
+inline void encode_log_arg(std::string& out, T const& v) noexcept
+{
+  auto encode_string = [&](std::string_view str)
+  {
+    out += static_cast<char>(LogArgTag::string);
+    append_bytes(out, static_cast<uint32_t>(str.size()));
+    out += str;
+  };
+
+  if constexpr (std::is_same_v<T, bool>)
+  {
+    out += static_cast<char>(LogArgTag::boolean);
+    out += static_cast<char>(v);
+  }
+  else if constexpr (std::is_same_v<T, char>)
+  {
+    out += static_cast<char>(LogArgTag::character);
+    out += v;
+  }
+  else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>)
+  {
+    out += static_cast<char>(LogArgTag::int64);
+    append_bytes(out, static_cast<int64_t>(v));
+  }
+  else if constexpr (std::is_integral_v<T>)
+  {
+    out += static_cast<char>(LogArgTag::uint64);
+    append_bytes(out, static_cast<uint64_t>(v));
+  }
+  else if constexpr (std::is_floating_point_v<T>)
+  {
+    out += static_cast<char>(LogArgTag::float64);
+    append_bytes(out, static_cast<double>(v));
+  }
+  else if constexpr (std::is_same_v<T, std::string>)
+    encode_string(v);
+  else
+    encode_string(std::format("{}", v));
+}
+
+struct LogArgsHandler
+{
+  void (*format)(std::string& out, std::string_view fmt, void* args) noexcept;
+  void (*encode)(std::string& out, void* args) noexcept;
+  void (*destroy)(void* args) noexcept;
+};
+
+template <typename... Args>
+struct LogArgs
+{
+  using Tuple = std::tuple<Args...>;
+
+  static void format(std::string& out, std::string_view fmt, void* args) noexcept
+  {
+    std::apply([&](auto&... a) { std::vformat_to(std::back_inserter(out), fmt, std::make_format_args(a...)); }, *static_cast<Tuple*>(args));
+  }
+
+  static void encode(std::string& out, void* args) noexcept
+  {
+    std::apply([&](auto const&... a) { (encode_log_arg(out, a), ...); }, *static_cast<Tuple*>(args));
+  }
+
+  static void destroy(void* args) noexcept
+  {
+    static_cast<Tuple*>(args)->~Tuple();
+  }
+};
+
+template <typename... Args>
+inline constexpr auto Log_Args_Handler = LogArgsHandler{ &LogArgs<Args...>::format, &LogArgs<Args...>::encode, &LogArgs<Args...>::destroy };
+
+struct alignas(16) LogRecord
+{
+  static constexpr auto Payload_Size = 80;
+
+  std::byte             args[Payload_Size];
+  LogArgsHandler const* handler{};
+  std::string_view      fmt;
+  int64_t               timestamp{};
+  LogLevel              level{};
+};
+
+// single producer single consumer ring, every thread owns one
+class LogRing
+{
+public:
+  static constexpr uint32_t Capacity = 512;
+  static_assert(std::has_single_bit(Capacity));
+
+  // block until have space, the background thread always drains
+  auto acquire() noexcept -> LogRecord&
+  {
+    auto tail = _tail.load(std::memory_order_relaxed);
+    while (tail - _head.load(std::memory_order_acquire) == Capacity)
+      std::this_thread::yield();
+    return _records[tail % Capacity];
+  }
+
+  void commit() noexcept { _tail.store(_tail.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+  auto head() const noexcept { return _head.load(std::memory_order_acquire); }
+  auto tail() const noexcept { return _tail.load(std::memory_order_acquire); }
+
+  auto at(uint32_t idx) noexcept -> LogRecord& { return _records[idx % Capacity]; }
+
+  void release(uint32_t head) noexcept { _head.store(head, std::memory_order_release); }
+
+  // owner thread exited, ring is dropped once drained
+  void close() noexcept { _closed.store(true, std::memory_order_release); }
+  auto closed() const noexcept { return _closed.load(std::memory_order_acquire); }
+
+private:
+  std::array<LogRecord, Capacity>    _records;
+  alignas(64) std::atomic<uint32_t>  _head{};
+  alignas(64) std::atomic<uint32_t>  _tail{};
+  std::atomic<bool>                  _closed{};
+};
+
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///                               Logger
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * capture format string and arguments into per thread lock-free ring,
+ * formatting and I/O are deferred to a background thread
+ */
+class Logger
+{
+private:
+  Logger() noexcept
+  {
+    std::atexit([] { instance()->shutdown(); });
+    _thread = std::jthread([this](std::stop_token token) { process(token); });
+  }
+  ~Logger() = default;
+public:
+  Logger(Logger const&)            = delete;
+  Logger(Logger&&)                 = delete;
+  Logger& operator=(Logger const&) = delete;
+  Logger& operator=(Logger&&)      = delete;
+
+  // never destroyed, logging in destructors of other static objects is still valid
+  static auto const instance() noexcept
+  {
+    static auto instance = new Logger;
+    return instance;
+  }
+
+  template <typename... T>
+  void push(LogLevel level, std::format_string<T...> const fmt, T&&... args) noexcept
+  {
+    using Args = std::tuple<detail::log_arg_t<T>...>;
+
+    // after shutdown, background thread may be killed by process exit at any time,
+    // ring of thread is also gone when thread local objects destroyed on its exit
+    auto ring = _synchronous.load(std::memory_order_relaxed) ? nullptr : local_ring();
+    if (!ring)
+    {
+      auto str = std::format(fmt, std::forward<T>(args)...);
+      auto lock = std::lock_guard{ _output_mutex };
+      write_text(level, str);
+      return;
+    }
+
+    auto& record = ring->acquire();
+    record.level     = level;
+    record.timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+    if constexpr (sizeof(Args) <= detail::LogRecord::Payload_Size && alignof(Args) <= alignof(detail::LogRecord))
+    {
+      record.fmt     = fmt.get();
+      record.handler = &detail::Log_Args_Handler<detail::log_arg_t<T>...>;
+      new (record.args) Args{ detail::log_arg_t<T>(std::forward<T>(args))... };
+    }
+    else
+    {
+      // too large arguments, format in place
+      record.fmt     = "{}";
+      record.handler = &detail::Log_Args_Handler<std::string>;
+      new (record.args) std::tuple<std::string>{ std::format(fmt, std::forward<T>(args)...) };
+    }
+    ring->commit();
+    wake_up();
+  }
+
+  // block until all records pushed before are written
+  void flush() noexcept
+  {
+    auto targets = std::vector<std::pair<std::shared_ptr<detail::LogRing>, uint32_t>>{};
+    {
+      auto lock = std::lock_guard{ _rings_mutex };
+      targets.reserve(_rings.size());
+      for (auto const& ring : _rings)
+        targets.emplace_back(ring, ring->tail());
+    }
+    for (auto const& [ring, tail] : targets)
+      while (static_cast<int32_t>(tail - ring->head()) > 0)
+        std::this_thread::yield();
+  }
+
+  void set_mode(LogMode mode, std::string_view path) noexcept
+  {
+    flush();
+    auto lock = std::lock_guard{ _output_mutex };
+    if (_file) fclose(_file);
+    _file = {};
+    _mode = mode;
+    _format_ids.clear();
+    if (mode == LogMode::binary)
+    {
+      _file = fopen(std::string{ path }.c_str(), "wb");
+      if (!_file)
+      {
+        _mode = LogMode::text;
+        std::println(stderr, ConsoleColor_Red("[error] failed to open binary log file {}"), path);
+        return;
+      }
+      fwrite("VNLOG\x01", 1, 6, _file);
+    }
+  }
+
+private:
+  // ring is closed when its thread exits, so short lived threads not leave rings behind
+  struct LocalRing
+  {
+    std::shared_ptr<detail::LogRing> ring;
+
+    ~LocalRing()
+    {
+      ring->close();
+      _local_ring_closed = true;
+      instance()->wake_up();
+    }
+  };
+
+  // @return nullptr after ring of thread closed
+  auto local_ring() noexcept -> detail::LogRing*
+  {
+    if (_local_ring_closed) return {};
+    thread_local auto local = [this]
+    {
+      auto ring = std::make_shared<detail::LogRing>();
+      auto lock = std::lock_guard{ _rings_mutex };
+      _rings.emplace_back(ring);
+      _rings_version.fetch_add(1, std::memory_order_release);
+      return LocalRing{ ring };
+    }();
+    return local.ring.get();
+  }
+
+  // signal is bumped by every commit, background thread is only notified when it sleeps on signal
+  void wake_up() noexcept
+  {
+    _signal.fetch_add(1, std::memory_order_seq_cst);
+    if (_waiting.load(std::memory_order_seq_cst))
+      _signal.notify_one();
+  }
+
+  // sleep until signal changes from last seen value, check it again after announcing so no commit is missed
+  void wait_signal(uint32_t signal) noexcept
+  {
+    _waiting.store(true, std::memory_order_seq_cst);
+    if (_signal.load(std::memory_order_seq_cst) == signal)
+      _signal.wait(signal, std::memory_order_seq_cst);
+    _waiting.store(false, std::memory_order_relaxed);
+  }
+
+  void shutdown() noexcept
+  {
+    flush();
+    _synchronous.store(true, std::memory_order_relaxed);
+    flush();
+  }
+
+  void process(std::stop_token token) noexcept
+  {
+    auto wake = std::stop_callback{ token, [this] { wake_up(); } };
+
+    auto rings    = std::vector<std::shared_ptr<detail::LogRing>>{};
+    auto releases = std::vector<std::pair<detail::LogRing*, uint32_t>>{};
+    auto version  = uint32_t{};
+    auto buffer   = std::string{};
+    while (true)
+    {
+      // read signal before draining, commits after it wake the wait below
+      auto signal = _signal.load(std::memory_order_seq_cst);
+
+      // update local copy of rings only when new thread registered or closed ring dropped
+      if (auto v = _rings_version.load(std::memory_order_acquire); v != version)
+      {
+        auto lock = std::lock_guard{ _rings_mutex };
+        rings   = _rings;
+        version = _rings_version.load(std::memory_order_relaxed);
+      }
+
+      auto stop    = token.stop_requested();
+      auto written = uint32_t{};
+      auto drained = false; // a closed ring is drained in this pass
+      {
+        auto lock = std::lock_guard{ _output_mutex };
+        for (auto const& ring : rings)
+        {
+          // closed flag is read before tail, so nothing is committed after an empty closed ring is seen
+          auto closed = ring->closed();
+          auto head   = ring->head();
+          auto tail   = ring->tail();
+          drained |= closed;
+          if (head == tail) continue;
+          for (; head != tail; ++head, ++written)
+          {
+            auto& record = ring->at(head);
+            write(record, buffer);
+            record.handler->destroy(record.args);
+          }
+          releases.emplace_back(ring.get(), head);
+        }
+
+        // make sure records are handed to OS before flush() returns, once for the whole pass
+        if (written) fflush(_file ? _file : stderr);
+        for (auto [ring, head] : releases)
+          ring->release(head);
+        releases.clear();
+      }
+
+      if (drained)
+      {
+        auto lock = std::lock_guard{ _rings_mutex };
+        std::erase_if(_rings, [](auto const& ring) { return ring->closed() && ring->head() == ring->tail(); });
+        _rings_version.fetch_add(1, std::memory_order_release);
+      }
+
+      if (stop && !written) break;
+      if (!written && !drained) wait_signal(signal);
+    }
+  }
+
+  void write(detail::LogRecord& record, std::string& buffer) noexcept
+  {
+    buffer.clear();
+    if (_mode == LogMode::text)
+    {
+      record.handler->format(buffer, record.fmt, record.args);
+      write_text(record.level, buffer);
+      return;
+    }
+
+    // binary record
+    // format: [0][u64 id][u32 size][format string]
+    // record: [1][u8 level][i64 timestamp][u64 format id][u32 size][tag, value...]
+    auto id = reinterpret_cast<uint64_t>(record.fmt.data());
+    if (_format_ids.emplace(id).second)
+    {
+      buffer += '\0';
+      detail::append_bytes(buffer, id);
+      detail::append_bytes(buffer, static_cast<uint32_t>(record.fmt.size()));
+      buffer += record.fmt;
+    }
+    buffer += '\1';
+    detail::append_bytes(buffer, record.level);
+    detail::append_bytes(buffer, record.timestamp);
+    detail::append_bytes(buffer, id);
+    auto size_pos = buffer.size();
+    detail::append_bytes(buffer, uint32_t{});
+    record.handler->encode(buffer, record.args);
+    auto size = static_cast<uint32_t>(buffer.size() - size_pos - sizeof(uint32_t));
+    memcpy(buffer.data() + size_pos, &size, sizeof(size));
+    fwrite(buffer.data(), 1, buffer.size(), _file);
+  }
+
+  static void write_text(LogLevel level, std::string_view msg) noexcept
+  {
+    switch (level)
+    {
+    case LogLevel::debug: std::println(stderr, ConsoleColor_Blue("[debug] {}"),   msg); break;
+    case LogLevel::info:  std::println(stderr, ConsoleColor_Green("[info]  {}"),  msg); break;
+    case LogLevel::warn:  std::println(stderr, ConsoleColor_Orange("[warn]  {}"), msg); break;
+    case LogLevel::error: std::println(stderr, ConsoleColor_Red("[error] {}"),    msg); break;
+    case LogLevel::none:  break;
+    }
+  }
+
+private:
+  std::mutex                                    _rings_mutex;
+  std::vector<std::shared_ptr<detail::LogRing>> _rings;
+  std::atomic<uint32_t>                         _rings_version{};
+  std::mutex                                    _output_mutex;
+  LogMode                                       _mode{};
+  FILE*                                         _file{};
+  std::unordered_set<uint64_t>                  _format_ids;
+  std::atomic<bool>                             _synchronous{};
+  std::atomic<uint32_t>                         _signal{};
+  std::atomic<bool>                             _waiting{};
+  static inline thread_local bool               _local_ring_closed{};
+  std::jthread                                  _thread;
+};
+
+/**
+ * switch log output mode
+ * @param mode
+ * @param path file path of binary log
+ */
+inline void set_log_mode(LogMode mode, std::string_view path = "vn.log") noexcept
+{
+  Logger::instance()->set_mode(mode, path);
+}
+
+/// block until all pushed logs are written
+inline void flush_log() noexcept
+{
+  Logger::instance()->flush();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///                                 Log
+////////////////////////////////////////////////////////////////////////////////
+
 inline void error(std::string_view msg) noexcept
 {
-  std::println(stderr, ConsoleColor_Red("[error] {}"), msg);
+  if constexpr (Min_Log_Level <= LogLevel::error)
+    Logger::instance()->push(LogLevel::error, "{}", msg);
 }
 
 template <typename... T>
 inline void error(std::format_string<T...> const fmt, T&&... args) noexcept
 {
-  std::println(stderr, ConsoleColor_Red("[error] {}"), std::format(fmt, std::forward<T>(args)...));
+  if constexpr (Min_Log_Level <= LogLevel::error)
+    Logger::instance()->push(LogLevel::error, fmt, std::forward<T>(args)...);
 }
 
 inline void info(std::string_view msg) noexcept
 {
-  std::println(stderr, ConsoleColor_Green("[info]  {}"), msg);
+  if constexpr (Min_Log_Level <= LogLevel::info)
+    Logger::instance()->push(LogLevel::info, "{}", msg);
 }
 
 template <typename... T>
 inline void info(std::format_string<T...> const fmt, T&&... args) noexcept
 {
-  std::println(stderr, ConsoleColor_Green("[info]  {}"), std::format(fmt, std::forward<T>(args)...));
+  if constexpr (Min_Log_Level <= LogLevel::info)
+    Logger::instance()->push(LogLevel::info, fmt, std::forward<T>(args)...);
 }
 
 inline void warn(std::string_view msg) noexcept
 {
-  std::println(stderr, ConsoleColor_Orange("[warn]  {}"), msg);
+  if constexpr (Min_Log_Level <= LogLevel::warn)
+    Logger::instance()->push(LogLevel::warn, "{}", msg);
 }
 
 template <typename... T>
 inline void warn(std::format_string<T...> const fmt, T&&... args) noexcept
 {
-  std::println(stderr, ConsoleColor_Orange("[warn]  {}"), std::format(fmt, std::forward<T>(args)...));
+  if constexpr (Min_Log_Level <= LogLevel::warn)
+    Logger::instance()->push(LogLevel::warn, fmt, std::forward<T>(args)...);
 }
 
 inline void debug(std::string_view msg) noexcept
 {
-#ifndef NDEBUG
-  std::println(stderr, ConsoleColor_Blue("[debug] {}"), msg);
-#endif
+  if constexpr (Min_Log_Level <= LogLevel::debug)
+    Logger::instance()->push(LogLevel::debug, "{}", msg);
 }
 
 template <typename... T>
 inline void debug(std::format_string<T...> const fmt, T&&... args) noexcept
 {
-#ifndef NDEBUG
-  std::println(stderr, ConsoleColor_Blue("[debug] {}"), std::format(fmt, std::forward<T>(args)...));
-#endif
+  if constexpr (Min_Log_Level <= LogLevel::debug)
+    Logger::instance()->push(LogLevel::debug, fmt, std::forward<T>(args)...);
 }
 
 }
@@ -122,6 +122,13 @@ auto is_maxmized() noexcept -> bool;
  */
 auto is_minimized() noexcept -> bool;
 
+/**
+ * mark content of current window changed
+ * moving or resizing window is recorded once and then reused, so content which keeps changing
+ * like animation should call this in every update to be recorded again next frame
+ */
+void invalidate_window() noexcept;
+
 /// minimize window
 void minimize_window() noexcept;
 
@@ -159,6 +166,20 @@ void set_render_pos(int x, int y) noexcept;
 /// get render position
 auto get_render_pos() noexcept -> glm::vec2;
 
+/**
+ * set tolerance of flattening beziers into lines, keeps until set again
+ * lower tolerance is smoother but every pixel of curve evaluates more lines
+ * @param tolerance max distance in pixels between curve and its lines, default is 0.25
+ */
+void set_curve_tolerance(float tolerance) noexcept;
+
+/**
+ * set font of text drawn after it, keeps until set again, font is loaded at first use
+ * font failed to load is logged once and text drawn with it is skipped
+ * @param filename truetype or opentype file, first font of collection like ttc is used, default is msyh.ttc of fonts folder of system
+ */
+void set_font(std::string_view filename) noexcept;
+
 /// use union operator between shapes
 void begin_union() noexcept;
 
@@ -186,6 +207,50 @@ void end_path(Color color = {}, float thickness = {}) noexcept;
  */
 void discard_rectangle(glm::vec2 left_top, glm::vec2 right_bottom) noexcept;
 
+/**
+ * clip shapes drawn after it to rectangle until pop, clips nest and are intersected with outer ones
+ * quads of shapes are shrunk to the clip when recording and dropped with their shape properties when outside, so clipping costs nothing per pixel
+ * @param left_top
+ * @param right_bottom
+ */
+void push_clip_rect(glm::vec2 left_top, glm::vec2 right_bottom) noexcept;
+
+/// end the clip of last push_clip_rect
+void pop_clip_rect() noexcept;
+
+/**
+ * shapes drawn until end_layer are cached in an offscreen image of layer at current render position,
+ * window only draws the image as one quad, and the shapes are rendered again only when invalidate key changes,
+ * or when glyphs or images missing while recording it become ready
+ * shapes are clipped to layer, layers not nest, widgets in layer still hit test at their untransformed position
+ * @param id unique in window
+ * @param extent
+ */
+void begin_layer(size_t id, glm::vec2 extent) noexcept;
+
+/**
+ * end layer of last begin_layer and draw its image
+ * @param invalidate_key content of layer changes whenever the key changes
+ * @param opacity alpha of whole layer
+ * @param offset move image from position of layer
+ * @param scale scale image at left top of it
+ */
+void end_layer(size_t invalidate_key, float opacity = 1.f, glm::vec2 offset = {}, float scale = 1.f) noexcept;
+
+/**
+ * shapes drawn until end_static_block are recorded once, later frames of same version copy them back without running the drawing code
+ * block is recorded again when version, render position or clip changes, or while glyphs or images drawn in it are not ready,
+ * and is dropped when a frame not draws it
+ * only for static shapes, widgets in block not hit test when it is copied, blocks and layers not nest in it
+ * @param id unique in window
+ * @param version
+ * @return whether shapes of block need drawing, only draw them when true, end_static_block is called either way
+ */
+auto begin_static_block(size_t id, uint32_t version) noexcept -> bool;
+
+/// end the block of last begin_static_block
+void end_static_block() noexcept;
+
 ////////////////////////////////////////////////////////////////////////////////
 ///                            Basic Shape
 ////////////////////////////////////////////////////////////////////////////////
@@ -227,7 +292,7 @@ void circle(glm::vec2 center, float radius, Color color = {}, float thickness =
 void line(glm::vec2 p0, glm::vec2 p1, Color color = {}) noexcept;
 
 /**
- * draw a quadratic bezier
+ * draw a quadratic bezier, it is flattened into lines, see set_curve_tolerance
  * @param p0
  * @param p1
  * @param p2
@@ -235,35 +300,71 @@ void line(glm::vec2 p0, glm::vec2 p1, Color color = {}) noexcept;
  */
 void bezier(glm::vec2 p0, glm::vec2 p1, glm::vec2 p2, Color color = 0) noexcept;
 
+/**
+ * draw a cubic bezier, it is flattened into lines, see set_curve_tolerance
+ * @param p0
+ * @param p1
+ * @param p2
+ * @param p3
+ * @param color
+ */
+void cubic_bezier(glm::vec2 p0, glm::vec2 p1, glm::vec2 p2, glm::vec2 p3, Color color = 0) noexcept;
+
 /**
  * display an image specified by position (x, y)
+ * image is loaded at first use and appears from a later frame once uploaded
  * @param filename
  * @param x
  * @param y
  */
 void image(std::string_view filename, int x, int y) noexcept;
 
+/**
+ * draw utf-8 text, lines are broken by '\n', glyphs are sampled from msdf atlas so text of any size stays sharp
+ * glyphs are rasterized in background at first use and appear from a later frame
+ * @param str
+ * @param left_top left top of first line
+ * @param size pixels per em
+ * @param color
+ * @return extent of text, empty when font failed to load
+ */
+auto text(std::string_view str, glm::vec2 left_top, float size, Color color = {}) noexcept -> glm::vec2;
+
+/**
+ * get extent of text without drawing it, see text
+ * @param str
+ * @param size pixels per em
+ */
+auto text_extent(std::string_view str, float size) noexcept -> glm::vec2;
+
 ////////////////////////////////////////////////////////////////////////////////
 ///                              UI Widget
 ////////////////////////////////////////////////////////////////////////////////
 
 /**
- * whether cursor hover on specific region
+ * whether cursor hover on widget, widget is inserted into hit grid of window so only the top-most one of overlapping
+ * widgets is hovered, widgets drawn later are on top
+ * top-most widget is resolved from widgets of last recording, since widgets drawn later in this one are not known yet,
+ * so a widget appearing, moving or raised under cursor takes hover one frame later, this lag is deliberate
+ * @param id unique in window
  * @param left_top
  * @param right_bottom
  */
-auto is_hover_on(glm::vec2 left_top, glm::vec2 right_bottom) noexcept -> bool;
+auto is_hover_on(size_t id, glm::vec2 left_top, glm::vec2 right_bottom) noexcept -> bool;
 
 /**
- * whether cursor click on specific region
+ * whether cursor click on widget, widget is inserted into hit grid like is_hover_on
+ * widget is clicked when it is the top-most one at both press and release position, with same one frame lag as hover
+ * @param id unique in window
  * @param left_top
  * @param right_bottom
  */
-auto is_click_on(glm::vec2 left_top, glm::vec2 right_bottom) noexcept -> bool;
+auto is_click_on(size_t id, glm::vec2 left_top, glm::vec2 right_bottom) noexcept -> bool;
 
 /**
  * draw a button, can draw an icon in the center of button
  * default have a color lerp animation when cursor hover on button and leave on it
+ * only the top-most widget under cursor in last recording is hovered or clicked, see is_hover_on
  * TODO: add bitmap draw replace draw icon by hand
  * @param x
  * @param y
@@ -290,4 +391,41 @@ auto button(
   Color                                   icon_color       = {},
   Color                                   icon_hover_color = {}) noexcept-> bool;
 
+/**
+ * draw a virtualized list, only items in view and a few around are drawn, so cost not grows with item count
+ * wheel over list or its items scrolls it kinetically unless another widget is drawn over them, items are clipped to list
+ * @param id unique in window
+ * @param left_top
+ * @param extent
+ * @param item_count
+ * @param item_height height of item by index, heights are measured once when items are appended
+ * @param draw_item draw item by index and its extent, render position is moved to left top of item
+ * @param version measure heights of all items again when it changes
+ */
+void list(
+  size_t                                          id,
+  glm::vec2                                       left_top,
+  glm::vec2                                       extent,
+  uint32_t                                        item_count,
+  std::function<float(uint32_t)> const&           item_height,
+  std::function<void(uint32_t, glm::vec2)> const& draw_item,
+  uint32_t                                        version = {}) noexcept;
+
+/**
+ * draw a virtualized list of items with same height
+ * @param id unique in window
+ * @param left_top
+ * @param extent
+ * @param item_count
+ * @param item_height
+ * @param draw_item draw item by index and its extent, render position is moved to left top of item
+ */
+void list(
+  size_t                                          id,
+  glm::vec2                                       left_top,
+  glm::vec2                                       extent,
+  uint32_t                                        item_count,
+  float                                           item_height,
+  std::function<void(uint32_t, glm::vec2)> const& draw_item) noexcept;
+
 }}
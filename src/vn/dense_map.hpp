@@ -0,0 +1,135 @@
+#pragma once
+
+#include "error_handling.hpp"
+
+#include <vector>
+#include <span>
+#include <limits>
+#include <cstdint>
+#include <assert.h>
+
+namespace vn {
+
+/**
+ * allocate small integer ids, freed ids are reused first so ids keep dense
+ * id 0 is reserved as invalid id
+ */
+class IdAllocator
+{
+public:
+  auto alloc() noexcept -> uint32_t
+  {
+    if (_free_ids.empty())
+    {
+      err_if(_max_id == std::numeric_limits<uint32_t>::max() - 1, "[IdAllocator] Failed to allocate id, exceed the max id");
+      return ++_max_id;
+    }
+    auto id = _free_ids.back();
+    _free_ids.pop_back();
+    return id;
+  }
+
+  void free(uint32_t id) noexcept
+  {
+    assert(id && id <= _max_id);
+    _free_ids.emplace_back(id);
+  }
+
+private:
+  std::vector<uint32_t> _free_ids;
+  uint32_t              _max_id{};
+};
+
+/**
+ * sparse set which maps small integer id to value
+ * values are packed in a dense array, lookup is two array accesses and iteration only touches live values
+ * erase moves last value into the hole, so references and order are not stable across emplace and erase
+ */
+template <typename T>
+class DenseMap
+{
+public:
+  auto emplace(uint32_t id) noexcept -> T&
+  {
+    err_if(contains(id), "[DenseMap] Failed to emplace {}, it's already exist", id);
+    if (id >= _sparse.size())
+      _sparse.resize(id + 1, Invalid_Index);
+    _sparse[id] = static_cast<uint32_t>(_dense.size());
+    _ids.emplace_back(id);
+    return _dense.emplace_back();
+  }
+
+  void erase(uint32_t id) noexcept
+  {
+    err_if(!contains(id), "[DenseMap] Failed to erase {}, it's not exist", id);
+    auto index = _sparse[id];
+    auto last  = static_cast<uint32_t>(_dense.size() - 1);
+    if (index != last)
+    {
+      _dense[index]        = std::move(_dense[last]);
+      _ids[index]          = _ids[last];
+      _sparse[_ids[index]] = index;
+    }
+    _dense.pop_back();
+    _ids.pop_back();
+    _sparse[id] = Invalid_Index;
+  }
+
+  auto contains(uint32_t id) const noexcept
+  {
+    return id < _sparse.size() && _sparse[id] != Invalid_Index;
+  }
+
+  auto operator[](uint32_t id) noexcept -> T&
+  {
+    assert(contains(id));
+    return _dense[_sparse[id]];
+  }
+
+  auto operator[](uint32_t id) const noexcept -> T const&
+  {
+    assert(contains(id));
+    return _dense[_sparse[id]];
+  }
+
+  auto at(uint32_t id) noexcept -> T&
+  {
+    err_if(!contains(id), "[DenseMap] Failed to get {}, it's not exist", id);
+    return _dense[_sparse[id]];
+  }
+
+  auto at(uint32_t id) const noexcept -> T const&
+  {
+    err_if(!contains(id), "[DenseMap] Failed to get {}, it's not exist", id);
+    return _dense[_sparse[id]];
+  }
+
+  auto size()  const noexcept { return static_cast<uint32_t>(_dense.size()); }
+  auto empty() const noexcept { return _dense.empty();                       }
+
+  auto ids()    const noexcept { return std::span{ _ids };   }
+  auto values()       noexcept { return std::span{ _dense }; }
+  auto values() const noexcept { return std::span{ _dense }; }
+
+  auto begin()       noexcept { return _dense.begin(); }
+  auto end()         noexcept { return _dense.end();   }
+  auto begin() const noexcept { return _dense.begin(); }
+  auto end()   const noexcept { return _dense.end();   }
+
+  /// @param func invoked by (id, T&)
+  template <typename Func>
+  void for_each(Func&& func) noexcept
+  {
+    for (auto i = uint32_t{}; i < _dense.size(); ++i)
+      func(_ids[i], _dense[i]);
+  }
+
+private:
+  static constexpr auto Invalid_Index = std::numeric_limits<uint32_t>::max();
+
+  std::vector<uint32_t> _sparse;
+  std::vector<uint32_t> _ids;
+  std::vector<T>        _dense;
+};
+
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <thread>
+#include <type_traits>
+
+namespace vn {
+
+/**
+ * bounded lock-free multi-producer single-consumer queue
+ * every cell carries a sequence number, producers claim a position by cas and publish the cell by storing sequence,
+ * consumer only reads its own position so popping never touches shared counters
+ */
+template <typename T, uint32_t Capacity>
+requires (std::has_single_bit(Capacity))            &&
+         std::is_trivially_copyable_v<T>            &&
+         std::is_nothrow_default_constructible_v<T>
+class MPSCQueue
+{
+public:
+  MPSCQueue() noexcept
+  {
+    for (auto i = size_t{}; i < Capacity; ++i)
+      _cells[i].sequence.store(i, std::memory_order_relaxed);
+  }
+
+  MPSCQueue(MPSCQueue const&)            = delete;
+  MPSCQueue(MPSCQueue&&)                 = delete;
+  MPSCQueue& operator=(MPSCQueue const&) = delete;
+  MPSCQueue& operator=(MPSCQueue&&)      = delete;
+
+  /// return false if queue is full
+  [[nodiscard]]
+  auto try_push(T const& value) noexcept -> bool
+  {
+    auto pos = _enqueue_pos.load(std::memory_order_relaxed);
+    while (true)
+    {
+      auto& cell = _cells[pos & Mask];
+      auto  diff = static_cast<intptr_t>(cell.sequence.load(std::memory_order_acquire)) - static_cast<intptr_t>(pos);
+      if (diff == 0)
+      {
+        if (_enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+        {
+          cell.value = value;
+          cell.sequence.store(pos + 1, std::memory_order_release);
+          return true;
+        }
+      }
+      else if (diff < 0)
+        return false;
+      else
+        pos = _enqueue_pos.load(std::memory_order_relaxed);
+    }
+  }
+
+  /// spin until have free cell, only block when consumer fall behind a whole queue
+  void push(T const& value) noexcept
+  {
+    while (!try_push(value))
+      std::this_thread::yield();
+  }
+
+  /// only call in consumer thread
+  [[nodiscard]]
+  auto try_pop(T& value) noexcept -> bool
+  {
+    auto& cell = _cells[_dequeue_pos & Mask];
+    if (cell.sequence.load(std::memory_order_acquire) != _dequeue_pos + 1)
+      return false;
+    value = cell.value;
+    cell.sequence.store(_dequeue_pos + Capacity, std::memory_order_release);
+    ++_dequeue_pos;
+    return true;
+  }
+
+  static constexpr auto capacity() noexcept { return Capacity; }
+
+private:
+  static constexpr auto Mask            = size_t{ Capacity - 1 };
+  static constexpr auto Cache_Line_Size = 64;
+
+  struct alignas(Cache_Line_Size) Cell
+  {
+    std::atomic<size_t> sequence;
+    T                   value{};
+  };
+
+  std::array<Cell, Capacity>                  _cells;
+  alignas(Cache_Line_Size) std::atomic<size_t> _enqueue_pos{};
+  alignas(Cache_Line_Size) size_t              _dequeue_pos{};
+};
+
+}
@@ -7,6 +7,7 @@
 #include <memory>
 #include <assert.h>
 #include <algorithm>
+#include <bit>
 
 namespace vn {
 
@@ -30,12 +31,23 @@ public:
   public:
     constexpr auto valid() const noexcept { return _generation != 0; }
 
+    constexpr bool operator==(Handle const&) const noexcept = default;
+
   private:
     uint16_t _block_idx{};
     uint16_t _slot_idx{};
     uint32_t _generation{};
   };
 
+  struct Stats
+  {
+    uint32_t alive{};
+    uint32_t capacity{};
+    uint32_t free_slots{};
+    float    occupancy{};     // alive objects / allocated slots
+    float    fragmentation{}; // reusable holes / ever used slots
+  };
+
   ObjectPool() noexcept
   {
     _blocks.emplace_back(std::make_unique<Block>());
@@ -43,10 +55,7 @@ public:
 
   ~ObjectPool() noexcept
   {
-    err_if(std::ranges::any_of(_blocks, [](auto const& block)
-    {
-      return std::ranges::any_of(*block, [](auto const& slot) { return slot.alive; });
-    }), "[ObjectPool] Failed to destruct ObjectPool. Still have objects are undestroied");
+    err_if(_size != 0, "[ObjectPool] Failed to destruct ObjectPool. Still have {} objects are undestroied", _size);
   }
 
   ObjectPool(ObjectPool const&)            = delete;
@@ -57,15 +66,17 @@ public:
   [[nodiscard]]
   auto create() noexcept
   {
+    ++_size;
+
     // create new one if free list is empty
     if (_free_list.empty())
     {
-      auto slot = get_slot(_block_idx, _slot_idx);
-      assert(!slot->alive && !slot->generation);
-      new (&slot->obj) T{};
-      slot->alive      = true;
-      slot->generation = 1;
-      auto handle = Handle{ _block_idx, _slot_idx, slot->generation };
+      auto& block = *_blocks[_block_idx];
+      assert(!block.is_alive(_slot_idx) && !block.generations[_slot_idx]);
+      new (block.get(_slot_idx)) T{};
+      block.set_alive(_slot_idx);
+      block.generations[_slot_idx] = 1;
+      auto handle = Handle{ _block_idx, _slot_idx, 1 };
       if (++_slot_idx == BlockCapacity)
       {
         _slot_idx = 0;
@@ -78,71 +89,162 @@ public:
     }
 
     // use free list
-    auto& free_slot = _free_list.back(); 
+    auto free_slot = _free_list.back();
     _free_list.pop_back();
-    auto slot = get_slot(free_slot.block_idx, free_slot.slot_idx);
-    assert(!slot->alive && slot->generation);
-    new (&slot->obj) T{};
-    slot->alive = true;
-    return Handle{ free_slot.block_idx, free_slot.slot_idx, slot->generation };
+    auto& block = *_blocks[free_slot.block_idx];
+    assert(!block.is_alive(free_slot.slot_idx) && block.generations[free_slot.slot_idx]);
+    new (block.get(free_slot.slot_idx)) T{};
+    block.set_alive(free_slot.slot_idx);
+    return Handle{ free_slot.block_idx, free_slot.slot_idx, block.generations[free_slot.slot_idx] };
   }
 
   [[nodiscard]]
   auto get(Handle handle) noexcept -> T*
   {
-    auto slot = get_slot(handle._block_idx, handle._slot_idx);
-    assert(handle.valid() && slot->alive && slot->generation == handle._generation);
-    return slot->get();
+    auto& block = get_block(handle);
+    return block.get(handle._slot_idx);
   }
 
   [[nodiscard]]
   auto get(Handle handle) const noexcept -> T const*
   {
-    auto slot = get_slot(handle._block_idx, handle._slot_idx);
-    assert(handle.valid() && slot->alive && slot->generation == handle._generation);
-    return slot->get();
+    auto const& block = get_block(handle);
+    return block.get(handle._slot_idx);
   }
 
   void destroy(Handle& handle) noexcept
   {
-    auto slot = get_slot(handle._block_idx, handle._slot_idx);
-    assert(handle.valid() && slot->alive && slot->generation == handle._generation);
-    slot->get()->~T();
-    slot->alive = false;
-    ++slot->generation;
-    err_if(slot->generation == std::numeric_limits<decltype(slot->generation)>::max(),
-      "[ObjectPool] Failed to destroy object, exceed the max slot generation");
-    _free_list.emplace_back(handle._block_idx, handle._slot_idx);
+    auto& block = get_block(handle);
+    block.get(handle._slot_idx)->~T();
+    release_slot(block, handle._block_idx, handle._slot_idx);
     handle = {};
   }
 
-private:
-  auto get_slot(uint16_t block_idx, uint16_t slot_idx) const noexcept
+  /**
+   * visit live objects, only words of alive bitset which have live objects are touched
+   * @param func invoked by (Handle, T&) or (T&)
+   */
+  template <typename Func>
+  void for_each(Func&& func) noexcept
+  {
+    for (auto block_idx = uint16_t{}; block_idx < _blocks.size(); ++block_idx)
+    {
+      auto& block = *_blocks[block_idx];
+      if (!block.alive_count) continue;
+
+      for (auto word_idx = uint32_t{}; word_idx < Block::Word_Count; ++word_idx)
+      {
+        for (auto bits = block.alive_bits[word_idx]; bits; bits &= bits - 1)
+        {
+          auto slot_idx = static_cast<uint16_t>(word_idx * 64 + std::countr_zero(bits));
+          if constexpr (std::is_invocable_v<Func, Handle, T&>)
+            func(Handle{ block_idx, slot_idx, block.generations[slot_idx] }, *block.get(slot_idx));
+          else
+            func(*block.get(slot_idx));
+        }
+      }
+    }
+  }
+
+  /**
+   * destroy all live objects, all handles of them become invalid
+   * @param func invoked by (T&) before destruct every object
+   */
+  template <typename Func>
+  void destroy_all(Func&& func) noexcept
+  {
+    for (auto block_idx = uint16_t{}; block_idx < _blocks.size(); ++block_idx)
+    {
+      auto& block = *_blocks[block_idx];
+      for (auto word_idx = uint32_t{}; block.alive_count && word_idx < Block::Word_Count; ++word_idx)
+      {
+        for (auto bits = block.alive_bits[word_idx]; bits; bits &= bits - 1)
+        {
+          auto slot_idx = static_cast<uint16_t>(word_idx * 64 + std::countr_zero(bits));
+          func(*block.get(slot_idx));
+          block.get(slot_idx)->~T();
+          release_slot(block, block_idx, slot_idx);
+        }
+      }
+    }
+    assert(_size == 0);
+  }
+
+  void destroy_all() noexcept { destroy_all([](auto&) {}); }
+
+  auto size()  const noexcept { return _size; }
+  auto empty() const noexcept { return _size == 0; }
+
+  auto stats() const noexcept
   {
-    assert(block_idx < _blocks.size() && slot_idx < BlockCapacity);
-    return &(*_blocks[block_idx])[slot_idx];
+    auto stats = Stats{};
+    auto used  = static_cast<uint32_t>(_block_idx) * BlockCapacity + _slot_idx;
+    stats.alive         = _size;
+    stats.capacity      = static_cast<uint32_t>(_blocks.size()) * BlockCapacity;
+    stats.free_slots    = static_cast<uint32_t>(_free_list.size());
+    stats.occupancy     = static_cast<float>(stats.alive) / stats.capacity;
+    stats.fragmentation = used ? static_cast<float>(stats.free_slots) / used : 0.f;
+    return stats;
   }
 
 private:
-  struct Slot
+  struct Block
   {
-    alignas(T) std::byte obj[sizeof(T)];
-    uint32_t             generation{};
-    bool                 alive{};
+    static constexpr auto Word_Count = (BlockCapacity + 63) / 64;
+
+    alignas(T) std::byte                objs[BlockCapacity][sizeof(T)];
+    std::array<uint32_t, BlockCapacity> generations{};
+    std::array<uint64_t, Word_Count>    alive_bits{};
+    uint32_t                            alive_count{};
+
+    auto get(uint16_t slot_idx) noexcept -> T*
+    {
+      return std::launder(reinterpret_cast<T*>(objs[slot_idx]));
+    }
+
+    auto get(uint16_t slot_idx) const noexcept -> T const*
+    {
+      return std::launder(reinterpret_cast<T const*>(objs[slot_idx]));
+    }
 
-    auto get() noexcept -> T*
+    auto is_alive(uint16_t slot_idx) const noexcept
     {
-      return std::launder(reinterpret_cast<T*>(obj));
+      return (alive_bits[slot_idx / 64] >> (slot_idx % 64)) & 1;
     }
 
-    auto get() const noexcept -> T const*
+    void set_alive(uint16_t slot_idx) noexcept
     {
-      return std::launder(reinterpret_cast<T const*>(obj));
+      alive_bits[slot_idx / 64] |= uint64_t{ 1 } << (slot_idx % 64);
+      ++alive_count;
+    }
+
+    void set_dead(uint16_t slot_idx) noexcept
+    {
+      alive_bits[slot_idx / 64] &= ~(uint64_t{ 1 } << (slot_idx % 64));
+      --alive_count;
     }
   };
 
-  using Block = std::array<Slot, BlockCapacity>;
+  auto get_block(Handle handle) const noexcept -> Block&
+  {
+    assert(handle._block_idx < _blocks.size() && handle._slot_idx < BlockCapacity);
+    auto& block = *_blocks[handle._block_idx];
+    assert(handle.valid() && block.is_alive(handle._slot_idx) && block.generations[handle._slot_idx] == handle._generation);
+    return block;
+  }
+
+  void release_slot(Block& block, uint16_t block_idx, uint16_t slot_idx) noexcept
+  {
+    block.set_dead(slot_idx);
+    --_size;
+    auto& generation = block.generations[slot_idx];
+    ++generation;
+    err_if(generation == std::numeric_limits<uint32_t>::max(),
+      "[ObjectPool] Failed to destroy object, exceed the max slot generation");
+    _free_list.emplace_back(block_idx, slot_idx);
+  }
 
+private:
   struct FreeSlot
   {
     uint16_t block_idx{};
@@ -153,6 +255,7 @@ private:
   std::vector<FreeSlot>               _free_list;
   uint16_t                            _block_idx{};
   uint16_t                            _slot_idx{};
+  uint32_t                            _size{};
 };
 
 }
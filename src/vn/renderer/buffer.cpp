@@ -87,7 +87,7 @@ auto Buffer::append(void const* data, uint32_t size) noexcept -> uint32_t
   else
   {
     // add old buffer for destroy
-    Renderer::instance()->add_current_frame_render_finish_proc([_ = _handle] {});
+    Renderer::instance()->retire(_handle);
 
     // temporary copy old data
     auto old_data = std::vector<std::byte>(_size);
@@ -5,7 +5,9 @@
 #include <utf8.h>
 
 #include <vector>
+#include <array>
 #include <ranges>
+#include <future>
 
 using namespace vn;
 using namespace Microsoft::WRL;
@@ -13,24 +15,6 @@ using namespace Microsoft::WRL;
 namespace
 {
 
-auto read_file(std::string_view path) noexcept -> std::string
-{
-  FILE* file{};
-  fopen_s(&file, path.data(), "rb");
-  err_if(!file, "failed to open file {}", path);
-
-  fseek(file, 0, SEEK_END);
-  auto size = ftell(file);
-  rewind(file);
-
-  auto data = std::string{};
-  data.resize(size);
-  fread(data.data(), 1, size, file);
-  fclose(file);
-
-  return data;
-}
-
 #ifdef _WIN32
 auto to_wstring(std::string_view str) noexcept -> std::wstring
 {
@@ -39,6 +23,43 @@ auto to_wstring(std::string_view str) noexcept -> std::wstring
 }
 #endif
 
+auto compile_args(std::string_view include, std::span<std::string const> defines) noexcept -> std::vector<std::wstring>
+{
+  auto args = std::vector<std::wstring>
+  {
+#ifndef NDEBUG
+    L"-Zi",
+    L"-Qembed_debug",
+    L"-Od",
+#endif
+  };
+  if (!include.empty())
+    args.emplace_back(std::wstring(L"-I") + to_wstring(include));
+  for (auto const& define : defines)
+    args.emplace_back(std::wstring(L"-D") + to_wstring(define));
+  return args;
+}
+
+auto to_bytes(void const* data, size_t size) noexcept
+{
+  auto ptr = reinterpret_cast<uint8_t const*>(data);
+  return std::vector<uint8_t>(ptr, ptr + size);
+}
+
+auto serialize_root_signature(CD3DX12_VERSIONED_ROOT_SIGNATURE_DESC const& desc, D3D_ROOT_SIGNATURE_VERSION version) noexcept
+{
+  auto signature = ComPtr<ID3DBlob>{};
+  auto error     = ComPtr<ID3DBlob>{};
+  if (FAILED(D3DX12SerializeVersionedRootSignature(&desc, version, &signature, &error)))
+  {
+    auto msg = std::string{};
+    msg.resize(error->GetBufferSize());
+    memcpy(msg.data(), error->GetBufferPointer(), msg.size());
+    err_if(true, "failed to serialize root signature.\n{}", msg);
+  }
+  return to_bytes(signature->GetBufferPointer(), signature->GetBufferSize());
+}
+
 // Map a reflected vertex input parameter description to an appropriate DXGI_FORMAT.
 // Only 16-bit and 32-bit scalar component types are mappable for input layouts.
 // 64-bit component types (double / 64-bit ints) are not supported by the Input Assembler; we return DXGI_FORMAT_UNKNOWN.
@@ -108,41 +129,46 @@ namespace vn { namespace renderer {
 
 void Compiler::init() noexcept
 {
-  err_if(DxcCreateInstance(CLSID_DxcCompiler, IID_PPV_ARGS(&_compiler)),
-          "failed to create dxc compiler");
-  err_if(DxcCreateInstance(CLSID_DxcUtils, IID_PPV_ARGS(&_utils)),
-          "failed to create dxc utils");
-  err_if(_utils->CreateDefaultIncludeHandler(&_include_handler),
-          "failed to create default include handler in dxc");
+  // create instances of calling thread early, so missing dxc is reported at startup
+  dxc();
+}
+
+auto Compiler::dxc() noexcept -> Dxc&
+{
+  thread_local auto dxc = []
+  {
+    auto dxc = Dxc{};
+    err_if(DxcCreateInstance(CLSID_DxcCompiler, IID_PPV_ARGS(&dxc.compiler)),
+            "failed to create dxc compiler");
+    err_if(DxcCreateInstance(CLSID_DxcUtils, IID_PPV_ARGS(&dxc.utils)),
+            "failed to create dxc utils");
+    err_if(dxc.utils->CreateDefaultIncludeHandler(&dxc.include_handler),
+            "failed to create default include handler in dxc");
+    return dxc;
+  }();
+  return dxc;
 }
 
-auto Compiler::compile(std::string_view shader_path, std::string_view include, std::wstring_view profile, std::string_view entry_point) noexcept -> std::pair<Microsoft::WRL::ComPtr<IDxcResult>, Microsoft::WRL::ComPtr<IDxcBlob>>
+auto Compiler::compile(std::string_view shader_path, std::string_view source, std::vector<std::wstring> const& args, std::wstring_view profile, std::string_view entry_point) noexcept -> std::pair<Microsoft::WRL::ComPtr<IDxcResult>, Microsoft::WRL::ComPtr<IDxcBlob>>
 {
   auto buffer = DxcBuffer{};
-  auto data   = read_file(shader_path);
-  buffer.Ptr      = data.data();
-  buffer.Size     = data.size();
+  buffer.Ptr      = source.data();
+  buffer.Size     = source.size();
   buffer.Encoding = DXC_CP_UTF8;
 
-  auto include_str = std::wstring{};
-  if (!include.empty())
-    include_str = std::wstring(L"-I") + to_wstring(include);
-  auto args = std::vector<LPCWSTR>
-  {
-#ifndef NDEBUG
-    L"-Zi",
-    L"-Qembed_debug",
-    L"-Od",
-#endif
-    include_str.c_str()
-  };
+  auto arg_ptrs = std::vector<LPCWSTR>{};
+  arg_ptrs.reserve(args.size());
+  for (auto const& arg : args)
+    arg_ptrs.emplace_back(arg.c_str());
+
+  auto& [compiler, utils, include_handler] = dxc();
 
   auto dxc_args = ComPtr<IDxcCompilerArgs>{};
-  err_if(_utils->BuildArguments(nullptr, to_wstring(entry_point).data(), profile.data(), args.data(), args.size(), nullptr, 0, dxc_args.GetAddressOf()),
+  err_if(utils->BuildArguments(nullptr, to_wstring(entry_point).data(), profile.data(), arg_ptrs.data(), arg_ptrs.size(), nullptr, 0, dxc_args.GetAddressOf()),
           "failed to create dxc args");
 
   auto result = ComPtr<IDxcResult>{};
-  err_if(_compiler->Compile(&buffer, dxc_args->GetArguments(), dxc_args->GetCount(), _include_handler.Get(), IID_PPV_ARGS(&result)),
+  err_if(compiler->Compile(&buffer, dxc_args->GetArguments(), dxc_args->GetCount(), include_handler.Get(), IID_PPV_ARGS(&result)),
           "failed to compile {} of {}", entry_point, shader_path);
 
   auto hr = HRESULT{};
@@ -160,18 +186,34 @@ auto Compiler::compile(std::string_view shader_path, std::string_view include, s
   return { result, cso };
 }
 
-auto Compiler::compile(std::string_view shader, std::string_view vertex_shader_entry_point, std::string_view pixel_shader_entry_point, std::string_view include) noexcept -> CompileResult
+auto Compiler::compile(std::string_view shader, std::string_view vertex_shader_entry_point, std::string_view pixel_shader_entry_point, std::string_view include, std::span<std::string const> defines) noexcept -> CompileResult
 {
-  // compile shaders
-  auto [vs_res, vs_cso] = compile(shader, include, L"vs_6_0", vertex_shader_entry_point);
-  auto [ps_res, ps_cso] = compile(shader, include, L"ps_6_0", pixel_shader_entry_point);
+  auto cache   = ShaderCache::instance();
+  auto sources = cache->read_sources(shader, include);
+  err_if(sources.empty(), "failed to open file {}", shader);
+
+  auto args         = compile_args(include, defines);
+  auto arg_views    = std::vector<std::wstring_view>{ args.begin(), args.end() };
+  auto entry_points = std::array<std::string_view, 4>{ vertex_shader_entry_point, "vs_6_0", pixel_shader_entry_point, "ps_6_0" };
+  auto key          = shader_cache_key(sources, entry_points, arg_views);
 
-  // get reflection
   auto compile_result = CompileResult{};
-  compile_result._vs_cso = vs_cso;
-  compile_result._ps_cso = ps_cso;
-  compile_result.vs      = { vs_cso->GetBufferPointer(), vs_cso->GetBufferSize() };
-  compile_result.ps      = { ps_cso->GetBufferPointer(), ps_cso->GetBufferSize() };
+  if (auto entry = cache->load(key))
+  {
+    compile_result._cache_entry = std::move(*entry);
+    compile_result.from_cache   = true;
+    compile_result.finalize();
+    return compile_result;
+  }
+
+  // compile shaders, pixel shader is compiled in another thread at same time
+  auto ps_job = std::async(std::launch::async, [&] { return compile(shader, sources.front(), args, L"ps_6_0", pixel_shader_entry_point); });
+  auto [vs_res, vs_cso] = compile(shader, sources.front(), args, L"vs_6_0", vertex_shader_entry_point);
+  auto [ps_res, ps_cso] = ps_job.get();
+  compile_result._cache_entry.vs = to_bytes(vs_cso->GetBufferPointer(), vs_cso->GetBufferSize());
+  compile_result._cache_entry.ps = to_bytes(ps_cso->GetBufferPointer(), ps_cso->GetBufferSize());
+
+  // get reflection
   auto vs_reflection = compile_result.get_shader_reflection(vs_res.Get());
   auto ps_reflection = compile_result.get_shader_reflection(ps_res.Get());
 
@@ -195,49 +237,78 @@ auto Compiler::compile(std::string_view shader, std::string_view vertex_shader_e
     signature_desc.Init_1_1(compile_result._root_params.size(), compile_result._root_params.data(), 1, &sampler_desc, D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT);
   else
     signature_desc.Init_1_1(compile_result._root_params.size(), compile_result._root_params.data(), 0, nullptr, D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT);
+  compile_result._cache_entry.root_signature  = serialize_root_signature(signature_desc, D3D_ROOT_SIGNATURE_VERSION_1_1);
+  compile_result._cache_entry.resource_indexs = compile_result.resource_indexs;
 
-  auto signature = ComPtr<ID3DBlob>{};
-  auto error     = ComPtr<ID3DBlob>{};
-  if (FAILED(D3DX12SerializeVersionedRootSignature(&signature_desc, D3D_ROOT_SIGNATURE_VERSION_1_1, &signature, &error)))
-  {
-    auto msg = std::string{};
-    msg.resize(error->GetBufferSize());
-    memcpy(msg.data(), error->GetBufferPointer(), msg.size());
-    err_if(true, "failed to serialize root signature.\n{}", msg);
-  }
-  err_if(Core::instance()->device()->CreateRootSignature(0, signature->GetBufferPointer(), signature->GetBufferSize(), IID_PPV_ARGS(&compile_result.root_signature)),
-          "failed to create root signature");
-
+  cache->store(key, compile_result._cache_entry);
+  compile_result.finalize();
   return compile_result;
 }
 
 auto Compiler::compile(std::string_view shader, std::string_view compute_shader_entry_point, std::string_view include) noexcept -> CompileResult
 {
-  auto [res, cso] = compile(shader, include, L"cs_6_0", compute_shader_entry_point);
+  auto cache   = ShaderCache::instance();
+  auto sources = cache->read_sources(shader, include);
+  err_if(sources.empty(), "failed to open file {}", shader);
+
+  auto args         = compile_args(include, {});
+  auto arg_views    = std::vector<std::wstring_view>{ args.begin(), args.end() };
+  auto entry_points = std::array<std::string_view, 2>{ compute_shader_entry_point, "cs_6_0" };
+  auto key          = shader_cache_key(sources, entry_points, arg_views);
 
   auto compile_result = CompileResult{};
-  compile_result._cs_cso = cso;
-  compile_result.cs      = { cso->GetBufferPointer(), cso->GetBufferSize() };
+  if (auto entry = cache->load(key))
+  {
+    compile_result._cache_entry = std::move(*entry);
+    compile_result.from_cache   = true;
+    compile_result.finalize();
+    return compile_result;
+  }
+
+  auto [res, cso] = compile(shader, sources.front(), args, L"cs_6_0", compute_shader_entry_point);
+  compile_result._cache_entry.cs = to_bytes(cso->GetBufferPointer(), cso->GetBufferSize());
 
   auto reflection = compile_result.get_shader_reflection(res.Get());
   compile_result.get_root_parameters(reflection.Get());
 
   auto signature_desc = CD3DX12_VERSIONED_ROOT_SIGNATURE_DESC{};
   signature_desc.Init_1_1(compile_result._root_params.size(), compile_result._root_params.data(), 0, nullptr);
+  compile_result._cache_entry.root_signature  = serialize_root_signature(signature_desc, D3D_ROOT_SIGNATURE_VERSION_1);
+  compile_result._cache_entry.resource_indexs = compile_result.resource_indexs;
 
-  auto signature = ComPtr<ID3DBlob>{};
-  auto error     = ComPtr<ID3DBlob>{};
-  if (FAILED(D3DX12SerializeVersionedRootSignature(&signature_desc, D3D_ROOT_SIGNATURE_VERSION_1, &signature, &error)))
+  cache->store(key, compile_result._cache_entry);
+  compile_result.finalize();
+  return compile_result;
+}
+
+void Compiler::CompileResult::finalize() noexcept
+{
+  auto const& entry = _cache_entry;
+  vs = { entry.vs.data(), entry.vs.size() };
+  ps = { entry.ps.data(), entry.ps.size() };
+  cs = { entry.cs.data(), entry.cs.size() };
+
+  _input_element_descs.clear();
+  _input_element_descs.reserve(entry.input_elements.size());
+  for (auto const& element : entry.input_elements)
   {
-    auto msg = std::string{};
-    msg.resize(error->GetBufferSize());
-    memcpy(msg.data(), error->GetBufferPointer(), msg.size());
-    err_if(true, "failed to serialize root signature.\n{}", msg);
+    _input_element_descs.emplace_back(D3D12_INPUT_ELEMENT_DESC
+    {
+      .SemanticName         = element.semantic_name.c_str(),
+      .SemanticIndex        = element.semantic_index,
+      .Format               = static_cast<DXGI_FORMAT>(element.format),
+      .InputSlot            = 0u,
+      .AlignedByteOffset    = D3D12_APPEND_ALIGNED_ELEMENT,
+      .InputSlotClass       = D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA,
+      .InstanceDataStepRate = 0u,
+    });
   }
-  err_if(Core::instance()->device()->CreateRootSignature(0, signature->GetBufferPointer(), signature->GetBufferSize(), IID_PPV_ARGS(&compile_result.root_signature)),
-          "failed to create root signature");
+  input_layout_desc = D3D12_INPUT_LAYOUT_DESC{ _input_element_descs.data(), static_cast<uint32_t>(_input_element_descs.size()) };
 
-  return compile_result;
+  resource_indexs = entry.resource_indexs;
+
+  err_if(Core::instance()->device()->CreateRootSignature(0, entry.root_signature.data(), entry.root_signature.size(), IID_PPV_ARGS(&root_signature)),
+          "failed to create root signature");
 }
 
 auto Compiler::CompileResult::get_shader_reflection(IDxcResult* result) noexcept -> Microsoft::WRL::ComPtr<ID3D12ShaderReflection>
@@ -252,7 +323,7 @@ auto Compiler::CompileResult::get_shader_reflection(IDxcResult* result) noexcept
 
   // get shader reflection information
   auto shader_reflection = ComPtr<ID3D12ShaderReflection>{};
-  err_if(Compiler::instance()->_utils->CreateReflection(&buffer, IID_PPV_ARGS(&shader_reflection)), "failed to create shader reflection");
+  err_if(Compiler::dxc().utils->CreateReflection(&buffer, IID_PPV_ARGS(&shader_reflection)), "failed to create shader reflection");
 
   return shader_reflection;
 }
@@ -262,26 +333,13 @@ void Compiler::CompileResult::get_vertex_input_layout(ID3D12ShaderReflection* sh
   auto desc = D3D12_SHADER_DESC{};
   shader_reflection->GetDesc(&desc);
 
-  _input_element_descs.reserve(desc.InputParameters);
-  _input_param_names.reserve(desc.InputParameters);
+  _cache_entry.input_elements.reserve(desc.InputParameters);
   for (auto i : std::views::iota(0u, desc.InputParameters))
   {
     auto param_desc = D3D12_SIGNATURE_PARAMETER_DESC{};
     shader_reflection->GetInputParameterDesc(i, &param_desc);
-    _input_param_names.emplace_back(param_desc.SemanticName);
-    _input_element_descs.emplace_back(D3D12_INPUT_ELEMENT_DESC
-    {
-      .SemanticName         = _input_param_names.back().c_str(),
-      .SemanticIndex        = param_desc.SemanticIndex,
-      .Format               = to_dxgi_format(param_desc),
-      .InputSlot            = 0u,
-      .AlignedByteOffset    = D3D12_APPEND_ALIGNED_ELEMENT,
-      .InputSlotClass       = D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA,
-      .InstanceDataStepRate = 0u,
-    });
+    _cache_entry.input_elements.emplace_back(param_desc.SemanticName, param_desc.SemanticIndex, static_cast<uint32_t>(to_dxgi_format(param_desc)));
   }
-
-  input_layout_desc = D3D12_INPUT_LAYOUT_DESC{ _input_element_descs.data(), static_cast<uint32_t>(_input_element_descs.size()) };
 }
 
 void Compiler::CompileResult::get_root_parameters(ID3D12ShaderReflection* shader_reflection) noexcept
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../hash.hpp"
+#include "shader_cache.hpp"
 
 #include <directx/d3dx12.h>
 #include <dxcapi.h>
@@ -11,6 +12,7 @@
 #include <unordered_map>
 #include <unordered_set>
 #include <queue>
+#include <span>
 
 namespace vn { namespace renderer {
 
@@ -41,6 +43,7 @@ public:
     D3D12_INPUT_LAYOUT_DESC                     input_layout_desc;
     std::unordered_map<std::string, uint32_t>   resource_indexs;
     Microsoft::WRL::ComPtr<ID3D12RootSignature> root_signature;
+    bool                                        from_cache{};
 
   private:
     friend class Compiler;
@@ -50,13 +53,13 @@ public:
     void get_vertex_input_layout(ID3D12ShaderReflection* shader_reflection) noexcept;
 
     void get_root_parameters(ID3D12ShaderReflection* shader_reflection) noexcept;
+
+    /// fill public fields and create root signature from cache entry, shared by cold and warm compile
+    void finalize() noexcept;
  
   private:
-    Microsoft::WRL::ComPtr<IDxcBlob>      _vs_cso;
-    Microsoft::WRL::ComPtr<IDxcBlob>      _ps_cso;
-    Microsoft::WRL::ComPtr<IDxcBlob>      _cs_cso;
+    ShaderCacheEntry                      _cache_entry;
     std::vector<D3D12_INPUT_ELEMENT_DESC> _input_element_descs;
-    std::vector<std::string>              _input_param_names;
     std::vector<CD3DX12_ROOT_PARAMETER1>  _root_params;
     std::queue<CD3DX12_DESCRIPTOR_RANGE1> _ranges;
     bool                                  _has_sampler{};
@@ -84,16 +87,22 @@ public:
     std::unordered_set<ResourceKey, ResourceKeyHash> _resource_keys;
   };
 
-  auto compile(std::string_view shader, std::string_view vertex_shader_entry_point, std::string_view pixel_shader_entry_point, std::string_view include) noexcept -> CompileResult;
+  /// @param defines macro definitions like "NAME=VALUE", used to compile shader permutations
+  auto compile(std::string_view shader, std::string_view vertex_shader_entry_point, std::string_view pixel_shader_entry_point, std::string_view include, std::span<std::string const> defines = {}) noexcept -> CompileResult;
   auto compile(std::string_view shader, std::string_view compute_shader_entry_point, std::string_view include) noexcept -> CompileResult;
 
 private:
-  auto compile(std::string_view shader_path, std::string_view include, std::wstring_view profile, std::string_view entry_point) noexcept -> std::pair<Microsoft::WRL::ComPtr<IDxcResult>, Microsoft::WRL::ComPtr<IDxcBlob>>;
+  auto compile(std::string_view shader_path, std::string_view source, std::vector<std::wstring> const& args, std::wstring_view profile, std::string_view entry_point) noexcept -> std::pair<Microsoft::WRL::ComPtr<IDxcResult>, Microsoft::WRL::ComPtr<IDxcBlob>>;
 
-private:
-  Microsoft::WRL::ComPtr<IDxcCompiler3>      _compiler;
-  Microsoft::WRL::ComPtr<IDxcUtils>          _utils;
-  Microsoft::WRL::ComPtr<IDxcIncludeHandler> _include_handler;
+  struct Dxc
+  {
+    Microsoft::WRL::ComPtr<IDxcCompiler3>      compiler;
+    Microsoft::WRL::ComPtr<IDxcUtils>          utils;
+    Microsoft::WRL::ComPtr<IDxcIncludeHandler> include_handler;
+  };
+
+  /// dxc objects are not thread safe, so every compiling thread lazily creates its own instances
+  static auto dxc() noexcept -> Dxc&;
 };
 
 }}
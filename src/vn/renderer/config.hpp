@@ -7,9 +7,21 @@ constexpr auto Vertices_Indices_Buffer_Size = 1024;
 constexpr auto Shape_Properties_Buffer_Size = 1024;
 constexpr auto CBV_SRV_UAV_Heap_Size        = 256;
 constexpr auto RTV_Heap_Size                = 256;
-constexpr auto dSV_Heap_Size                = 32;
+constexpr auto DSV_Heap_Size                = 32;
 constexpr auto Window_Resize_Width          = 5;
 constexpr auto Window_Resize_Height         = 5;
 constexpr auto Window_Shadow_Thickness      = 20;
+constexpr auto Window_Shadow_Radius         = 16;
+constexpr auto Window_Shadow_Alpha          = 0.3f;
+constexpr auto Distance_Field_Atlas_Size    = 1024;
+constexpr auto Distance_Field_Tile_Size     = 64;
+constexpr auto Glyph_Atlas_Size             = 2048;
+constexpr auto Glyph_Cell_Size              = 48;
+constexpr auto Glyph_Em_Size                = 32; // pixels per em of glyphs in atlas, text of any size samples them
+constexpr auto Glyph_Distance_Range         = 8;  // pixels of distance encoded across outline of glyphs
+constexpr auto Layer_Granularity            = 64;
+constexpr auto Layer_Memory_Budget          = 32 * 1024 * 1024;
+constexpr auto Max_Layer_Count              = 32; // every layer takes a descriptor of heap
+constexpr auto Shader_Cache_Directory       = "shader_cache";
 
 }}
@@ -5,6 +5,7 @@
 #include <dxgi1_6.h>
 
 #include <stdint.h>
+#include <atomic>
 
 namespace vn { namespace renderer {
 
@@ -39,7 +40,7 @@ public:
   auto cmd()           const noexcept { return _cmd.Get();           }
   auto fence()         const noexcept { return _fence.Get();         }
   auto fence_event()   const noexcept { return _fence_event;         }
-	auto fence_value()   const noexcept { return _fence_value;         }
+	auto fence_value()   const noexcept { return _fence_value.load();  }
 
 private:
   Microsoft::WRL::ComPtr<IDXGIFactory6>              _factory;
@@ -49,7 +50,7 @@ private:
   Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList1> _cmd;
   Microsoft::WRL::ComPtr<ID3D12Fence>                _fence;
   HANDLE                                             _fence_event;
-  uint64_t                                           _fence_value{};
+  std::atomic<uint64_t>                              _fence_value{};
 };
 
 }}
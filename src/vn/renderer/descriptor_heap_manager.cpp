@@ -106,7 +106,7 @@ void DescriptorHeapManager::DescriptorHeap::reserve(uint32_t capacity) noexcept
   if (capacity > _handles.size())
   {
     // destroy old heap
-    Renderer::instance()->add_current_frame_render_finish_proc([_ = _heap] {});
+    Renderer::instance()->retire(_heap);
 
     // create new bigger one
     auto size = _handles.size();
@@ -129,7 +129,7 @@ void DescriptorHeapManager::init() noexcept
   _heaps[cbv_srv_uav].init(cbv_srv_uav, CBV_SRV_UAV_Heap_Size);
   _heaps[rtv].init(rtv, RTV_Heap_Size);
   if (Renderer::instance()->enable_depth_test)
-    _heaps[dsv].init(dsv, DSV_Size);
+    _heaps[dsv].init(dsv, DSV_Heap_Size);
 }
 
 void DescriptorHeapManager::bind_heaps(ID3D12GraphicsCommandList1* cmd) noexcept
@@ -0,0 +1,132 @@
+#include "distance_field_atlas.hpp"
+#include "core.hpp"
+#include "error_handling.hpp"
+#include "descriptor_heap_manager.hpp"
+
+#include <algorithm>
+#include <format>
+#include <ranges>
+#include <utility>
+
+namespace vn { namespace renderer {
+
+void DistanceFieldAtlas::init() noexcept
+{
+  auto device = Core::instance()->device();
+
+  // half float keeps fraction of pixel for distance inside stroke of thick shapes
+  target  = g_image_pool.alloc();
+  texture = g_image_pool.alloc();
+  g_image_pool[target].init(ImageType::rtv,  ImageFormat::r16_float, Distance_Field_Atlas_Size, Distance_Field_Atlas_Size);
+  g_image_pool[texture].init(ImageType::srv, ImageFormat::r16_float, Distance_Field_Atlas_Size, Distance_Field_Atlas_Size);
+
+  for (auto& frame_resource : frame_resources)
+  {
+    err_if(device->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&frame_resource.cmd_alloc)),
+            "failed to create command allocator");
+    frame_resource.buffer.init();
+  }
+  err_if(device->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT, frame_resources[0].cmd_alloc.Get(), nullptr, IID_PPV_ARGS(&cmd)),
+          "failed to create command list");
+  err_if(cmd->Close(), "failed to close command list");
+
+  pipeline.init_graphics("assets/shader.hlsl", "vs", "ps", "assets", ImageFormat::r16_float, false, false, false,
+    { std::format("PERMUTATION={}", std::to_underlying(PixelShaderPermutation::generic)), "DISTANCE_FIELD_BAKE" });
+}
+
+void DistanceFieldAtlas::destroy() noexcept
+{
+  // pipeline may still compiling if nothing is baked
+  pipeline.wait();
+  g_image_pool.free(target);
+  g_image_pool.free(texture);
+  std::ranges::for_each(frame_resources, [](auto& frame) { frame.buffer.destroy(); });
+}
+
+void DistanceFieldAtlas::bake(std::span<ui::DistanceFieldBake const> bakes) noexcept
+{
+  if (bakes.empty()) return;
+
+  auto  core           = Core::instance();
+  auto& frame_resource = frame_resources[frame_index];
+  auto& target_image   = g_image_pool[target];
+  auto& texture_image  = g_image_pool[texture];
+
+  // wait the bake used this frame resource
+  if (core->fence()->GetCompletedValue() < frame_resource.fence_value)
+  {
+    err_if(core->fence()->SetEventOnCompletion(frame_resource.fence_value, core->fence_event()), "failed to set event on completion");
+    WaitForSingleObjectEx(core->fence_event(), INFINITE, false);
+  }
+
+  // every bake is a quad covering its tile, and references its own operator chain
+  auto vertices         = std::vector<Vertex>{};
+  auto indices          = std::vector<uint16_t>{};
+  auto shape_properties = std::vector<ShapeProperty>{};
+  auto offset           = uint32_t{};
+  for (auto const& bake : bakes)
+  {
+    auto min = bake.origin;
+    auto max = bake.origin + glm::vec2{ bake.extent };
+    auto beg = static_cast<uint16_t>(vertices.size());
+    vertices.append_range(std::array<Vertex, 4>
+    {{
+      { { min.x, min.y, 0.f }, { 0.f, 0.f }, offset },
+      { { max.x, min.y, 0.f }, { 1.f, 0.f }, offset },
+      { { max.x, max.y, 0.f }, { 1.f, 1.f }, offset },
+      { { min.x, max.y, 0.f }, { 0.f, 1.f }, offset },
+    }});
+    indices.append_range(std::array<uint16_t, 6>
+    {
+      static_cast<uint16_t>(beg + 0),
+      static_cast<uint16_t>(beg + 1),
+      static_cast<uint16_t>(beg + 2),
+      static_cast<uint16_t>(beg + 0),
+      static_cast<uint16_t>(beg + 2),
+      static_cast<uint16_t>(beg + 3),
+    });
+    for (auto const& shape_property : bake.shape_properties)
+    {
+      shape_properties.emplace_back(shape_property);
+      offset += shape_property.byte_size();
+    }
+  }
+
+  err_if(frame_resource.cmd_alloc->Reset() == E_FAIL, "failed to reset command allocator");
+  err_if(cmd->Reset(frame_resource.cmd_alloc.Get(), nullptr), "failed to reset command list");
+  DescriptorHeapManager::instance()->bind_heaps(cmd.Get());
+  frame_resource.buffer.clear().upload(cmd.Get(), vertices, indices, shape_properties);
+
+  // every quad covers whole pixels of its tile, so tiles need no clearing
+  auto rtv_handle = target_image.cpu_handle();
+  target_image.set_state(cmd.Get(), ImageState::render_target);
+  cmd->OMSetRenderTargets(1, &rtv_handle, false, nullptr);
+  auto viewport = CD3DX12_VIEWPORT{ 0.f, 0.f, static_cast<float>(Distance_Field_Atlas_Size), static_cast<float>(Distance_Field_Atlas_Size) };
+  cmd->RSSetViewports(1, &viewport);
+
+  auto constants_binding = pipeline.root_constants<Constants>("constants");
+  pipeline.bind(cmd.Get());
+  pipeline.descriptor_table("images").set(cmd.Get(), g_descriptor_heap_mgr.first_gpu_handle(DescriptorHeapType::cbv_srv_uav));
+  pipeline.descriptor_table("buffer").set(cmd.Get(), frame_resource.buffer.gpu_handle());
+
+  // shapes are in window coordinates, moving window position maps origin to tile
+  auto constants = Constants{};
+  constants.window_extent = target_image.extent();
+  for (auto const& [i, bake] : bakes | std::views::enumerate)
+  {
+    auto rect = CD3DX12_RECT{ static_cast<LONG>(bake.tile.x), static_cast<LONG>(bake.tile.y), static_cast<LONG>(bake.tile.x + bake.extent.x), static_cast<LONG>(bake.tile.y + bake.extent.y) };
+    constants.window_pos = glm::vec2{ bake.tile } - bake.origin;
+    constants_binding.set(cmd.Get(), constants);
+    cmd->RSSetScissorRects(1, &rect);
+    cmd->DrawIndexedInstanced(6, 1, static_cast<uint32_t>(i * 6), 0, 0);
+  }
+
+  for (auto const& bake : bakes)
+    copy(cmd.Get(), target_image, bake.tile.x, bake.tile.y, bake.tile.x + bake.extent.x, bake.tile.y + bake.extent.y, texture_image, bake.tile.x, bake.tile.y);
+  texture_image.set_state(cmd.Get(), ImageState::pixel_shader_resource);
+
+  frame_resource.fence_value = core->submit(cmd.Get());
+  frame_index = (frame_index + 1) % Frame_Count;
+}
+
+}}
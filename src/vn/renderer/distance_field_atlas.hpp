@@ -0,0 +1,44 @@
+#pragma once
+
+#include "image.hpp"
+#include "buffer.hpp"
+#include "pipeline.hpp"
+#include "shader_type.hpp"
+#include "config.hpp"
+#include "../ui/distance_field_cache.hpp"
+
+#include <array>
+#include <span>
+
+namespace vn { namespace renderer {
+
+/**
+ * distance of paths and unions baked once and sampled by later frames, see ui::DistanceFieldCache for its tiles
+ * shapes are drawn by generic permutation which outputs distance rather than color into target,
+ * then baked tiles are copied to texture which pixel shader reads
+ * baking has its own command list submitted before windows of frame, so it is not skipped with unchanged windows
+ */
+struct DistanceFieldAtlas
+{
+  struct FrameResource
+  {
+    FrameBuffer                                    buffer;
+    Microsoft::WRL::ComPtr<ID3D12CommandAllocator> cmd_alloc;
+    uint64_t                                       fence_value{};
+  };
+
+  ImageHandle                                        target;
+  ImageHandle                                        texture;
+  uint32_t                                           frame_index{};
+  std::array<FrameResource, Frame_Count>             frame_resources;
+  Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList1> cmd;
+  Pipeline                                           pipeline;
+
+  void init()    noexcept;
+  void destroy() noexcept;
+
+  /// only call in render thread
+  void bake(std::span<ui::DistanceFieldBake const> bakes) noexcept;
+};
+
+}}
@@ -0,0 +1,92 @@
+#include "glyph_atlas.hpp"
+#include "core.hpp"
+#include "error_handling.hpp"
+#include "descriptor_heap_manager.hpp"
+#include "../util.hpp"
+
+#include <algorithm>
+#include <ranges>
+#include <vector>
+#include <cstring>
+
+namespace vn { namespace renderer {
+
+void GlyphAtlas::init() noexcept
+{
+  auto device = Core::instance()->device();
+
+  texture = g_image_pool.alloc();
+  g_image_pool[texture].init(ImageType::srv, ImageFormat::rgba8_unorm, Glyph_Atlas_Size, Glyph_Atlas_Size);
+
+  // a row of cells fits without growing
+  for (auto& frame_resource : frame_resources)
+  {
+    err_if(device->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&frame_resource.cmd_alloc)),
+            "failed to create command allocator");
+    frame_resource.buffer.init(Glyph_Atlas_Size * Glyph_Cell_Size * 4, false);
+  }
+  err_if(device->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT, frame_resources[0].cmd_alloc.Get(), nullptr, IID_PPV_ARGS(&cmd)),
+          "failed to create command list");
+  err_if(cmd->Close(), "failed to close command list");
+}
+
+void GlyphAtlas::destroy() noexcept
+{
+  g_image_pool.free(texture);
+  std::ranges::for_each(frame_resources, [](auto& frame) { frame.buffer.destroy(); });
+}
+
+void GlyphAtlas::upload(std::span<ui::GlyphUpload const> uploads) noexcept
+{
+  if (uploads.empty()) return;
+
+  auto  core           = Core::instance();
+  auto& frame_resource = frame_resources[frame_index];
+  auto& texture_image  = g_image_pool[texture];
+
+  // wait the copy used this frame resource
+  if (core->fence()->GetCompletedValue() < frame_resource.fence_value)
+  {
+    err_if(core->fence()->SetEventOnCompletion(frame_resource.fence_value, core->fence_event()), "failed to set event on completion");
+    WaitForSingleObjectEx(core->fence_event(), INFINITE, false);
+  }
+
+  // rows of every glyph are placed by alignments of texture copy
+  auto footprints = std::vector<D3D12_PLACED_SUBRESOURCE_FOOTPRINT>{};
+  auto size       = uint32_t{};
+  for (auto const& upload : uploads)
+  {
+    auto& footprint = footprints.emplace_back();
+    footprint.Offset             = size;
+    footprint.Footprint.Format   = dxgi_format(ImageFormat::rgba8_unorm);
+    footprint.Footprint.Width    = upload.extent.x;
+    footprint.Footprint.Height   = upload.extent.y;
+    footprint.Footprint.Depth    = 1;
+    footprint.Footprint.RowPitch = align(upload.extent.x * 4, D3D12_TEXTURE_DATA_PITCH_ALIGNMENT);
+    size = align(size + footprint.Footprint.RowPitch * upload.extent.y, D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT);
+  }
+
+  auto staging = std::vector<std::byte>(size);
+  for (auto const& [upload, footprint] : std::views::zip(uploads, footprints))
+    for (auto y = 0u; y < upload.extent.y; ++y)
+      memcpy(staging.data() + footprint.Offset + y * footprint.Footprint.RowPitch, upload.pixels.data() + y * upload.extent.x * 4, upload.extent.x * 4);
+  frame_resource.buffer.clear();
+  frame_resource.buffer.append(staging.data(), size);
+
+  err_if(frame_resource.cmd_alloc->Reset() == E_FAIL, "failed to reset command allocator");
+  err_if(cmd->Reset(frame_resource.cmd_alloc.Get(), nullptr), "failed to reset command list");
+
+  texture_image.set_state(cmd.Get(), ImageState::copy_dst);
+  auto dst_loc = CD3DX12_TEXTURE_COPY_LOCATION{ texture_image.handle() };
+  for (auto const& [upload, footprint] : std::views::zip(uploads, footprints))
+  {
+    auto src_loc = CD3DX12_TEXTURE_COPY_LOCATION{ frame_resource.buffer.handle(), footprint };
+    cmd->CopyTextureRegion(&dst_loc, upload.pos.x, upload.pos.y, 0, &src_loc, nullptr);
+  }
+  texture_image.set_state(cmd.Get(), ImageState::pixel_shader_resource);
+
+  frame_resource.fence_value = core->submit(cmd.Get());
+  frame_index = (frame_index + 1) % Frame_Count;
+}
+
+}}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "image.hpp"
+#include "buffer.hpp"
+#include "config.hpp"
+#include "../ui/glyph_cache.hpp"
+
+#include <array>
+#include <span>
+
+namespace vn { namespace renderer {
+
+/**
+ * msdf of glyphs sampled by text of every window, see ui::GlyphCache for its cells
+ * glyphs are rasterized by workers of cache, so this only copies their pixels into texture
+ * copying has its own command list submitted before windows of frame, so it is not skipped with unchanged windows
+ */
+struct GlyphAtlas
+{
+  struct FrameResource
+  {
+    Buffer                                         buffer;
+    Microsoft::WRL::ComPtr<ID3D12CommandAllocator> cmd_alloc;
+    uint64_t                                       fence_value{};
+  };
+
+  ImageHandle                                        texture;
+  uint32_t                                           frame_index{};
+  std::array<FrameResource, Frame_Count>             frame_resources;
+  Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList1> cmd;
+
+  void init()    noexcept;
+  void destroy() noexcept;
+
+  /// only call in render thread
+  void upload(std::span<ui::GlyphUpload const> uploads) noexcept;
+};
+
+}}
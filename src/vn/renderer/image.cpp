@@ -128,6 +128,7 @@ auto dxgi_format(ImageFormat format) noexcept -> DXGI_FORMAT
     { r8_unorm,    DXGI_FORMAT_R8_UNORM       },
     { bgra8_unorm, DXGI_FORMAT_B8G8R8A8_UNORM },
     { rgba8_unorm, DXGI_FORMAT_R8G8B8A8_UNORM },
+    { r16_float,   DXGI_FORMAT_R16_FLOAT      },
     { d32,         DXGI_FORMAT_D32_FLOAT      },
   };
   err_if(!map.contains(format), "unsupport image format now");
@@ -282,12 +283,12 @@ void Image::clear(ID3D12GraphicsCommandList1* cmd, D3D12_CPU_DESCRIPTOR_HANDLE c
   cmd->ClearUnorderedAccessViewFloat(gpu_handle, cpu_handle, _handle.Get(), values, 1, &rect);
 }
 
-void Image::clear_render_target(ID3D12GraphicsCommandList1* cmd) noexcept
+void Image::clear_render_target(ID3D12GraphicsCommandList1* cmd, std::span<RECT const> rects) noexcept
 {
   err_if(_type != ImageType::rtv, "clear render target only use on rtv");
   set_state(cmd, ImageState::render_target);
   float constexpr clear_color[4]{};
-  cmd->ClearRenderTargetView(cpu_handle(), clear_color, 0, nullptr);
+  cmd->ClearRenderTargetView(cpu_handle(), clear_color, rects.size(), rects.empty() ? nullptr : rects.data());
 }
 
 auto Image::per_pixel_size() const noexcept -> uint32_t
@@ -437,31 +438,69 @@ void UploadBuffer::upload(ID3D12GraphicsCommandList1* cmd) noexcept
 
 void ExternalImageLoader::load(std::string_view filename) noexcept
 {
-  err_if(_datas.contains(filename.data()), "Failed to load {}. It's already loaded", filename);
-  _datas[filename.data()].init(filename);
+  // decode image out of lock, avoid blocking render thread
+  auto data = Data{};
+  data.init(filename);
+
+  {
+    auto lock = std::lock_guard{ _mutex };
+    err_if(_datas.contains(filename.data()), "Failed to load {}. It's already loaded", filename);
+    _datas.emplace(filename, data);
+  }
+  g_renderer.wake_up();
 }
 
 void ExternalImageLoader::remove(std::string_view filename) noexcept
 {
+  auto lock = std::lock_guard{ _mutex };
   err_if(!_datas.contains(filename.data()), "Failed to remove {}. It's not exist", filename);
   auto& data = _datas[filename.data()];
-  if (data.state == State::unuploaded) data.bitmap.destroy();
-  g_renderer.add_current_frame_render_finish_proc([handle = data.handle] mutable { g_image_pool.free(handle); });
+  if (data.state == State::unuploaded)
+    data.bitmap.destroy();
+  else
+    _removed_handles.emplace_back(data.handle);
   _datas.erase(filename.data());
 }
 
+void ExternalImageLoader::release_removed_images() noexcept
+{
+  auto lock = std::lock_guard{ _mutex };
+  std::ranges::for_each(_removed_handles, [](auto handle)
+  {
+    g_renderer.retire(handle);
+  });
+  _removed_handles.clear();
+}
+
 void ExternalImageLoader::Data::init(std::string_view filename) noexcept
 {
   bitmap.init(filename);
-  handle = g_image_pool.alloc();
-  g_image_pool[handle].init(ImageType::srv, ImageFormat::rgba8_unorm, bitmap.width(), bitmap.height());
+
+  // opaque image hides shapes under it, recorder culls them
+  auto pixels = std::span{ static_cast<uint8_t const*>(bitmap.data()), bitmap.size() };
+  info.opaque = std::ranges::all_of(pixels | std::views::drop(3) | std::views::stride(4), [](auto alpha) { return alpha == 0xff; });
 }
 
 void ExternalImageLoader::upload(ID3D12GraphicsCommandList1* cmd) noexcept
 {
+  auto lock = std::lock_guard{ _mutex };
+
   auto unuploaded_datas = _datas
     | std::views::values
     | std::views::filter([](auto const& data) { return data.state == State::unuploaded; });
+
+  // image pool is only used in render thread, so create gpu images at here
+  std::ranges::for_each(unuploaded_datas, [this](auto& data)
+  {
+    data.handle = g_image_pool.alloc();
+    auto& image = g_image_pool[data.handle];
+    image.init(ImageType::srv, ImageFormat::rgba8_unorm, data.bitmap.width(), data.bitmap.height());
+    data.info.index      = image.index();
+    data.info.width      = image.width();
+    data.info.height     = image.height();
+    data.info.generation = ++_generation;
+  });
+
   auto handles = unuploaded_datas
     | std::views::transform([](auto const& data) { return data.handle; })
     | std::ranges::to<std::vector<ImageHandle>>();
@@ -472,50 +511,56 @@ void ExternalImageLoader::upload(ID3D12GraphicsCommandList1* cmd) noexcept
   _upload_buffer.add_images(handles, views);
   _upload_buffer.upload(cmd);
   
-  auto unuploaded_data_filenames = _datas
-    | std::views::filter([](auto const& pair) { return pair.second.state == State::unuploaded; })
-    | std::views::keys
-    | std::ranges::to<std::vector<std::string>>();
-  g_renderer.add_current_frame_render_finish_proc([unuploaded_data_filenames]
-  {
-    std::ranges::for_each(unuploaded_data_filenames, [](auto& filename)
-    {
-      g_external_image_loader.upload_finish(filename);
-    });
-  });
-
-  std::ranges::for_each(unuploaded_datas, [](auto& data)
+  // upload commands are submitted right after recording, so they finish with next fence value
+  std::ranges::for_each(unuploaded_datas, [upload_fence_value = Core::instance()->fence_value() + 1](auto& data)
   {
     data.bitmap.destroy();
-    data.state = State::uploading;
+    data.state              = State::uploading;
+    data.upload_fence_value = upload_fence_value;
   });
 }
 
 void ExternalImageLoader::destroy() noexcept
 {
+  auto lock = std::lock_guard{ _mutex };
   std::ranges::for_each(_datas | std::views::values, [](auto& data)
   {
-    if (data.state == State::unuploaded) data.bitmap.destroy();
-    g_image_pool.free(data.handle);
+    if (data.state == State::unuploaded)
+      data.bitmap.destroy();
+    else
+      g_image_pool.free(data.handle);
   });
+  std::ranges::for_each(_removed_handles, [](auto& handle) { g_image_pool.free(handle); });
   _datas.clear();
+  _removed_handles.clear();
 }
 
-auto ExternalImageLoader::operator[](std::string_view filename) noexcept -> Image&
+auto ExternalImageLoader::get(std::string_view filename) noexcept -> std::optional<ImageInfo>
 {
-  err_if(!_datas.contains(filename.data()), "Failed to remove {}. It's not exist", filename);
-	_datas[filename.data()].last_fence_value = Core::instance()->fence_value();
-  return g_image_pool[_datas[filename.data()].handle];
+  auto lock = std::lock_guard{ _mutex };
+  err_if(!_datas.contains(filename.data()), "Failed to get {}. It's not exist", filename);
+  auto& data = _datas[filename.data()];
+  if (data.state != State::uploaded) return {};
+  data.last_fence_value = Core::instance()->fence_value();
+  return data.info;
 }
 
-void ExternalImageLoader::upload_finish(std::string_view filename) noexcept
+void ExternalImageLoader::upload_finish(uint64_t completed_fence_value) noexcept
 {
-  err_if(!_datas.contains(filename.data()), "Failed to remove {}. It's not exist", filename);
-  _datas[filename.data()].state = State::uploaded;
+  auto lock = std::lock_guard{ _mutex };
+  std::ranges::for_each(_datas | std::views::values, [&](auto& data)
+  {
+    if (data.state == State::uploading && data.upload_fence_value <= completed_fence_value)
+    {
+      data.state = State::uploaded;
+      ++_uploaded_count;
+    }
+  });
 }
 
 auto ExternalImageLoader::is_uploaded(std::string_view filename) const noexcept -> bool
 {
+  auto lock = std::lock_guard{ _mutex };
   err_if(!_datas.contains(filename.data()), "Failed to remove {}. It's not exist", filename);
   return _datas.at(filename.data()).state == State::uploaded;
 }
@@ -11,6 +11,9 @@
 
 #include <algorithm>
 #include <ranges>
+#include <mutex>
+#include <optional>
+#include <span>
 
 namespace vn { namespace renderer {
 
@@ -31,6 +34,7 @@ enum class ImageFormat
   r8_unorm,
   bgra8_unorm,
   rgba8_unorm,
+  r16_float,
   d32,
 };
 
@@ -144,7 +148,8 @@ public:
   void resize(IDXGISwapChain1* swapchain, uint32_t index) noexcept { init(swapchain, index);              }
 
   void clear(ID3D12GraphicsCommandList1* cmd, D3D12_CPU_DESCRIPTOR_HANDLE cpu_handle, D3D12_GPU_DESCRIPTOR_HANDLE gpu_handle) const noexcept;
-  void clear_render_target(ID3D12GraphicsCommandList1* cmd) noexcept;
+  /// @param rects cleared rects, empty clears whole image
+  void clear_render_target(ID3D12GraphicsCommandList1* cmd, std::span<RECT const> rects = {}) noexcept;
 
   auto handle() const noexcept { return _handle.Get();                            }
   auto format() const noexcept { return _format;                                  }
@@ -250,6 +255,24 @@ public:
     _image_pool.destroy(handle);
   }
 
+  /**
+   * visit resident images in time proportional to the live count
+   * @param func invoked by (ImageHandle, Image&) or (Image&)
+   */
+  template <typename Func>
+  void for_each(Func&& func) noexcept { _image_pool.for_each(std::forward<Func>(func)); }
+
+  auto size()  const noexcept { return _image_pool.size();  }
+  auto stats() const noexcept { return _image_pool.stats(); }
+
+  /// release all resident images, only use on shutdown
+  void destroy() noexcept
+  {
+    if (!_image_pool.empty())
+      warn("[ImagePool] {} images are still resident on destroy", _image_pool.size());
+    _image_pool.destroy_all([](auto& image) { image.destroy(); });
+  }
+
 private:
   ImagePoolType _image_pool;
 };
@@ -298,24 +321,50 @@ public:
     return &instance;
   }
 
+  struct ImageInfo
+  {
+    uint32_t index{};
+    uint32_t width{};
+    uint32_t height{};
+    bool     opaque{};     // every pixel has full alpha
+    uint32_t generation{}; // unique to every upload, descriptor index of removed image is reused by later ones
+  };
+
+  // main thread: load, remove, contains, is_uploaded, get
+  // render thread: upload, release_removed_images, upload_finish
   void load(std::string_view filename) noexcept;
   void remove(std::string_view filename) noexcept;
   void upload(ID3D12GraphicsCommandList1* cmd) noexcept;
+  void release_removed_images() noexcept;
   void destroy() noexcept;
 
-  auto operator[](std::string_view filename) noexcept -> Image&;
+  /// return empty if image is not uploaded
+  auto get(std::string_view filename) noexcept -> std::optional<ImageInfo>;
 
-  auto contains(std::string_view filename) const noexcept { return _datas.contains(filename.data()); }
+  auto contains(std::string_view filename) const noexcept
+  {
+    auto lock = std::lock_guard{ _mutex };
+    return _datas.contains(filename.data());
+  }
 
   auto have_unuploaded_images() const noexcept
   {
+    auto lock = std::lock_guard{ _mutex };
     return std::ranges::any_of(_datas | std::views::values, [](auto const& data) { return data.state == State::unuploaded; });
   }
 
-  void upload_finish(std::string_view filename) noexcept;
+  /// mark images uploaded if their upload commands are completed
+  void upload_finish(uint64_t completed_fence_value) noexcept;
 
   auto is_uploaded(std::string_view filename) const noexcept -> bool;
 
+  /// increases whenever images become uploaded, content drawn while images missing is stale until it changes
+  auto uploaded_count() const noexcept
+  {
+    auto lock = std::lock_guard{ _mutex };
+    return _uploaded_count;
+  }
+
 private:
   enum class State
   {
@@ -329,11 +378,17 @@ private:
     Bitmap      bitmap;
     State       state;
     size_t      last_fence_value{};
+    uint64_t    upload_fence_value{};
+    ImageInfo   info;
 
     void init(std::string_view filename) noexcept;
   };
+  mutable std::mutex                    _mutex;
   std::unordered_map<std::string, Data> _datas;
+  std::vector<ImageHandle>              _removed_handles;
   UploadBuffer                          _upload_buffer;
+  uint32_t                              _generation{};
+  uint32_t                              _uploaded_count{};
 };
 
 inline static auto& g_external_image_loader{ *ExternalImageLoader::instance() };
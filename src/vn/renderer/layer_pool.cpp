@@ -0,0 +1,210 @@
+#include "layer_pool.hpp"
+#include "core.hpp"
+#include "error_handling.hpp"
+#include "descriptor_heap_manager.hpp"
+#include "renderer.hpp"
+
+#include <algorithm>
+#include <ranges>
+#include <utility>
+
+namespace vn { namespace renderer {
+
+void LayerPool::init() noexcept
+{
+  auto device = Core::instance()->device();
+  for (auto& frame_resource : frame_resources)
+  {
+    err_if(device->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&frame_resource.cmd_alloc)),
+            "failed to create command allocator");
+    frame_resource.buffer.init();
+  }
+  err_if(device->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT, frame_resources[0].cmd_alloc.Get(), nullptr, IID_PPV_ARGS(&cmd)),
+          "failed to create command list");
+  err_if(cmd->Close(), "failed to close command list");
+}
+
+void LayerPool::destroy() noexcept
+{
+  auto free = [](Layer const& layer)
+  {
+    g_image_pool.free(layer.target);
+    g_image_pool.free(layer.texture);
+  };
+  std::ranges::for_each(layers | std::views::values, free);
+  std::ranges::for_each(free_layers, free);
+  if (depth.valid()) g_image_pool.free(depth);
+  std::ranges::for_each(frame_resources, [](auto& frame) { frame.buffer.destroy(); });
+}
+
+void LayerPool::release(std::span<size_t const> ids) noexcept
+{
+  // queue executes draws of composites before later renders reuse the images, so no waiting
+  for (auto id : ids)
+  {
+    if (auto it = layers.find(id); it != layers.end())
+    {
+      free_layers.emplace_back(it->second);
+      layers.erase(it);
+    }
+  }
+}
+
+auto LayerPool::index(size_t id) const noexcept -> uint32_t
+{
+  err_if(!layers.contains(id), "composite of layer which has no image");
+  return g_image_pool[layers.at(id).texture].index();
+}
+
+void LayerPool::reserve(size_t id, glm::vec<2, uint32_t> extent) noexcept
+{
+  auto image_extent = ui::layer_image_extent(extent);
+  if (auto it = layers.find(id); it != layers.end())
+  {
+    if (g_image_pool[it->second.target].extent() == image_extent) return;
+    free_layers.emplace_back(it->second);
+    layers.erase(it);
+  }
+
+  if (auto it = std::ranges::find_if(free_layers, [&](auto const& layer) { return g_image_pool[layer.target].extent() == image_extent; });
+      it != free_layers.end())
+  {
+    layers[id] = *it;
+    free_layers.erase(it);
+  }
+  else
+  {
+    auto& layer = layers[id];
+    layer.target  = g_image_pool.alloc();
+    layer.texture = g_image_pool.alloc();
+    g_image_pool[layer.target].init(ImageType::rtv,  SwapchainResource::Image_Format, image_extent.x, image_extent.y);
+    g_image_pool[layer.texture].init(ImageType::srv, SwapchainResource::Image_Format, image_extent.x, image_extent.y);
+  }
+
+  // depth grows to the largest layer and never shrinks
+  if (Renderer::instance()->enable_depth_test)
+  {
+    if (depth.valid())
+    {
+      auto depth_extent = g_image_pool[depth].extent();
+      if (depth_extent.x >= image_extent.x && depth_extent.y >= image_extent.y) return;
+      image_extent = glm::max(image_extent, depth_extent);
+      Renderer::instance()->retire(std::exchange(depth, {}));
+    }
+    depth = g_image_pool.alloc();
+    g_image_pool[depth].init(ImageType::dsv, ImageFormat::d32, image_extent.x, image_extent.y);
+  }
+}
+
+void LayerPool::trim() noexcept
+{
+  auto byte_size = [](Layer const& layer) { return ui::layer_byte_size(g_image_pool[layer.target].extent()); };
+  auto total     = uint64_t{};
+  for (auto const& layer : layers | std::views::values) total += byte_size(layer);
+  for (auto const& layer : free_layers)                  total += byte_size(layer);
+
+  // oldest pooled images go first, images of live layers are bounded by layer cache
+  auto count = 0u;
+  while (total > Layer_Memory_Budget && count < free_layers.size())
+    total -= byte_size(free_layers[count++]);
+  auto renderer = Renderer::instance();
+  for (auto const& layer : free_layers | std::views::take(count))
+  {
+    renderer->retire(layer.target);
+    renderer->retire(layer.texture);
+  }
+  free_layers.erase(free_layers.begin(), free_layers.begin() + count);
+}
+
+void LayerPool::render(std::span<ui::LayerRender const> renders) noexcept
+{
+  if (renders.empty())
+  {
+    trim();
+    return;
+  }
+
+  auto  core           = Core::instance();
+  auto  renderer       = Renderer::instance();
+  auto& frame_resource = frame_resources[frame_index];
+
+  // wait the render used this frame resource
+  if (core->fence()->GetCompletedValue() < frame_resource.fence_value)
+  {
+    err_if(core->fence()->SetEventOnCompletion(frame_resource.fence_value, core->fence_event()), "failed to set event on completion");
+    WaitForSingleObjectEx(core->fence_event(), INFINITE, false);
+  }
+
+  for (auto const& render : renders)
+    reserve(render.id, render.extent);
+  trim();
+
+  // layers share one upload, every layer draws with base of its vertices and indices
+  // vertices reference shape properties by byte offset, so they are moved by bytes of layers before
+  auto vertices         = std::vector<Vertex>{};
+  auto indices          = std::vector<uint16_t>{};
+  auto shape_properties = std::vector<ShapeProperty>{};
+  auto offset           = uint32_t{};
+  for (auto const& render : renders)
+  {
+    auto const& content = render.content;
+    auto        beg     = vertices.size();
+    vertices.append_range(content.vertices);
+    for (auto& vertex : vertices | std::views::drop(beg)) vertex.buffer_offset += offset;
+    indices.append_range(content.indices);
+    for (auto const& shape_property : content.shape_properties)
+    {
+      shape_properties.emplace_back(shape_property);
+      offset += shape_property.byte_size();
+    }
+  }
+
+  err_if(frame_resource.cmd_alloc->Reset() == E_FAIL, "failed to reset command allocator");
+  err_if(cmd->Reset(frame_resource.cmd_alloc.Get(), nullptr), "failed to reset command list");
+  DescriptorHeapManager::instance()->bind_heaps(cmd.Get());
+  frame_resource.buffer.clear().upload(cmd.Get(), vertices, indices, shape_properties);
+
+  // shapes are in window coordinates, moving window position maps origin of layer to left top of target
+  auto constants = Constants{};
+  constants.distance_field_atlas_index = g_image_pool[renderer->_distance_field_atlas.texture].index();
+  constants.glyph_atlas_index          = g_image_pool[renderer->_glyph_atlas.texture].index();
+  auto vertex_base = int32_t{};
+  auto index_base  = uint32_t{};
+  for (auto const& render : renders)
+  {
+    auto const& layer   = layers.at(render.id);
+    auto&       target  = g_image_pool[layer.target];
+    auto&       texture = g_image_pool[layer.texture];
+
+    auto rtv_handle = target.cpu_handle();
+    if (Renderer::instance()->enable_depth_test)
+    {
+      auto dsv_handle = g_image_pool[depth].cpu_handle();
+      cmd->OMSetRenderTargets(1, &rtv_handle, false, &dsv_handle);
+      cmd->ClearDepthStencilView(dsv_handle, D3D12_CLEAR_FLAG_DEPTH, 1.f, 0, 0, nullptr);
+    }
+    else
+      cmd->OMSetRenderTargets(1, &rtv_handle, false, nullptr);
+    target.clear_render_target(cmd.Get());
+
+    auto viewport = CD3DX12_VIEWPORT{ 0.f, 0.f, static_cast<float>(target.width()), static_cast<float>(target.height()) };
+    auto rect     = CD3DX12_RECT{ 0, 0, static_cast<LONG>(render.extent.x), static_cast<LONG>(render.extent.y) };
+    cmd->RSSetViewports(1, &viewport);
+    cmd->RSSetScissorRects(1, &rect);
+
+    constants.window_extent = target.extent();
+    constants.window_pos    = -render.origin;
+    renderer->draw_batches(cmd.Get(), frame_resource.buffer.gpu_handle(), render.content.batches, constants, index_base, vertex_base);
+
+    copy(cmd.Get(), target, 0, 0, render.extent.x, render.extent.y, texture);
+    texture.set_state(cmd.Get(), ImageState::pixel_shader_resource);
+
+    vertex_base += static_cast<int32_t>(render.content.vertices.size());
+    index_base  += static_cast<uint32_t>(render.content.indices.size());
+  }
+
+  frame_resource.fence_value = core->submit(cmd.Get());
+  frame_index = (frame_index + 1) % Frame_Count;
+}
+
+}}
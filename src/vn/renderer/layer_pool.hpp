@@ -0,0 +1,60 @@
+#pragma once
+
+#include "image.hpp"
+#include "buffer.hpp"
+#include "config.hpp"
+#include "../ui/layer_cache.hpp"
+
+#include <array>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace vn { namespace renderer {
+
+/**
+ * images of layers, see ui::LayerCache for which layers are kept
+ * layer content is rendered into target then copied to texture which composite quad reads
+ * released images are pooled and reused by layers of same image extent, pool is trimmed to memory budget
+ * rendering has its own command list submitted before windows of frame, so it is not skipped with unchanged windows
+ */
+struct LayerPool
+{
+  struct FrameResource
+  {
+    FrameBuffer                                    buffer;
+    Microsoft::WRL::ComPtr<ID3D12CommandAllocator> cmd_alloc;
+    uint64_t                                       fence_value{};
+  };
+
+  struct Layer
+  {
+    ImageHandle target;
+    ImageHandle texture;
+  };
+
+  std::unordered_map<size_t, Layer>                  layers;
+  std::vector<Layer>                                 free_layers; // oldest first
+  ImageHandle                                        depth;       // only when depth test is enabled, shared by layers
+  uint32_t                                           frame_index{};
+  std::array<FrameResource, Frame_Count>             frame_resources;
+  Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList1> cmd;
+
+  void init()    noexcept;
+  void destroy() noexcept;
+
+  /// images of released layers return to pool, only call in render thread
+  void release(std::span<size_t const> ids) noexcept;
+
+  /// render content of layers into their images, only call in render thread
+  void render(std::span<ui::LayerRender const> renders) noexcept;
+
+  /// descriptor index of layer texture
+  auto index(size_t id) const noexcept -> uint32_t;
+
+private:
+  void reserve(size_t id, glm::vec<2, uint32_t> extent) noexcept;
+  void trim() noexcept;
+};
+
+}}
@@ -3,44 +3,67 @@
 
 namespace vn { namespace renderer {
 
+void MessageQueue::send_message(Message const& msg) noexcept
+{
+  _message_queue.push(msg);
+  Renderer::instance()->wake_up();
+}
+
 void MessageQueue::process_messages() noexcept
 {
   static auto  renderer = Renderer::instance();
   static auto& wr       = renderer->_window_resources;
 
-  while (!_message_queue.empty())
+  auto msg = Message{};
+  while (_message_queue.try_pop(msg))
   {
-    auto& msg = _message_queue.front();
-
     std::visit([&](auto&& data)
     {
       using T = std::decay_t<decltype(data)>;
       if constexpr (std::is_same_v<T, Message_Create_Window_Render_Resource>)
       {
-        wr[data.window.handle].init(data.window, data.transparent);
+        auto window = Window{};
+        window.init(data.handle, "", data.x, data.y, data.width, data.height);
+        window.id = data.id;
+        wr.emplace(data.id).init(window, data.transparent);
       }
       else if constexpr (std::is_same_v<T, Message_Create_Fullscreen_Render_Resource>)
       {
-        renderer->_fullscreen_resource.init(data.window, true);
+        auto window = Window{};
+        window.init(data.handle, "", 0, 0, data.width, data.height);
+        renderer->_fullscreen_resource.init(window, true);
       }
       else if constexpr (std::is_same_v<T, Message_Destroy_Window_Render_Resource>)
       {
-        renderer->add_current_frame_render_finish_proc([old_window_resource = wr[data.handle]] mutable
-        {
-          old_window_resource.destroy();
-          DestroyWindow(old_window_resource.window.handle);
-        });
-        wr.erase(data.handle);
+        // window is destroyed after its resources are released
+        renderer->retire(wr.at(data.id));
+        wr.erase(data.id);
       }
       else if constexpr (std::is_same_v<T, Message_Update_Window>)
       {
-        std::swap(wr[data.window.handle].window, data.window);
+        if (!wr.contains(data.id)) return;
+        auto& window = wr[data.id].window;
+        window.x           = data.x;
+        window.y           = data.y;
+        window.width       = data.width;
+        window.height      = data.height;
+        window.cursor_type = data.cursor_type;
+        window.moving      = data.moving;
+        window.resizing    = data.resizing;
+        window.update_rect();
+      }
+      else if constexpr (std::is_same_v<T, Message_Resize_Window>)
+      {
+        if (!wr.contains(data.id)) return;
+        wr[data.id].resize(data.width, data.height);
+      }
+      else if constexpr (std::is_same_v<T, Message_Render_Frame>)
+      {
+        renderer->render_frame(data.frame_index);
       }
       else
         static_assert(false, "unexist message type of renderer");
     }, msg);
-
-    _message_queue.pop();
   }
 }
 
@@ -1,12 +1,16 @@
 #pragma once
 
 #include "window.hpp"
+#include "../mpsc_queue.hpp"
 
-#include <queue>
 #include <variant>
 
 namespace vn { namespace renderer {
 
+/**
+ * messages from main thread to render thread
+ * only carry compact deltas which render side need, so every message is trivially copyable
+ */
 class MessageQueue
 {
 private:
@@ -26,37 +30,75 @@ public:
 
   struct Message_Create_Fullscreen_Render_Resource
   {
-    Window window;
+    HWND     handle;
+    uint32_t width;
+    uint32_t height;
   };
 
   struct Message_Create_Window_Render_Resource
   {
-    Window window;
-    bool   transparent;
+    WindowId id;
+    HWND     handle;
+    int      x;
+    int      y;
+    uint32_t width;
+    uint32_t height;
+    bool     transparent;
   };
 
   struct Message_Destroy_Window_Render_Resource
   {
-    HWND handle;
+    WindowId id;
   };
 
   struct Message_Update_Window
   {
-    Window window;
+    WindowId   id;
+    int        x;
+    int        y;
+    uint32_t   width;
+    uint32_t   height;
+    CursorType cursor_type;
+    bool       moving;
+    bool       resizing;
+
+    static auto from(Window const& window) noexcept
+    {
+      return Message_Update_Window{ window.id, window.x, window.y, window.width, window.height, window.cursor_type, window.moving, window.resizing };
+    }
+  };
+
+  struct Message_Resize_Window
+  {
+    WindowId id;
+    uint32_t width;
+    uint32_t height;
+  };
+
+  // frame is recorded finish, it's ordered with other messages so window states always match the frame
+  struct Message_Render_Frame
+  {
+    uint32_t frame_index;
   };
 
   using Message = std::variant<
     Message_Create_Window_Render_Resource,
     Message_Create_Fullscreen_Render_Resource,
     Message_Destroy_Window_Render_Resource,
-    Message_Update_Window
+    Message_Update_Window,
+    Message_Resize_Window,
+    Message_Render_Frame
   >;
 
-  void send_message(Message const& msg) noexcept { _message_queue.push(msg); }
+  void send_message(Message const& msg) noexcept;
+
+  /// only call in render thread
   void process_messages() noexcept;
 
 private:
-  std::queue<Message> _message_queue;
+  static constexpr auto Capacity = 1024;
+
+  MPSCQueue<Message, Capacity> _message_queue;
 };
 
 }}
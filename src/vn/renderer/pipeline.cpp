@@ -5,27 +5,66 @@
 
 #include <directx/d3dx12.h>
 
+#include <chrono>
+
 using namespace Microsoft::WRL;
 using namespace vn;
 using namespace vn::renderer;
 
 namespace vn { namespace renderer {
 
+template <typename Func>
+void Pipeline::create_async(std::string name, Func&& func) noexcept
+{
+  err_if(_compiling.valid(), "failed to init pipeline {}, it's already initializing", name);
+  _compiling = std::async(std::launch::async, [name = std::move(name), func = std::forward<Func>(func)]
+  {
+    auto beg        = std::chrono::steady_clock::now();
+    auto from_cache = func();
+    auto duration   = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - beg);
+    info("[Pipeline] {} is ready in {:.2f} ms{}", name, duration.count(), from_cache ? " from shader cache" : "");
+  });
+}
+
 void Pipeline::init_graphics(
-    std::string shader,
-    std::string vs,
-    std::string ps,
-    std::string include,
-    ImageFormat rtv_format,
-    bool        use_blend,
-    bool        use_depth_test
+    std::string                     shader,
+    std::string                     vs,
+    std::string                     ps,
+    std::string                     include,
+    ImageFormat                     rtv_format,
+    bool                            use_blend,
+    bool                            use_depth_test,
+    bool                            use_depth_write,
+    std::vector<std::string> const& defines
   ) noexcept
 {
   _is_graphics_pipeline = true;
 
+  auto name = std::format("{} ({}, {})", shader, vs, ps);
+  for (auto const& define : defines)
+    name += std::format(" {}", define);
+  if (use_depth_write)
+    name += " depth write";
+
+  create_async(std::move(name), [=, this]
+  {
+    return create_graphics(shader, vs, ps, include, rtv_format, use_blend, use_depth_test, use_depth_write, defines);
+  });
+}
+
+void Pipeline::init_compute(std::string shader, std::string cs, std::string include) noexcept
+{
+  create_async(std::format("{} ({})", shader, cs), [=, this]
+  {
+    return create_compute(shader, cs, include);
+  });
+}
+
+auto Pipeline::create_graphics(std::string const& shader, std::string const& vs, std::string const& ps, std::string const& include, ImageFormat rtv_format, bool use_blend, bool use_depth_test, bool use_depth_write, std::vector<std::string> const& defines) noexcept -> bool
+{
   auto core = Core::instance();
 
-  auto compile_result = Compiler::instance()->compile(shader, vs, ps, include);
+  auto compile_result = Compiler::instance()->compile(shader, vs, ps, include, defines);
   _root_signature  = compile_result.root_signature;
   _resource_indexs = compile_result.resource_indexs;
 
@@ -42,20 +81,13 @@ void Pipeline::init_graphics(
   stream.PS                    = compile_result.ps;
   stream.RTVFormats            = render_target_formats;
     
+  // nearer shape has less depth, pixels behind written depth are rejected before pixel shader
   auto depth_stencil_desc = CD3DX12_DEPTH_STENCIL_DESC1(D3D12_DEFAULT);
-  depth_stencil_desc.DepthEnable           = false;
-  depth_stencil_desc.DepthBoundsTestEnable = false;
+  depth_stencil_desc.DepthEnable    = use_depth_test;
+  depth_stencil_desc.DepthFunc      = D3D12_COMPARISON_FUNC_LESS;
+  depth_stencil_desc.DepthWriteMask = use_depth_write ? D3D12_DEPTH_WRITE_MASK_ALL : D3D12_DEPTH_WRITE_MASK_ZERO;
   if (use_depth_test)
-  {
-    // check feature support
-    auto options = D3D12_FEATURE_DATA_D3D12_OPTIONS2{};
-    err_if(core->device()->CheckFeatureSupport(D3D12_FEATURE_D3D12_OPTIONS2, &options, sizeof(options)),
-            "failed to get feature options");
-    err_if(!options.DepthBoundsTestSupported, "unsupport depth bounds test");
-
-    depth_stencil_desc.DepthBoundsTestEnable = true;
-    stream.DSVFormat                         = DXGI_FORMAT_D32_FLOAT;
-  }
+    stream.DSVFormat = DXGI_FORMAT_D32_FLOAT;
   stream.DepthStencilState = depth_stencil_desc;
   
   auto  blend_state = CD3DX12_BLEND_DESC(D3D12_DEFAULT);
@@ -73,9 +105,11 @@ void Pipeline::init_graphics(
   auto pipeline_state_stream_desc = D3D12_PIPELINE_STATE_STREAM_DESC{ sizeof(stream), &stream };
   err_if(core->device()->CreatePipelineState(&pipeline_state_stream_desc, IID_PPV_ARGS(&_pipeline_state)),
           "failed to create pipeline state");
+
+  return compile_result.from_cache;
 }
 
-void Pipeline::init_compute(std::string shader, std::string cs, std::string include) noexcept
+auto Pipeline::create_compute(std::string const& shader, std::string const& cs, std::string const& include) noexcept -> bool
 {
   auto core = Core::instance();
 
@@ -90,10 +124,13 @@ void Pipeline::init_compute(std::string shader, std::string cs, std::string incl
   auto pipeline_state_stream_desc = D3D12_PIPELINE_STATE_STREAM_DESC{ sizeof(stream), &stream };
   err_if(core->device()->CreatePipelineState(&pipeline_state_stream_desc, IID_PPV_ARGS(&_pipeline_state)),
           "failed to create pipeline state");
+
+  return compile_result.from_cache;
 }
 
 void Pipeline::bind(ID3D12GraphicsCommandList1* cmd) const noexcept
 {
+  wait();
   cmd->SetPipelineState(_pipeline_state.Get());
   if (_is_graphics_pipeline)
   {
@@ -104,17 +141,12 @@ void Pipeline::bind(ID3D12GraphicsCommandList1* cmd) const noexcept
     cmd->SetComputeRootSignature(_root_signature.Get());
 }
 
-void Pipeline::set_descriptors(ID3D12GraphicsCommandList1* cmd, std::vector<std::pair<std::string_view, D3D12_GPU_DESCRIPTOR_HANDLE>> const& handles) const noexcept
+void Pipeline::resolve(std::string_view name, uint32_t& index, bool& is_graphics) const noexcept
 {
-  for (auto const& [name, handle] : handles)
-    if (_resource_indexs.contains(name.data()))
-    {
-      err_if(!handle.ptr, "failed to set descriptor table, the invalid gpu handle of 0");
-      if (_is_graphics_pipeline)
-        cmd->SetGraphicsRootDescriptorTable(_resource_indexs.at(name.data()), handle);
-      else
-        cmd->SetComputeRootDescriptorTable(_resource_indexs.at(name.data()), handle);
-    }
+  wait();
+  is_graphics = _is_graphics_pipeline;
+  if (auto it = _resource_indexs.find(std::string{ name }); it != _resource_indexs.end())
+    index = it->second;
 }
 
 }}
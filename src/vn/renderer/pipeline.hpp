@@ -5,9 +5,66 @@
 #include <string>
 #include <vector>
 #include <unordered_map>
+#include <future>
+#include <assert.h>
 
 namespace vn { namespace renderer {
 
+class Pipeline;
+
+/**
+ * root parameter slots resolved from reflection once, setting them per draw is only an index without any lookup
+ * slot of a resource which shader not uses is invalid and setting it does nothing
+ */
+class DescriptorTableBinding
+{
+  friend class Pipeline;
+
+public:
+  void set(ID3D12GraphicsCommandList1* cmd, D3D12_GPU_DESCRIPTOR_HANDLE handle) const noexcept
+  {
+    if (_index == Invalid_Index) return;
+    assert(handle.ptr);
+    if (_is_graphics)
+      cmd->SetGraphicsRootDescriptorTable(_index, handle);
+    else
+      cmd->SetComputeRootDescriptorTable(_index, handle);
+  }
+
+private:
+  static constexpr auto Invalid_Index = ~uint32_t{};
+
+  uint32_t _index{ Invalid_Index };
+  bool     _is_graphics{};
+};
+
+template <typename T>
+requires (sizeof(T) % 4 == 0)
+class RootConstantsBinding
+{
+  friend class Pipeline;
+
+public:
+  void set(ID3D12GraphicsCommandList1* cmd, T const& constants) const noexcept
+  {
+    if (_index == Invalid_Index) return;
+    if (_is_graphics)
+      cmd->SetGraphicsRoot32BitConstants(_index, sizeof(T) / 4, &constants, 0);
+    else
+      cmd->SetComputeRoot32BitConstants(_index, sizeof(T) / 4, &constants, 0);
+  }
+
+private:
+  static constexpr auto Invalid_Index = ~uint32_t{};
+
+  uint32_t _index{ Invalid_Index };
+  bool     _is_graphics{};
+};
+
+/**
+ * pipeline is compiled and created asynchronously after init,
+ * first use of pipeline (bind or resolving bindings) blocks until it's ready
+ */
 class Pipeline
 {
 public:
@@ -19,35 +76,57 @@ public:
   Pipeline& operator=(Pipeline&&)      = delete;
   
   void init_graphics(
-    std::string shader,
-    std::string vs,
-    std::string ps,
-    std::string include,
-    ImageFormat rtv_format,
-    bool        use_blend      = false,
-    bool        use_depth_test = false
+    std::string                     shader,
+    std::string                     vs,
+    std::string                     ps,
+    std::string                     include,
+    ImageFormat                     rtv_format,
+    bool                            use_blend      = false,
+    bool                            use_depth_test  = false,
+    bool                            use_depth_write = false,
+    std::vector<std::string> const& defines         = {}
   ) noexcept;
 
   void init_compute(std::string shader, std::string cs, std::string include = {}) noexcept;
 
+  /// block until pipeline is ready
+  void wait() const noexcept
+  {
+    if (_compiling.valid())
+      _compiling.get();
+  }
+
   void bind(ID3D12GraphicsCommandList1* cmd) const noexcept;
 
-  void set_descriptors(ID3D12GraphicsCommandList1* cmd, std::vector<std::pair<std::string_view, D3D12_GPU_DESCRIPTOR_HANDLE>> const& handles) const noexcept;
+  /// resolve binding by resource name in shader, do it once at init rather than per draw
+  auto descriptor_table(std::string_view name) const noexcept
+  {
+    auto binding = DescriptorTableBinding{};
+    resolve(name, binding._index, binding._is_graphics);
+    return binding;
+  }
 
-  template <typename ConstantsType>
-  void set_descriptors(ID3D12GraphicsCommandList1* cmd, std::string_view constants_name, ConstantsType const& constants, std::vector<std::pair<std::string_view, D3D12_GPU_DESCRIPTOR_HANDLE>> const& handles) const noexcept
+  template <typename T>
+  auto root_constants(std::string_view name) const noexcept
   {
-    if (_resource_indexs.contains(constants_name.data()))
-    {
-      if (_is_graphics_pipeline)
-        cmd->SetGraphicsRoot32BitConstants(_resource_indexs.at(constants_name.data()), sizeof(constants) / 4, &constants, 0);
-      else
-        cmd->SetComputeRoot32BitConstants(_resource_indexs.at(constants_name.data()), sizeof(constants) / 4, &constants, 0);
-    }
-    set_descriptors(cmd, handles);
+    auto binding = RootConstantsBinding<T>{};
+    resolve(name, binding._index, binding._is_graphics);
+    return binding;
   }
 
 private:
+  /// @return whether shaders are from shader cache
+  auto create_graphics(std::string const& shader, std::string const& vs, std::string const& ps, std::string const& include, ImageFormat rtv_format, bool use_blend, bool use_depth_test, bool use_depth_write, std::vector<std::string> const& defines) noexcept -> bool;
+  auto create_compute(std::string const& shader, std::string const& cs, std::string const& include) noexcept -> bool;
+
+  /// run create function in another thread and report its time
+  template <typename Func>
+  void create_async(std::string name, Func&& func) noexcept;
+
+  void resolve(std::string_view name, uint32_t& index, bool& is_graphics) const noexcept;
+
+private:
+  mutable std::future<void>                   _compiling;
   Microsoft::WRL::ComPtr<ID3D12PipelineState> _pipeline_state;
   Microsoft::WRL::ComPtr<ID3D12RootSignature> _root_signature;
   std::unordered_map<std::string, uint32_t>   _resource_indexs;
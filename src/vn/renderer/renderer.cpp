@@ -6,9 +6,13 @@
 #include "compiler.hpp"
 #include "descriptor_heap_manager.hpp"
 #include "image.hpp"
+#include "window_manager.hpp"
+#include "window_shadow.hpp"
 
 #include <algorithm>
 #include <ranges>
+#include <format>
+#include <utility>
 
 using namespace vn;
 using namespace vn::renderer;
@@ -78,35 +82,104 @@ void Renderer::init() noexcept
   core->init();
   DescriptorHeapManager::instance()->init();
 
-  load_cursor_images();
-
+  // pipelines are compiled in background, overlap with cursor loading
   create_pipeline_resource();
+
+  load_cursor_images();
+  load_window_shadow_image();
+  _distance_field_atlas.init();
+  _glyph_atlas.init();
+  _layer_pool.init();
+
+  // start render thread
+  _wake_event           = CreateEvent(nullptr, false, false, nullptr);
+  _frame_consumed_event = CreateEvent(nullptr, false, false, nullptr);
+  _retire_event         = CreateEvent(nullptr, false, false, nullptr);
+  err_if(!_wake_event || !_frame_consumed_event || !_retire_event, "failed to create render thread events");
+  _render_thread = std::jthread{ [this](std::stop_token token) { render_loop(token); } };
 }
 
 void Renderer::destroy() noexcept
 {
+  // stop render thread, rest works are finished in main thread
+  _render_thread.request_stop();
+  wake_up();
+  _render_thread.join();
+  message_process();
+
+  // pipelines may still compiling if they are never used
+  std::ranges::for_each(_sdf_pipelines,        [](auto const& pipeline) { pipeline.wait(); });
+  std::ranges::for_each(_opaque_sdf_pipelines, [](auto const& pipeline) { pipeline.wait(); });
+
   Core::instance()->wait_gpu_complete();
-  std::ranges::for_each(_window_resources | std::views::values, [](auto& wr) { wr.destroy(); });
+  _drag_cache.release();
+  _distance_field_atlas.destroy();
+  _glyph_atlas.destroy();
+  _layer_pool.destroy();
+  release_retired(UINT64_MAX);
+  std::ranges::for_each(_window_resources, [](auto& wr) { wr.destroy(); });
   std::ranges::for_each(_cursors | std::views::values, [&](auto& cursor) { g_image_pool.free(cursor.handle); });
+  g_image_pool.free(_window_shadow);
   g_external_image_loader.destroy();
+  g_image_pool.destroy();
   Core::instance()->destroy();
+  CloseHandle(_wake_event);
+  CloseHandle(_frame_consumed_event);
+  CloseHandle(_retire_event);
 }
 
 void Renderer::create_pipeline_resource() noexcept
 {
-  _sdf_pipeline.init_graphics("assets/shader.hlsl", "vs", "ps", "assets", SwapchainResource::Image_Format, true);
+  for (auto i : std::views::iota(0, Pixel_Shader_Permutation_Count))
+    _sdf_pipelines[i].init_graphics("assets/shader.hlsl", "vs", "ps", "assets", SwapchainResource::Image_Format, true, enable_depth_test, false, { std::format("PERMUTATION={}", i) });
 
-  // _window_shadow_pipeline.init_compute("assets/window_shadow.hlsl", "main");
-  // _window_mask_pipeline.init_compute("assets/window_mask.hlsl", "main");
+  // opaque pass writes depth without blending, only filled rectangles and images are opaque, see ShapeProperty::is_opaque
+  if (enable_depth_test)
+    for (auto permutation : { PixelShaderPermutation::rectangle, PixelShaderPermutation::image })
+    {
+      auto i = std::to_underlying(permutation);
+      _opaque_sdf_pipelines[i].init_graphics("assets/shader.hlsl", "vs", "ps", "assets", SwapchainResource::Image_Format, false, true, true, { std::format("PERMUTATION={}", i) });
+    }
+}
 
-  // auto size = get_screen_size();
-  // _uav_clear_heap.init(DescriptorHeapType::cbv_srv_uav, 1, true);
-  // _window_mask_image.init(ImageType::uav, ImageFormat::r8_unorm, size.x, size.y)
-  //                   .create_descriptor(_uav_clear_heap.pop_handle("window mask image"));
-  // _cbv_srv_uav_heap.add_tag("window mask image", 1);
+auto Renderer::sdf_bindings(PixelShaderPermutation permutation) noexcept -> SdfBindings const&
+{
+  auto  index    = std::to_underlying(permutation);
+  auto& bindings = _sdf_bindings[index];
+  if (!bindings)
+  {
+    auto const& pipeline = _sdf_pipelines[index];
+    bindings = SdfBindings
+    {
+      pipeline.root_constants<Constants>("constants"),
+      pipeline.descriptor_table("images"),
+      pipeline.descriptor_table("buffer"),
+    };
+  }
+  return *bindings;
+}
 
-  // _window_shadow_image.init(ImageType::uav, ImageFormat::rgba8_unorm, size.x, size.y)
-  //                     .create_descriptor(_cbv_srv_uav_heap.pop_handle("window shadow image"));
+void Renderer::draw_batches(ID3D12GraphicsCommandList1* cmd, D3D12_GPU_DESCRIPTOR_HANDLE buffer_handle, std::span<DrawBatch const> batches, Constants const& constants, uint32_t index_base, int32_t vertex_base) noexcept
+{
+  // permutations have their own root signatures, so descriptors are set again after switching pipeline
+  auto images_handle  = g_descriptor_heap_mgr.first_gpu_handle(DescriptorHeapType::cbv_srv_uav);
+  auto bound_pipeline = static_cast<Pipeline const*>(nullptr);
+  for (auto const& batch : batches)
+  {
+    // opaque variant shares root signature with blended one, so bindings are same
+    auto const& pipelines = batch.opaque ? _opaque_sdf_pipelines : _sdf_pipelines;
+    auto const& pipeline  = pipelines[std::to_underlying(batch.permutation)];
+    if (&pipeline != bound_pipeline)
+    {
+      auto const& bindings = sdf_bindings(batch.permutation);
+      pipeline.bind(cmd);
+      bindings.constants.set(cmd, constants);
+      bindings.images.set(cmd, images_handle);
+      bindings.buffer.set(cmd, buffer_handle);
+      bound_pipeline = &pipeline;
+    }
+    cmd->DrawIndexedInstanced(batch.index_count, 1, index_base + batch.index_offset, vertex_base, 0);
+  }
 }
 
 void Renderer::load_cursor_images() noexcept
@@ -155,51 +228,251 @@ void Renderer::load_cursor_images() noexcept
   std::ranges::for_each(bitmaps | std::views::values, [](auto& image) { image.destroy(); });
 }
 
-void Renderer::add_current_frame_render_finish_proc(std::function<void()>&& func) noexcept
+void Renderer::load_window_shadow_image() noexcept
+{
+  auto core = Core::instance();
+  core->reset_cmd();
+
+  // shadow is same for all windows, blur it once on cpu
+  auto shadow = generate_window_shadow(Window_Shadow_Thickness, Window_Shadow_Radius, { 0.f, 0.f, 0.f, Window_Shadow_Alpha });
+  auto bitmap = BitmapView{};
+  bitmap.init(shadow.extent(), shadow.extent(), 4);
+  bitmap.data = shadow.pixels.data();
+
+  _window_shadow = g_image_pool.alloc();
+  g_image_pool[_window_shadow].init(ImageType::srv, ImageFormat::rgba8_unorm, bitmap.width, bitmap.height);
+
+  auto upload_buffer = UploadBuffer{};
+  upload_buffer.add_images({ _window_shadow }, { bitmap });
+  upload_buffer.upload(core->cmd());
+  g_image_pool[_window_shadow].set_state(core->cmd(), ImageState::pixel_shader_resource);
+
+  // upload buffer must live until gpu finishes copying
+  core->submit(core->cmd());
+  core->wait_gpu_complete();
+}
+
+void Renderer::retire(RetireQueueType::Payload&& payload) noexcept
+{
+  _retire_queue.push(Core::instance()->fence_value() + 1, std::move(payload));
+}
+
+void Renderer::release_retired(uint64_t completed_fence_value) noexcept
 {
-  _current_frame_render_finish_procs.emplace_back([func, last_fence_value = Core::instance()->signal()]()
+  _retire_queue.release(completed_fence_value, [](auto& payload)
   {
-    auto fence_value = Core::instance()->fence()->GetCompletedValue();
-    err_if(fence_value == UINT64_MAX, "failed to get fence value because device is removed");
-    auto render_complete = fence_value >= last_fence_value;
-    if (render_complete) func();
-    return render_complete;
+    using T = std::decay_t<decltype(payload)>;
+    if constexpr (std::is_same_v<T, ImageHandle>)
+      g_image_pool.free(payload);
+    else if constexpr (std::is_same_v<T, WindowResource>)
+    {
+      payload.destroy();
+      // window only can be destroyed by its creating thread
+      PostMessageW(payload.window.handle, static_cast<uint32_t>(WindowManager::Message::window_destroy), 0, 0);
+    }
+    // com objects are released with entry
   });
 }
 
+void Renderer::render_loop(std::stop_token token) noexcept
+{
+  auto core   = Core::instance();
+  auto events = std::array{ _wake_event, _retire_event };
+  while (!token.stop_requested())
+  {
+    message_process();
+
+    // sleep until new messages come or the oldest retired resource is releasable
+    auto event_count = 1u;
+    if (!_retire_queue.empty())
+    {
+      // no more submission when idle, so signal the fence value which retired resources wait for
+      if (_retire_queue.back_fence_value() > core->fence_value())
+        core->signal();
+      err_if(core->fence()->SetEventOnCompletion(_retire_queue.front_fence_value(), _retire_event),
+              "failed to set event on completion");
+      event_count = 2;
+    }
+    WaitForMultipleObjectsEx(event_count, events.data(), false, INFINITE, false);
+  }
+}
+
 void Renderer::message_process() noexcept
 {
-  // process last render finish processes
-  for (auto it = _current_frame_render_finish_procs.begin(); it != _current_frame_render_finish_procs.end();)
-    (*it)() ? it = _current_frame_render_finish_procs.erase(it) : ++it;
+  // release resources which gpu finished using in one pass
+  auto core        = Core::instance();
+  auto fence_value = core->fence()->GetCompletedValue();
+  err_if(fence_value == UINT64_MAX, "failed to get fence value because device is removed");
+  release_retired(fence_value);
+  g_external_image_loader.upload_finish(fence_value);
 
   MessageQueue::instance()->process_messages();
 
+  g_external_image_loader.release_removed_images();
+
   // upload images
   if (g_external_image_loader.have_unuploaded_images())
   {
-    auto core = Core::instance();
     core->reset_cmd();
     g_external_image_loader.upload(core->cmd());
     core->submit(core->cmd());
   }
 }
 
-void Renderer::render(HWND handle, ui::WindowRenderData const& data) noexcept
+void Renderer::submit_frame() noexcept
 {
-  err_if(!_window_resources.contains(handle), "unknow window resource window when rendering");
-  _window_resources[handle].render(data.vertices, data.indices, data.shape_properties);
+  // wait last frame consumed by render thread
+  // dxgi may send messages to window when presenting, so dispatch sent messages during waiting avoid dead lock
+  while (_frame_pending.load(std::memory_order_acquire))
+  {
+    if (MsgWaitForMultipleObjectsEx(1, &_frame_consumed_event, INFINITE, QS_SENDMESSAGE, 0) == WAIT_OBJECT_0 + 1)
+    {
+      auto msg = MSG{};
+      PeekMessageW(&msg, nullptr, 0, 0, PM_NOREMOVE | PM_QS_SENDMESSAGE);
+    }
+  }
+
+  _frame_pending.store(true, std::memory_order_relaxed);
+  MessageQueue::instance()->send_message(MessageQueue::Message_Render_Frame{ _frame_index });
+  _frame_index = (_frame_index + 1) % _frames.size();
+  _frames[_frame_index].clear();
 }
 
-void Renderer::render_fullscreen(HWND handle, ui::WindowRenderData const& data) noexcept
+void Renderer::render_frame(uint32_t frame_index) noexcept
 {
-  _fullscreen_resource.render(data.vertices, data.indices, data.shape_properties, _window_resources[handle].window);
+  auto&       frame          = _frames[frame_index];
+  auto        render_windows = frame.render_windows();
+
+  if (frame.moving_or_resizing_finish_window)
+  {
+    _moving_or_resizing_finish_window = frame.moving_or_resizing_finish_window;
+    _drag_cache.release();
+  }
+
+  update_resize_resolution(render_windows);
+
+  // shapes sampling baked distance or glyphs in later frames, queue executes bakes and copies before their draws
+  _distance_field_atlas.bake(frame.distance_field_bakes);
+  _glyph_atlas.upload(frame.glyph_uploads);
+
+  // layers are rendered before windows which composite them, only render thread knows image indices of layers
+  _layer_pool.release(frame.released_layers);
+  _layer_pool.render(frame.layer_renders);
+  for (auto& window : std::span{ frame.windows }.first(frame.window_count))
+    for (auto const& layer : window.render_data.layers)
+      window.render_data.shape_properties[layer.shape_property].set_value(0, _layer_pool.index(layer.id));
+
+  // commit render commands
+  auto need_clear_window     = WindowId{};
+  auto use_fullscreen_window = WindowId{};
+  for (auto const& window : render_windows)
+  {
+    // for moving or resizing window, use fullscreen promise smooth winodw size change and move sync with cursor
+    if (window.moving_or_resizing)
+    {
+      use_fullscreen_window = window.id;
+
+      // use fullscreen render first frame need to clear window content
+      if (window.need_clear)
+      {
+        need_clear_window = window.id;
+        clear_window(window.id);
+      }
+
+      // use window render data to render on fullscreen
+      render_fullscreen(window.id, window.render_data, window.capture_drag_cache);
+    }
+    else
+      render(window.id, window.render_data);
+  }
+
+  if (_moving_or_resizing_finish_window) clear_fullscreen();
+
+  // present windows
+  // at least one vsync present promise all window vsync support present barrier
+  if (use_fullscreen_window)
+  {
+    if (need_clear_window)
+      present(need_clear_window);
+    std::ranges::for_each(render_windows | std::views::filter([&](auto const& window) { return window.id != use_fullscreen_window; }),
+      [&](auto const& window) { present(window.id); });
+    present_fullscreen(true);
+  }
+  else
+  {
+    // HACK:
+    // I can't implement two window present at same monitor frame beside nvidia which NvApi 
+    // intel and amd driver I'm not see any api support present barrier
+    // so this process which present two windows, mostly it's ok
+    // but some pc's performance problem can be cause two windows present in differet monitor frame
+    // so the filcker will happen
+    if (_moving_or_resizing_finish_window)
+    {
+      std::ranges::for_each(render_windows | std::views::filter([&](auto const& window) { return window.id != _moving_or_resizing_finish_window; }),
+        [&](auto const& window) { present(window.id); });
+      present_fullscreen();
+      present(_moving_or_resizing_finish_window, true);
+      _moving_or_resizing_finish_window = {};
+    }
+    else
+    {
+      std::ranges::for_each(render_windows | std::views::take(render_windows.size() - 1),
+        [&](auto const& window) { present(window.id); });
+      std::ranges::for_each(render_windows | std::views::reverse | std::views::take(1),
+        [&](auto const& window) { present(window.id, true); });
+    }
+  }
+
+  // frame is consumed, main thread can record next frame on it
+  _frame_pending.store(false, std::memory_order_release);
+  SetEvent(_frame_consumed_event);
+}
+
+void Renderer::update_resize_resolution(std::span<FrameRenderData::WindowData const> render_windows) noexcept
+{
+  // full resolution as soon as resizing finishes
+  auto resizing = std::ranges::any_of(render_windows, [this](auto const& window)
+    { return window.moving_or_resizing && _window_resources.at(window.id).window.resizing; });
+  if (!resizing)
+  {
+    if (_resize_frame_begin)
+      info("[Renderer] resizing finished at render scale {:.2f}", _resize_resolution.scale());
+    _resize_resolution.reset();
+    _resize_frame_begin = {};
+    return;
+  }
+
+  // frame time is interval between frames, first resizing frame has no interval
+  auto now = std::chrono::steady_clock::now();
+  if (_resize_frame_begin)
+    _resize_resolution.update(std::chrono::duration<float, std::milli>(now - *_resize_frame_begin).count());
+  _resize_frame_begin = now;
+}
+
+void Renderer::render(WindowId id, ui::WindowRenderData const& data) noexcept
+{
+  err_if(!_window_resources.contains(id), "unknow window resource window when rendering");
+  auto& window_resource = _window_resources[id];
+  window_resource.damage(data.dirty_rects);
+  window_resource.render(data.vertices, data.indices, data.shape_properties, data.batches);
+}
+
+void Renderer::render_fullscreen(WindowId id, ui::WindowRenderData const& data, bool capture_drag_cache) noexcept
+{
+  auto const& window = _window_resources.at(id).window;
+  if (capture_drag_cache)
+  {
+    // images always fit full resolution, so changing scale not reallocates them
+    _drag_cache.reserve(window.width, window.height);
+    _drag_cache.scale = window.resizing ? _resize_resolution.scale() : 1.f;
+  }
+  _fullscreen_resource.render(data.vertices, data.indices, data.shape_properties, data.batches, window, capture_drag_cache);
 }
 
-void Renderer::present(HWND handle, bool vsync) const noexcept
+void Renderer::present(WindowId id, bool vsync) const noexcept
 {
-  err_if(!_window_resources.contains(handle), "unknow window resource window when rendering");
-  _window_resources.at(handle).present(vsync);
+  err_if(!_window_resources.contains(id), "unknow window resource window when rendering");
+  _window_resources[id].present(vsync);
 }
 
 }}
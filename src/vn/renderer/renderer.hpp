@@ -2,23 +2,76 @@
 
 #include "window_resource.hpp"
 #include "pipeline.hpp"
-
-#include <functional>
-#include <deque>
+#include "../ui/window_render_data.hpp"
+#include "../dense_map.hpp"
+#include "retire_queue.hpp"
+#include "resolution_controller.hpp"
+#include "distance_field_atlas.hpp"
+#include "glyph_atlas.hpp"
+#include "layer_pool.hpp"
+
+#include <thread>
+#include <atomic>
+#include <chrono>
 
 namespace vn { namespace ui {
 
 struct UIContext;
-struct WindowRenderData;
 
 }}
 
 namespace vn { namespace renderer {
 
+/**
+ * render data of one frame recorded by main thread
+ * double buffered, main thread records next frame while render thread consumes current one
+ */
+struct FrameRenderData
+{
+  struct WindowData
+  {
+    WindowId             id{};
+    ui::WindowRenderData render_data;
+    bool                 moving_or_resizing{};
+    bool                 need_clear{};
+    bool                 capture_drag_cache{}; // render data is full content, not the blit of drag cache
+  };
+
+  std::vector<WindowData>            windows;
+  uint32_t                           window_count{};
+  WindowId                           moving_or_resizing_finish_window{};
+  std::vector<ui::DistanceFieldBake> distance_field_bakes; // baked before windows are rendered
+  std::vector<ui::GlyphUpload>       glyph_uploads;        // copied into atlas before windows are rendered
+  std::vector<ui::LayerRender>       layer_renders;        // rendered before windows which composite them
+  std::vector<size_t>                released_layers;      // evicted from layer cache
+
+  // window datas are reused between frames, so their buffers keep capacity
+  auto add_window(WindowId id) noexcept -> WindowData&
+  {
+    if (window_count == windows.size()) windows.emplace_back();
+    auto& window = windows[window_count++];
+    window.id = id;
+    return window;
+  }
+
+  auto render_windows() const noexcept { return std::span{ windows.data(), window_count }; }
+
+  void clear() noexcept
+  {
+    window_count                     = {};
+    moving_or_resizing_finish_window = {};
+    distance_field_bakes.clear();
+    glyph_uploads.clear();
+    layer_renders.clear();
+    released_layers.clear();
+  }
+};
+
 class Renderer
 {
   friend class MessageQueue;
   friend class WindowResource;
+  friend struct LayerPool;
   friend class ui::UIContext;
 
 private:
@@ -39,36 +92,87 @@ public:
   void init()    noexcept;
   void destroy() noexcept;
 
-  void resize_window(HWND handle, uint32_t width, uint32_t height) noexcept { return _window_resources[handle].resize(width, height); }
+  using RetireQueueType = RetireQueue<Microsoft::WRL::ComPtr<ID3D12Pageable>, ImageHandle, WindowResource>;
+
+  /**
+   * release payload after gpu finishes all submitted works and the works recording now,
+   * it waits fence value of next submission rather than signaling for each payload
+   * only call in render thread
+   */
+  void retire(RetireQueueType::Payload&& payload) noexcept;
+
+  /// only call in main thread, frame which is able to be recorded
+  auto current_frame() noexcept { return &_frames[_frame_index]; }
+
+  /// only call in main thread, hand over current frame to render thread, block until last frame consumed
+  void submit_frame() noexcept;
 
-  void add_current_frame_render_finish_proc(std::function<void()>&& func) noexcept;
+  void wake_up() const noexcept { SetEvent(_wake_event); }
 
+  // set by vn::init before renderer init and fixed afterwards, see InitOptions
+  bool enable_depth_test{ true };
+  bool enable_overdraw_stats{};
+
+private:
+  void render_loop(std::stop_token token) noexcept;
   void message_process() noexcept;
+  void release_retired(uint64_t completed_fence_value) noexcept;
+  void render_frame(uint32_t frame_index) noexcept;
+  void update_resize_resolution(std::span<FrameRenderData::WindowData const> render_windows) noexcept;
 
-  void render(HWND handle, ui::WindowRenderData const& data) noexcept;
-  void render_fullscreen(HWND handle, ui::WindowRenderData const& data) noexcept;
-  void present(HWND handle, bool vsync = false) const noexcept;
+  void render(WindowId id, ui::WindowRenderData const& data) noexcept;
+  void render_fullscreen(WindowId id, ui::WindowRenderData const& data, bool capture_drag_cache) noexcept;
+  void present(WindowId id, bool vsync = false) const noexcept;
   void present_fullscreen(bool vsync = false) const noexcept { _fullscreen_resource.present(vsync); }
-	void clear_window(HWND handle) noexcept { _window_resources.at(handle).clear_window(); }
+	void clear_window(WindowId id) noexcept { _window_resources.at(id).clear_window(); }
   void clear_fullscreen() noexcept { _fullscreen_resource.clear_window(); }
 
-  static constexpr auto enable_depth_test{ false };
-
-private:
   void create_pipeline_resource() noexcept;
 
+  struct SdfBindings
+  {
+    RootConstantsBinding<Constants> constants;
+    DescriptorTableBinding          images;
+    DescriptorTableBinding          buffer;
+  };
+
+  /// bindings are resolved at first use of permutation, only call in render thread
+  auto sdf_bindings(PixelShaderPermutation permutation) noexcept -> SdfBindings const&;
+
+  /**
+   * draw batches by sdf pipelines, vertices and indices of frame buffer are already set to command list
+   * @param index_base   indices of batches start from it
+   * @param vertex_base  added to indices
+   */
+  void draw_batches(ID3D12GraphicsCommandList1* cmd, D3D12_GPU_DESCRIPTOR_HANDLE buffer_handle, std::span<DrawBatch const> batches, Constants const& constants, uint32_t index_base = {}, int32_t vertex_base = {}) noexcept;
+
   void load_cursor_images() noexcept;
+  void load_window_shadow_image() noexcept;
 
 private:
   WindowResource                           _fullscreen_resource;
-  std::unordered_map<HWND, WindowResource> _window_resources;
-  std::deque<std::function<bool()>>        _current_frame_render_finish_procs;
-  Pipeline                                 _sdf_pipeline;
-
-  // Pipeline _window_mask_pipeline;
-  // Image    _window_mask_image;
-  // Pipeline _window_shadow_pipeline;
-  // Image    _window_shadow_image;
+  DenseMap<WindowResource>                 _window_resources;
+  RetireQueueType                          _retire_queue;
+  DragCache                                _drag_cache; // only one window is able to move or resize at a time
+  DistanceFieldAtlas                       _distance_field_atlas;
+  GlyphAtlas                               _glyph_atlas;
+  LayerPool                                _layer_pool;
+  ResolutionController                     _resize_resolution;
+  std::optional<std::chrono::steady_clock::time_point> _resize_frame_begin;
+  std::array<Pipeline, Pixel_Shader_Permutation_Count>                    _sdf_pipelines;
+  std::array<Pipeline, Pixel_Shader_Permutation_Count>                    _opaque_sdf_pipelines; // only permutations of opaque shapes are initialized
+  std::array<std::optional<SdfBindings>, Pixel_Shader_Permutation_Count> _sdf_bindings;
+  WindowId                                 _moving_or_resizing_finish_window{};
+
+  std::array<FrameRenderData, 2> _frames;
+  uint32_t                       _frame_index{};
+  std::atomic<bool>              _frame_pending{};
+  HANDLE                         _frame_consumed_event{};
+  HANDLE                         _wake_event{};
+  HANDLE                         _retire_event{};
+  std::jthread                   _render_thread;
+
+  ImageHandle _window_shadow;
 
   struct Cursor
   {
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace vn { namespace renderer {
+
+/**
+ * pick render scale of resizing window from frame times
+ * shading cost is proportional to pixel count, so scale is lowered by square root of budget ratio at once,
+ * and raised step by step after staying under budget for a while, avoid oscillating between two scales
+ * pure logic without gpu, so it can be driven by recorded frame times
+ */
+class ResolutionController
+{
+public:
+  static constexpr auto Min_Scale    = 0.5f;
+  static constexpr auto Max_Scale    = 1.f;
+  static constexpr auto Scale_Step   = 1.f / 16;
+  static constexpr auto Smoothing    = 0.25f; // weight of new frame time in moving average
+  static constexpr auto Over_Budget  = 1.2f;  // average over budget by this ratio lowers scale
+  static constexpr auto Under_Budget = 1.05f; // average under budget by this ratio raises scale
+  static constexpr auto Raise_Delay  = 8u;    // frames under budget before raising scale
+
+  /// @param budget expected frame time in milliseconds
+  ResolutionController(float budget = 1000.f / 60) noexcept : _budget(budget) {}
+
+  /// @param frame_time last frame time in milliseconds
+  /// @return scale of next frame
+  auto update(float frame_time) noexcept
+  {
+    _average = _average == 0.f ? frame_time : std::lerp(_average, frame_time, Smoothing);
+
+    if (_average > _budget * Over_Budget)
+    {
+      // lower at least one step, and start average again so same slow frames not lower it twice
+      auto scale = std::floor(_scale * std::sqrt(_budget / _average) / Scale_Step) * Scale_Step;
+      _scale               = std::max(Min_Scale, std::min(scale, _scale - Scale_Step));
+      _average             = _budget;
+      _under_budget_frames = {};
+    }
+    else if (_average < _budget * Under_Budget && _scale < Max_Scale)
+    {
+      if (++_under_budget_frames >= Raise_Delay)
+      {
+        _scale               = std::min(Max_Scale, _scale + Scale_Step);
+        _under_budget_frames = {};
+      }
+    }
+    else
+      _under_budget_frames = {};
+
+    return _scale;
+  }
+
+  /// back to full resolution, use when interaction which needs dynamic resolution finishes
+  void reset() noexcept
+  {
+    _scale               = Max_Scale;
+    _average             = {};
+    _under_budget_frames = {};
+  }
+
+  auto scale()  const noexcept { return _scale;  }
+  auto budget() const noexcept { return _budget; }
+
+private:
+  float    _budget{};
+  float    _scale{ Max_Scale };
+  float    _average{};
+  uint32_t _under_budget_frames{};
+};
+
+}}
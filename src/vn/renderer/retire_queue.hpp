@@ -0,0 +1,51 @@
+#pragma once
+
+#include <deque>
+#include <variant>
+#include <assert.h>
+
+namespace vn { namespace renderer {
+
+/**
+ * resources which gpu may still use, released after fence reaches their fence value
+ * fence values are pushed in non-decreasing order, so entries are ordered by fence value and
+ * releasing is popping from front until first incompleted one
+ * payloads are stored in place as variant, no type erased allocation per entry
+ */
+template <typename... Payloads>
+class RetireQueue
+{
+public:
+  using Payload = std::variant<Payloads...>;
+
+  void push(uint64_t fence_value, Payload&& payload) noexcept
+  {
+    assert(_entries.empty() || _entries.back().fence_value <= fence_value);
+    _entries.emplace_back(fence_value, std::move(payload));
+  }
+
+  /// @param func invoked by every payload type
+  template <typename Func>
+  void release(uint64_t completed_fence_value, Func&& func) noexcept
+  {
+    while (!_entries.empty() && _entries.front().fence_value <= completed_fence_value)
+    {
+      std::visit(func, _entries.front().payload);
+      _entries.pop_front();
+    }
+  }
+
+  auto empty()             const noexcept { return _entries.empty();              }
+  auto front_fence_value() const noexcept { return _entries.front().fence_value; }
+  auto back_fence_value()  const noexcept { return _entries.back().fence_value;  }
+
+private:
+  struct Entry
+  {
+    uint64_t fence_value{};
+    Payload  payload;
+  };
+  std::deque<Entry> _entries;
+};
+
+}}
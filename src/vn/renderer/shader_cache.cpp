@@ -0,0 +1,270 @@
+#include "shader_cache.hpp"
+#include "config.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <format>
+#include <ranges>
+#include <unordered_set>
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
+using namespace vn;
+using namespace vn::renderer;
+
+namespace
+{
+
+constexpr auto Magic   = uint32_t{ 0x4353'4e56 }; // "VNSC"
+constexpr auto Version = uint32_t{ 1 };
+
+class Writer
+{
+public:
+  void write(uint32_t value) noexcept
+  {
+    auto ptr = reinterpret_cast<uint8_t const*>(&value);
+    data.insert(data.end(), ptr, ptr + sizeof(value));
+  }
+
+  void write(std::span<uint8_t const> bytes) noexcept
+  {
+    write(static_cast<uint32_t>(bytes.size()));
+    data.insert(data.end(), bytes.begin(), bytes.end());
+  }
+
+  void write(std::string_view str) noexcept
+  {
+    write({ reinterpret_cast<uint8_t const*>(str.data()), str.size() });
+  }
+
+  std::vector<uint8_t> data;
+};
+
+class Reader
+{
+public:
+  Reader(std::span<uint8_t const> data) noexcept : _data(data) {}
+
+  auto read(uint32_t& value) noexcept
+  {
+    if (_data.size() - _offset < sizeof(value)) return false;
+    memcpy(&value, _data.data() + _offset, sizeof(value));
+    _offset += sizeof(value);
+    return true;
+  }
+
+  template <typename T>
+  auto read(T& container) noexcept
+  {
+    auto size = uint32_t{};
+    if (!read(size) || _data.size() - _offset < size) return false;
+    auto ptr = _data.data() + _offset;
+    container.assign(ptr, ptr + size);
+    _offset += size;
+    return true;
+  }
+
+  auto finished() const noexcept { return _offset == _data.size(); }
+
+private:
+  std::span<uint8_t const> _data;
+  size_t                   _offset{};
+};
+
+auto read_file(std::filesystem::path const& path) noexcept -> std::optional<std::string>
+{
+  auto file = std::ifstream{ path, std::ios::binary };
+  if (!file) return {};
+  return std::string{ std::istreambuf_iterator<char>{ file }, {} };
+}
+
+auto cache_path(uint64_t key) noexcept
+{
+  return std::filesystem::path{ Shader_Cache_Directory } / std::format("{:016x}.bin", key);
+}
+
+/// return include names of #include "x" and #include <x>
+auto parse_includes(std::string_view source) noexcept -> std::vector<std::string_view>
+{
+  auto includes = std::vector<std::string_view>{};
+  for (auto line : source | std::views::split('\n'))
+  {
+    auto str = std::string_view{ line.begin(), line.end() };
+    auto pos = str.find_first_not_of(" \t");
+    if (pos == std::string_view::npos || str[pos] != '#') continue;
+    pos = str.find_first_not_of(" \t", pos + 1);
+    if (pos == std::string_view::npos || !str.substr(pos).starts_with("include")) continue;
+    auto beg = str.find_first_of("\"<", pos);
+    if (beg == std::string_view::npos) continue;
+    auto end = str.find_first_of(str[beg] == '"' ? '"' : '>', beg + 1);
+    if (end == std::string_view::npos) continue;
+    includes.emplace_back(str.substr(beg + 1, end - beg - 1));
+  }
+  return includes;
+}
+
+}
+
+namespace vn { namespace renderer {
+
+auto shader_cache_key(std::span<std::string const> sources, std::span<std::string_view const> entry_points, std::span<std::wstring_view const> args) noexcept -> uint64_t
+{
+  auto hash = Fnv1a{};
+  hash.add(Version);
+  hash.add(static_cast<uint32_t>(sources.size()));
+  for (auto const& source : sources)
+    hash.add(source);
+  hash.add(static_cast<uint32_t>(entry_points.size()));
+  for (auto entry_point : entry_points)
+    hash.add(entry_point);
+  hash.add(static_cast<uint32_t>(args.size()));
+  for (auto arg : args)
+    hash.add({ reinterpret_cast<uint8_t const*>(arg.data()), arg.size() * sizeof(wchar_t) });
+  return hash.value();
+}
+
+auto serialize(ShaderCacheEntry const& entry) noexcept -> std::vector<uint8_t>
+{
+  auto writer = Writer{};
+  writer.write(Magic);
+  writer.write(Version);
+  writer.write(entry.vs);
+  writer.write(entry.ps);
+  writer.write(entry.cs);
+  writer.write(entry.root_signature);
+
+  writer.write(static_cast<uint32_t>(entry.input_elements.size()));
+  for (auto const& element : entry.input_elements)
+  {
+    writer.write(element.semantic_name);
+    writer.write(element.semantic_index);
+    writer.write(element.format);
+  }
+
+  // sort names so same entry always produces same bytes
+  auto names = std::vector<std::string_view>{};
+  names.reserve(entry.resource_indexs.size());
+  for (auto const& name : entry.resource_indexs | std::views::keys)
+    names.emplace_back(name);
+  std::ranges::sort(names);
+  writer.write(static_cast<uint32_t>(names.size()));
+  for (auto name : names)
+  {
+    writer.write(name);
+    writer.write(entry.resource_indexs.at(std::string{ name }));
+  }
+
+  // checksum of all above to detect torn or corrupted files
+  auto hash = Fnv1a{};
+  hash.add(writer.data);
+  writer.write(static_cast<uint32_t>(hash.value()));
+  writer.write(static_cast<uint32_t>(hash.value() >> 32));
+  return writer.data;
+}
+
+auto deserialize(std::span<uint8_t const> data) noexcept -> std::optional<ShaderCacheEntry>
+{
+  constexpr auto Checksum_Size = sizeof(uint64_t);
+  if (data.size() < Checksum_Size) return {};
+
+  auto payload  = data.first(data.size() - Checksum_Size);
+  auto checksum = uint64_t{};
+  memcpy(&checksum, data.data() + payload.size(), sizeof(checksum));
+  auto hash = Fnv1a{};
+  hash.add(payload);
+  if (hash.value() != checksum) return {};
+
+  auto reader  = Reader{ payload };
+  auto magic   = uint32_t{};
+  auto version = uint32_t{};
+  if (!reader.read(magic) || magic != Magic || !reader.read(version) || version != Version)
+    return {};
+
+  auto entry = ShaderCacheEntry{};
+  if (!reader.read(entry.vs) || !reader.read(entry.ps) || !reader.read(entry.cs) || !reader.read(entry.root_signature))
+    return {};
+
+  auto count = uint32_t{};
+  if (!reader.read(count)) return {};
+  for (auto i = uint32_t{}; i < count; ++i)
+  {
+    auto& element = entry.input_elements.emplace_back();
+    if (!reader.read(element.semantic_name) || !reader.read(element.semantic_index) || !reader.read(element.format))
+      return {};
+  }
+
+  if (!reader.read(count)) return {};
+  for (auto i = uint32_t{}; i < count; ++i)
+  {
+    auto name  = std::string{};
+    auto index = uint32_t{};
+    if (!reader.read(name) || !reader.read(index))
+      return {};
+    entry.resource_indexs[name] = index;
+  }
+
+  if (!reader.finished()) return {};
+  return entry;
+}
+
+auto ShaderCache::read_sources(std::string_view shader_path, std::string_view include) const noexcept -> std::vector<std::string>
+{
+  auto sources = std::vector<std::string>{};
+  auto visited = std::unordered_set<std::string>{};
+  auto pending = std::vector<std::filesystem::path>{ std::filesystem::path{ shader_path } };
+  while (!pending.empty())
+  {
+    auto path = std::filesystem::weakly_canonical(pending.back());
+    pending.pop_back();
+    if (!visited.emplace(path.string()).second) continue;
+
+    auto source = read_file(path);
+    // missing file is reported by dxc later, here only hash what exists
+    if (!source) continue;
+
+    // push in reverse so includes are visited in source order
+    for (auto name : parse_includes(*source) | std::views::reverse)
+    {
+      auto local = path.parent_path() / name;
+      if (std::filesystem::exists(local) || include.empty())
+        pending.emplace_back(std::move(local));
+      else
+        pending.emplace_back(std::filesystem::path{ include } / name);
+    }
+    sources.emplace_back(std::move(*source));
+  }
+
+  return sources;
+}
+
+auto ShaderCache::load(uint64_t key) const noexcept -> std::optional<ShaderCacheEntry>
+{
+  auto data = read_file(cache_path(key));
+  if (!data) return {};
+  return deserialize({ reinterpret_cast<uint8_t const*>(data->data()), data->size() });
+}
+
+void ShaderCache::store(uint64_t key, ShaderCacheEntry const& entry) const noexcept
+{
+  auto ec = std::error_code{};
+  std::filesystem::create_directories(Shader_Cache_Directory, ec);
+  if (ec) return;
+
+  // write to temporary file then rename, so reader never sees partial file,
+  // temporary file is per thread since pipelines are compiled concurrently
+  auto path     = cache_path(key);
+  auto tmp_path = std::filesystem::path{ path }.concat(std::format(".{}.tmp", std::hash<std::thread::id>{}(std::this_thread::get_id())));
+  {
+    auto file = std::ofstream{ tmp_path, std::ios::binary | std::ios::trunc };
+    if (!file) return;
+    auto data = serialize(entry);
+    file.write(reinterpret_cast<char const*>(data.data()), data.size());
+    if (!file) return;
+  }
+  std::filesystem::rename(tmp_path, path, ec);
+  if (ec) std::filesystem::remove(tmp_path, ec);
+}
+
+}}
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <optional>
+#include <span>
+#include <cstdint>
+
+namespace vn { namespace renderer {
+
+/**
+ * 64-bit fnv-1a, stable across runs and builds so it can key persistent files
+ */
+class Fnv1a
+{
+public:
+  void add(std::span<uint8_t const> data) noexcept
+  {
+    for (auto byte : data)
+    {
+      _value ^= byte;
+      _value *= Prime;
+    }
+  }
+
+  void add(std::string_view str) noexcept
+  {
+    add({ reinterpret_cast<uint8_t const*>(str.data()), str.size() });
+    // separator makes ("ab", "c") and ("a", "bc") different
+    add(uint32_t{ static_cast<uint32_t>(str.size()) });
+  }
+
+  void add(uint32_t value) noexcept
+  {
+    add({ reinterpret_cast<uint8_t const*>(&value), sizeof(value) });
+  }
+
+  auto value() const noexcept { return _value; }
+
+private:
+  static constexpr auto Offset_Basis = uint64_t{ 0xcbf29ce484222325 };
+  static constexpr auto Prime        = uint64_t{ 0x100000001b3 };
+
+  uint64_t _value{ Offset_Basis };
+};
+
+/**
+ * everything the pipeline needs from compiling a shader, so a warm start can skip dxc and reflection
+ * graphics shader has vs and ps, compute shader only has cs
+ */
+struct ShaderCacheEntry
+{
+  struct InputElement
+  {
+    std::string semantic_name;
+    uint32_t    semantic_index{};
+    uint32_t    format{};
+
+    bool operator==(InputElement const&) const noexcept = default;
+  };
+
+  std::vector<uint8_t>                      vs;
+  std::vector<uint8_t>                      ps;
+  std::vector<uint8_t>                      cs;
+  std::vector<uint8_t>                      root_signature;
+  std::vector<InputElement>                 input_elements;
+  std::unordered_map<std::string, uint32_t> resource_indexs;
+
+  bool operator==(ShaderCacheEntry const&) const noexcept = default;
+};
+
+/**
+ * key of shader cache, covers all inputs which affect compile result
+ * @param sources contents of shader and its include closure, in include order
+ * @param entry_points entry points with their profiles, e.g. { "vs", "vs_6_0", "ps", "ps_6_0" }
+ * @param args compiler arguments
+ */
+auto shader_cache_key(std::span<std::string const> sources, std::span<std::string_view const> entry_points, std::span<std::wstring_view const> args) noexcept -> uint64_t;
+
+/// serialize entry to a self-validating byte stream
+auto serialize(ShaderCacheEntry const& entry) noexcept -> std::vector<uint8_t>;
+
+/// return nullopt if data is truncated, corrupted or from other cache version
+auto deserialize(std::span<uint8_t const> data) noexcept -> std::optional<ShaderCacheEntry>;
+
+/**
+ * persistent shader cache, one file per key under Shader_Cache_Directory
+ * any failure of reading degrades to a cache miss, failure of writing is ignored
+ */
+class ShaderCache
+{
+private:
+  ShaderCache()                              = default;
+  ~ShaderCache()                             = default;
+public:
+  ShaderCache(ShaderCache const&)            = delete;
+  ShaderCache(ShaderCache&&)                 = delete;
+  ShaderCache& operator=(ShaderCache const&) = delete;
+  ShaderCache& operator=(ShaderCache&&)      = delete;
+
+  static auto const instance() noexcept
+  {
+    static ShaderCache instance;
+    return &instance;
+  }
+
+  /**
+   * read shader and the files it includes recursively
+   * quoted includes are searched in directory of including file first, then include directory
+   */
+  auto read_sources(std::string_view shader_path, std::string_view include) const noexcept -> std::vector<std::string>;
+
+  auto load(uint64_t key) const noexcept -> std::optional<ShaderCacheEntry>;
+  void store(uint64_t key, ShaderCacheEntry const& entry) const noexcept;
+};
+
+}}
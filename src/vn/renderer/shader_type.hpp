@@ -3,6 +3,8 @@
 #include <glm/glm.hpp>
 
 #include <bit>
+#include <utility>
+#include <vector>
 
 namespace vn { namespace renderer {
 
@@ -18,6 +20,37 @@ struct Constants
   glm::vec<2, uint32_t> window_extent{};
   glm::vec2             window_pos{};
   uint32_t              cursor_index{};
+  uint32_t              drag_cache_index{};
+  float                 render_scale{ 1.f };
+  float                 drag_cache_scale{ 1.f };
+  uint32_t              window_shadow_index{};
+  uint32_t              distance_field_atlas_index{};
+  uint32_t              glyph_atlas_index{};
+};
+
+/**
+ * pixel shader is compiled once per permutation with PERMUTATION define, see assets/shader.hlsl
+ * specialized permutations skip the shape type switch and operator loop of generic one
+ */
+enum class PixelShaderPermutation : uint32_t
+{
+  generic,   // path, union and discard
+  rectangle,
+  circle,
+  primitive, // triangle, line and bezier
+  image,     // image, cursor, drag cache, window shadow, distance field, layer and glyph
+};
+constexpr auto Pixel_Shader_Permutation_Count = 5;
+
+/// continuous indices drawn with single permutation
+struct DrawBatch
+{
+  PixelShaderPermutation permutation{};
+  uint32_t               index_offset{};
+  uint32_t               index_count{};
+  bool                   window_shadow{}; // drawn out of content area, leads other batches
+  bool                   opaque{};        // drawn front to back with depth write and without blending, before translucent batches
+  bool                   drag_cache{};    // drag cache quad alone, batches before it are content captured into drag cache
 };
 
 struct ShapeProperty
@@ -35,7 +68,13 @@ struct ShapeProperty
     path_line,
     path_bezier,
 
-    image
+    image,
+
+    drag_cache,     // window content captured when moving or resizing starts
+    window_shadow,  // slice of 9-slice window shadow image
+    distance_field, // baked distance of path or union sampled from atlas, values are its uv rectangle
+    layer,          // composite of layer image, values are image index, extent of layer and version of its content
+    glyph,          // msdf of glyph sampled from atlas, values are its uv rectangle, distance range in window pixels and version of its cell
   };
 
   enum class Operator : uint32_t
@@ -47,6 +86,7 @@ struct ShapeProperty
 
   enum class Flag : uint32_t
   {
+    opaque = 1 << 0, // covers whole quad with full alpha, for shapes which are not opaque by their type, color and thickness
   };
 
   struct Header
@@ -75,6 +115,41 @@ struct ShapeProperty
 
   auto data()      const noexcept { return _data.data();                    }
   auto byte_size() const noexcept { return _data.size() * sizeof(uint32_t); }
+  auto type()      const noexcept { return static_cast<Type>(_data[0]);     }
+  auto op()        const noexcept { return static_cast<Operator>(_data[6]); }
+  auto flags()     const noexcept { return static_cast<Flag>(_data[7]);     }
+  auto color()     const noexcept { return glm::vec4{ std::bit_cast<float>(_data[1]), std::bit_cast<float>(_data[2]), std::bit_cast<float>(_data[3]), std::bit_cast<float>(_data[4]) }; }
+  auto thickness() const noexcept { return std::bit_cast<float>(_data[5]); }
+
+  /// every pixel of quad is drawn with full alpha, so shapes under the quad are invisible
+  auto is_opaque() const noexcept
+  {
+    if (op() != Operator::none) return false;
+    if (type() == Type::rectangle && thickness() == 0.f && color().a >= 1.f) return true;
+    return (std::to_underlying(flags()) & std::to_underlying(Flag::opaque)) != 0;
+  }
+
+  auto permutation() const noexcept
+  {
+    if (op() != Operator::none)
+      return PixelShaderPermutation::generic;
+    switch (type())
+    {
+    case Type::rectangle:      return PixelShaderPermutation::rectangle;
+    case Type::circle:         return PixelShaderPermutation::circle;
+    case Type::triangle:
+    case Type::line:
+    case Type::bezier:         return PixelShaderPermutation::primitive;
+    case Type::cursor:
+    case Type::image:
+    case Type::drag_cache:
+    case Type::window_shadow:
+    case Type::distance_field:
+    case Type::layer:
+    case Type::glyph:          return PixelShaderPermutation::image;
+    default:                   return PixelShaderPermutation::generic;
+    }
+  }
 
   void set_color(glm::vec4 const& color) noexcept
   { 
@@ -86,6 +161,7 @@ struct ShapeProperty
   void set_thickness(float thickness) noexcept { _data[5] = std::bit_cast<uint32_t>(thickness); }
   void set_operator(Operator op)      noexcept { _data[6] = std::bit_cast<uint32_t>(op);        }
   void set_flags(Flag flags)          noexcept { _data[7] = std::bit_cast<uint32_t>(flags);     }
+  void set_value(uint32_t index, uint32_t value) noexcept { _data[8 + index] = value; }
 
 private:
   std::vector<uint32_t> _data{};
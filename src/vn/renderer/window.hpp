@@ -27,11 +27,17 @@ enum class MouseState
   left_button_up,
 };
 
+// small integer id of window shared by window manager, ui and renderer, 0 is invalid
+// ids are reused after windows destroyed, hash generation of window with it when state must not outlive window
+using WindowId = uint32_t;
+
 struct Window
 {
   friend LRESULT CALLBACK wnd_proc(HWND handle, UINT msg, WPARAM w_param, LPARAM l_param) noexcept;
   friend class MessageQueue;
 
+  WindowId          id{};
+  uint32_t          generation{}; // unique to every created window
   HWND              handle{};
   std::string       name{};
   int               x{};
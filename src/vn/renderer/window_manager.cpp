@@ -1,12 +1,13 @@
 #include "window_manager.hpp"
 #include "error_handling.hpp"
-#include "renderer.hpp"
 #include "message_queue.hpp"
 #include "../ui/ui_context.hpp"
 
 #include <dwmapi.h>
 #include <winuser.h>
 
+#include <algorithm>
+
 using namespace vn::renderer;
 
 namespace {
@@ -31,7 +32,6 @@ namespace vn { namespace renderer {
 LRESULT CALLBACK wnd_proc(HWND handle, UINT msg, WPARAM w_param, LPARAM l_param) noexcept
 {
   static auto wm        = WindowManager::instance();
-  static auto renderer  = Renderer::instance();
   static auto msg_queue = MessageQueue::instance();
   static auto ui_ctx    = ui::UIContext::instance();
 
@@ -40,10 +40,21 @@ LRESULT CALLBACK wnd_proc(HWND handle, UINT msg, WPARAM w_param, LPARAM l_param)
   static auto lm_down_resize_type = Window::ResizeType{};
   static auto lm_down_pos        = glm::vec<2, int>{};
 
+  // window is unregistered before destroying, so process it before translating handle
+  if (msg == static_cast<uint32_t>(WindowManager::Message::window_destroy))
+  {
+    DestroyWindow(handle);
+    return 0;
+  }
+
+  // handle only be translated to id on the boundary of os messages
+  // and unregistered window (e.g. in creating) uses default process
+  auto id = wm->get_window_id(handle);
+  if (!id) return DefWindowProcW(handle, msg, w_param, l_param);
+
   auto finish_window_moving_or_resizing = [&]
   {
-    if (!wm->_windows.contains(handle)) return;
-    auto& window = wm->_windows.at(handle);
+    auto& window = wm->_windows[id];
     if (window.mouse_state == MouseState::left_button_down || window.mouse_state == MouseState::left_button_press)
     {
       ReleaseCapture();
@@ -57,7 +68,7 @@ LRESULT CALLBACK wnd_proc(HWND handle, UINT msg, WPARAM w_param, LPARAM l_param)
         {
           window.need_resize_window = false;
           SetWindowPos(handle, 0, window.real_x(), window.real_y(), window.real_width(), window.real_height(), SWP_NOZORDER | SWP_NOACTIVATE);
-          renderer->resize_window(handle, window.real_width(), window.real_height());
+          msg_queue->send_message(MessageQueue::Message_Resize_Window{ id, window.real_width(), window.real_height() });
         }
         else
           SetWindowPos(handle, 0, window.real_x(), window.real_y(), 0, 0, SWP_NOSIZE | SWP_NOZORDER | SWP_NOACTIVATE);
@@ -66,7 +77,7 @@ LRESULT CALLBACK wnd_proc(HWND handle, UINT msg, WPARAM w_param, LPARAM l_param)
       else if (lm_down_resize_type != Window::ResizeType::none)
       {
         SetWindowPos(handle, 0, window.real_x(), window.real_y(), window.real_width(), window.real_height(), SWP_NOZORDER | SWP_NOACTIVATE);
-        renderer->resize_window(handle, window.real_width(), window.real_height());
+        msg_queue->send_message(MessageQueue::Message_Resize_Window{ id, window.real_width(), window.real_height() });
         PostMessageW(handle, static_cast<int>(WindowManager::Message::window_moving_or_resizing_finish), 0, 0);
       }
     }
@@ -88,26 +99,40 @@ LRESULT CALLBACK wnd_proc(HWND handle, UINT msg, WPARAM w_param, LPARAM l_param)
   case WM_CLOSE:
   {
     ShowWindow(handle, SW_HIDE);
-    msg_queue->send_message(MessageQueue::Message_Destroy_Window_Render_Resource{ handle });
-    ui_ctx->windows.erase(handle);
-    wm->_windows.erase(handle);
-    wm->_using_mouse_pass_through_windows.erase(handle);
+    msg_queue->send_message(MessageQueue::Message_Destroy_Window_Render_Resource{ id });
+    ui_ctx->destroy_window(id);
+    wm->destroy_window(id);
     return 0;
   }
 
+  case WM_ACTIVATE:
+  {
+    // activated window is brought to top of own windows
+    if (LOWORD(w_param) != WA_INACTIVE)
+      wm->_z_order.raise(id);
+    break;
+  }
+
+  case WM_WINDOWPOSCHANGED:
+  {
+    if (auto pos = reinterpret_cast<WINDOWPOS const*>(l_param); !(pos->flags & SWP_NOZORDER))
+      wm->update_z_order(id, pos->hwndInsertAfter);
+    break;
+  }
+
   case WM_LBUTTONDOWN:
   {
     SetCapture(handle);
     last_pos = get_cursor_pos();
-    lm_down_resize_type = wm->_windows.at(handle).get_resize_type(last_pos);
+    lm_down_resize_type = wm->_windows[id].get_resize_type(last_pos);
     lm_down_pos = last_pos;
-    wm->_windows.at(handle).mouse_state = MouseState::left_button_down;
+    wm->_windows[id].mouse_state = MouseState::left_button_down;
     break;
   }
 
   case static_cast<int>(WindowManager::Message::left_button_press):
   {
-    wm->_windows.at(handle).mouse_state = MouseState::left_button_press;
+    wm->_windows[id].mouse_state = MouseState::left_button_press;
     return 0;
   }
 
@@ -117,11 +142,20 @@ LRESULT CALLBACK wnd_proc(HWND handle, UINT msg, WPARAM w_param, LPARAM l_param)
     break;
   }
 
+  case WM_MOUSEWHEEL:
+  {
+    // wheel is sent to focused window, scroll the one under cursor
+    auto target = ui_ctx->mouse_on_window ? ui_ctx->mouse_on_window : id;
+    if (ui_ctx->windows.contains(target))
+      ui_ctx->windows[target].wheel_notches += static_cast<float>(GET_WHEEL_DELTA_WPARAM(w_param)) / WHEEL_DELTA;
+    return 0;
+  }
+
   case WM_MOUSEMOVE:
   {
     // set cursor if can resize
     auto  cursor_pos = get_cursor_pos();
-    auto& window     = wm->_windows.at(handle);
+    auto& window     = wm->_windows[id];
 
     // update cursor type
     if (auto type = window.get_resize_type(cursor_pos);
@@ -137,7 +171,8 @@ LRESULT CALLBACK wnd_proc(HWND handle, UINT msg, WPARAM w_param, LPARAM l_param)
       auto style = GetWindowLong(handle, GWL_EXSTYLE);
       SetWindowLongPtrA(handle, GWL_EXSTYLE, style | WS_EX_TRANSPARENT | WS_EX_LAYERED);
       window.is_mouse_pass_through = true;
-      wm->_using_mouse_pass_through_windows.emplace(handle);
+      if (std::ranges::find(wm->_using_mouse_pass_through_windows, id) == wm->_using_mouse_pass_through_windows.end())
+        wm->_using_mouse_pass_through_windows.emplace_back(id);
     }
 
     // move or resize window
@@ -160,7 +195,7 @@ LRESULT CALLBACK wnd_proc(HWND handle, UINT msg, WPARAM w_param, LPARAM l_param)
             ClipCursor(&rect);
             while (ShowCursor(false) >= 0);
             window.is_maximized ? window.move_from_maximize(cursor_pos.x, cursor_pos.y) : window.move(offset_x, offset_y);
-            ui_ctx->windows[handle].need_clear = true;
+            ui_ctx->windows[id].need_clear = true;
           }
       }
       // window resizing
@@ -171,12 +206,12 @@ LRESULT CALLBACK wnd_proc(HWND handle, UINT msg, WPARAM w_param, LPARAM l_param)
           auto rect = get_maximize_rect();
           ClipCursor(&rect);
           while (ShowCursor(false) >= 0);
-          ui_ctx->windows[handle].need_clear = true;
+          ui_ctx->windows[id].need_clear = true;
         }
         window.adjust_offset(lm_down_resize_type, cursor_pos, offset_x, offset_y);
         window.resize(lm_down_resize_type, offset_x, offset_y);
       }
-      msg_queue->send_message(MessageQueue::Message_Update_Window{ window });
+      msg_queue->send_message(MessageQueue::Message_Update_Window::from(window));
       last_pos = cursor_pos;
     }
     break;
@@ -184,9 +219,7 @@ LRESULT CALLBACK wnd_proc(HWND handle, UINT msg, WPARAM w_param, LPARAM l_param)
 
   case WM_SIZE:
   {
-    if (!wm->_windows.contains(handle)) break;
-
-    auto& window = wm->_windows.at(handle);
+    auto& window = wm->_windows[id];
 
     if (w_param == SIZE_MINIMIZED)
     {
@@ -195,9 +228,9 @@ LRESULT CALLBACK wnd_proc(HWND handle, UINT msg, WPARAM w_param, LPARAM l_param)
     else if (w_param == SIZE_MAXIMIZED)
     {
       window.maximize();
-      msg_queue->send_message(MessageQueue::Message_Update_Window{ window });
+      msg_queue->send_message(MessageQueue::Message_Update_Window::from(window));
       SetWindowPos(handle, 0, window.real_x(), window.real_y(), window.real_width(), window.real_height(), SWP_NOZORDER | SWP_NOACTIVATE);
-      renderer->resize_window(handle, window.real_width(), window.real_width());
+      msg_queue->send_message(MessageQueue::Message_Resize_Window{ id, window.real_width(), window.real_height() });
       return 0;
     }
     else if (w_param == SIZE_RESTORED)
@@ -211,27 +244,28 @@ LRESULT CALLBACK wnd_proc(HWND handle, UINT msg, WPARAM w_param, LPARAM l_param)
 
   case static_cast<uint32_t>(WindowManager::Message::mouse_idle):
   {
-    wm->_windows.at(handle).mouse_state = MouseState::idle;
+    wm->_windows[id].mouse_state = MouseState::idle;
     return 0;
   }
 
   case static_cast<uint32_t>(WindowManager::Message::window_restore_from_maximize):
   {
-    auto& window = wm->_windows.at(handle);
+    auto& window = wm->_windows[id];
     window.restore();
-    msg_queue->send_message(MessageQueue::Message_Update_Window{ window });
+    msg_queue->send_message(MessageQueue::Message_Update_Window::from(window));
     SetWindowPos(handle, 0, window.real_x(), window.real_y(), window.real_width(), window.real_height(), SWP_NOZORDER | SWP_NOACTIVATE);
-    renderer->resize_window(handle, window.real_width(), window.real_width());
+    msg_queue->send_message(MessageQueue::Message_Resize_Window{ id, window.real_width(), window.real_height() });
     return 0;
   }
 
   case static_cast<uint32_t>(WindowManager::Message::window_moving_or_resizing_finish):
   {
-    auto& window = wm->_windows.at(handle);
+    auto& window = wm->_windows[id];
     window.moving      = false;
     window.resizing    = false;
     window.cursor_type = {};
-    ui_ctx->moving_or_resizing_finish_window = handle;
+    msg_queue->send_message(MessageQueue::Message_Update_Window::from(window));
+    ui_ctx->moving_or_resizing_finish_window = id;
     return 0;
   }
 
@@ -261,9 +295,7 @@ void WindowManager::init() noexcept
   ShowWindow(handle, SW_SHOW);
 
   // create fullscreen window render resource
-  auto window = Window{};
-  window.init(handle, "", 0, 0, screen_size.x, screen_size.y);
-  MessageQueue::instance()->send_message(MessageQueue::Message_Create_Fullscreen_Render_Resource{ window });
+  MessageQueue::instance()->send_message(MessageQueue::Message_Create_Fullscreen_Render_Resource{ handle, screen_size.x, screen_size.y });
 }
 
 void WindowManager::message_process() noexcept
@@ -275,67 +307,90 @@ void WindowManager::message_process() noexcept
     DispatchMessageW(&msg);
   }
 
-  for (auto& [handle, window] : _windows)
+  for (auto& window : _windows)
   {
     // clear last frame window dynamic data
     window.move_invalid_area.clear();
 
     // send WM_LBUTTONDOWN again, to change mouse state to press
     if (window.mouse_state == MouseState::left_button_down)
-      PostMessageW(handle, static_cast<int>(Message::left_button_press), 0, 0);
+      PostMessageW(window.handle, static_cast<int>(Message::left_button_press), 0, 0);
     else if (window.mouse_state == MouseState::left_button_up)
-      PostMessageW(handle, static_cast<int>(Message::mouse_idle), 0, 0);
+      PostMessageW(window.handle, static_cast<int>(Message::mouse_idle), 0, 0);
   }
 
-  for (auto it = _using_mouse_pass_through_windows.begin(); it != _using_mouse_pass_through_windows.end();)
+  std::erase_if(_using_mouse_pass_through_windows, [this](auto id)
   {
-    auto handle = *it;
-    if (!_windows.at(handle).is_mouse_pass_through_area())
-    {
-      SetWindowLongPtrA(handle, GWL_EXSTYLE, GetWindowLong(handle, GWL_EXSTYLE) & ~(WS_EX_TRANSPARENT | WS_EX_LAYERED));
-      it = _using_mouse_pass_through_windows.erase(it);
-    }
-    else
-      ++it;
-  }
+    auto const& window = _windows[id];
+    if (window.is_mouse_pass_through_area()) return false;
+    SetWindowLongPtrA(window.handle, GWL_EXSTYLE, GetWindowLong(window.handle, GWL_EXSTYLE) & ~(WS_EX_TRANSPARENT | WS_EX_LAYERED));
+    return true;
+  });
 }
 
-auto WindowManager::create_window(std::string_view name, int x, int y, uint32_t width, uint32_t height) noexcept -> HWND
+auto WindowManager::create_window(std::string_view name, int x, int y, uint32_t width, uint32_t height) noexcept -> WindowId
 {
-  auto window = Window{};
+  auto id = _id_allocator.alloc();
+  auto& window = _windows.emplace(id);
   window.init(0, name.data(), x, y, width, height);
+  window.id         = id;
+  window.generation = ++_window_generation;
 
   window.handle = CreateWindowExW(WS_EX_NOREDIRECTIONBITMAP, Window_Class, nullptr, WS_POPUP | WS_MINIMIZEBOX,
     window.real_x(), window.real_y(), window.real_width(), window.real_height(), 0, 0, GetModuleHandleW(nullptr), 0);
   err_if(!window.handle,  "failed to create window");
+
+  MessageQueue::instance()->send_message(MessageQueue::Message_Create_Window_Render_Resource{ id, window.handle, window.x, window.y, window.width, window.height, true });
+
+  _window_ids.emplace(window.handle, id);
+  _z_order.raise(id);
   ShowWindow(window.handle, SW_SHOW); // TODO: show after first frame render finish and also include some images uploaded finish
 
-  _windows.emplace(window.handle, window);
+  return id;
+}
 
-  MessageQueue::instance()->send_message(MessageQueue::Message_Create_Window_Render_Resource{ window, true });
+void WindowManager::destroy_window(WindowId id) noexcept
+{
+  _window_ids.erase(_windows[id].handle);
+  _windows.erase(id);
+  std::erase(_using_mouse_pass_through_windows, id);
+  _z_order.erase(id);
+  _id_allocator.free(id);
+}
 
-  return window.handle;
+auto WindowManager::get_window_name(WindowId id) noexcept -> std::string
+{
+  err_if(!_windows.contains(id), "failed to get name of window");
+  return _windows[id].name;
 }
 
-auto WindowManager::get_window_name(HWND handle) noexcept -> std::string
+void WindowManager::update_z_order(WindowId id, HWND insert_after) noexcept
 {
-  err_if(!_windows.contains(handle), "failed to get name of window");
-  return _windows.at(handle).name;
+  // own windows are not topmost, so topmost and no topmost both mean top of own windows
+  if (insert_after == HWND_TOP || insert_after == HWND_TOPMOST || insert_after == HWND_NOTOPMOST)
+    _z_order.raise(id);
+  else if (insert_after == HWND_BOTTOM)
+    _z_order.lower(id);
+  else if (auto above = get_window_id(insert_after))
+    _z_order.place_under(id, above);
+  else
+    // under a foreign window, where it is between own windows is unknown
+    sync_z_order();
 }
 
-auto WindowManager::get_window_z_orders() const noexcept -> std::vector<HWND>
+void WindowManager::sync_z_order() noexcept
 {
-  auto handles = std::vector<HWND>();
-  handles.reserve(_windows.size());
+  auto ids = std::vector<WindowId>();
+  ids.reserve(_windows.size());
 
   auto top = GetTopWindow(nullptr);
   while (top)
   {
-    if (_windows.contains(top)) handles.emplace_back(top);
+    if (auto id = get_window_id(top)) ids.emplace_back(id);
     top = GetWindow(top, GW_HWNDNEXT);
   }
 
-  return handles;
+  _z_order.assign(std::move(ids));
 }
 
 }}
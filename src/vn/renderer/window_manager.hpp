@@ -1,9 +1,10 @@
 #pragma once
 
 #include "window.hpp"
+#include "z_order.hpp"
+#include "../dense_map.hpp"
 
 #include <unordered_map>
-#include <unordered_set>
 
 namespace vn { namespace ui {
 
@@ -62,22 +63,46 @@ public:
     mouse_idle,
     window_restore_from_maximize,
     window_moving_or_resizing_finish,
-    window_resizing_finish
+    window_resizing_finish,
+    window_destroy,
   };
   void message_process() noexcept;
 
-  auto create_window(std::string_view name, int x, int y, uint32_t width, uint32_t height) noexcept -> HWND;
+  auto create_window(std::string_view name, int x, int y, uint32_t width, uint32_t height) noexcept -> WindowId;
 
   auto window_count() const noexcept { return _windows.size(); }
 
-  auto get_window_name(HWND handle) noexcept -> std::string;
-  auto get_window(HWND handle) const noexcept { return _windows.at(handle); }
+  auto get_window_name(WindowId id) noexcept -> std::string;
+  auto get_window(WindowId id) const noexcept { return _windows.at(id); }
 
-  auto get_window_z_orders() const noexcept -> std::vector<HWND>;
+  /// only used on the boundary of os messages, return 0 if window is not exist
+  auto get_window_id(HWND handle) const noexcept -> WindowId
+  {
+    auto it = _window_ids.find(handle);
+    return it != _window_ids.end() ? it->second : WindowId{};
+  }
+
+  /// top-most window under point of screen, z order is kept by messages so no os calls
+  auto get_window_on(glm::vec<2, int> const& p) const noexcept -> WindowId
+  {
+    return _z_order.find([&](auto id) { return _windows[id].point_on(p); });
+  }
+
+private:
+  void destroy_window(WindowId id) noexcept;
+
+  /// move window in z order by insert after handle of WINDOWPOS
+  void update_z_order(WindowId id, HWND insert_after) noexcept;
+  /// walk windows of desktop once, only when order of own windows is not able to be known from message
+  void sync_z_order() noexcept;
 
 private:
-  std::unordered_map<HWND, Window> _windows;
-  std::unordered_set<HWND>         _using_mouse_pass_through_windows;
+  IdAllocator                        _id_allocator;
+  uint32_t                           _window_generation{};
+  DenseMap<Window>                   _windows;
+  std::unordered_map<HWND, WindowId> _window_ids;
+  std::vector<WindowId>              _using_mouse_pass_through_windows;
+  ZOrder                             _z_order;
 };
 
 }}
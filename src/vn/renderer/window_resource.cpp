@@ -3,14 +3,33 @@
 #include "config.hpp"
 #include "core.hpp"
 #include "error_handling.hpp"
+#include "../util.hpp"
 
 #include <dwmapi.h>
 
 #include <algorithm>
 #include <ranges>
+#include <utility>
+#include <chrono>
+#include <cmath>
+#include <assert.h>
 
 using namespace Microsoft::WRL;
 
+namespace {
+
+auto to_rect(vn::ui::DirtyRect const& rect) noexcept
+{
+  return RECT{ rect.left, rect.top, rect.right, rect.bottom };
+}
+
+auto to_dirty_rect(RECT const& rect) noexcept
+{
+  return vn::ui::DirtyRect{ static_cast<int32_t>(rect.left), static_cast<int32_t>(rect.top), static_cast<int32_t>(rect.right), static_cast<int32_t>(rect.bottom) };
+}
+
+}
+
 namespace vn { namespace renderer {
 
 void SwapchainResource::init(HWND handle, uint32_t width, uint32_t height, bool is_transparent) noexcept
@@ -32,7 +51,7 @@ void SwapchainResource::init(HWND handle, uint32_t width, uint32_t height, bool
   swapchain_desc.Height           = height;
   swapchain_desc.Format           = dxgi_format(Image_Format);
   swapchain_desc.BufferUsage      = DXGI_USAGE_RENDER_TARGET_OUTPUT;
-  swapchain_desc.SwapEffect       = DXGI_SWAP_EFFECT_FLIP_DISCARD;
+  swapchain_desc.SwapEffect       = DXGI_SWAP_EFFECT_FLIP_SEQUENTIAL; // keep content of back buffers for partial redraw
   swapchain_desc.SampleDesc.Count = 1;
   swapchain_desc.Flags            = DXGI_SWAP_CHAIN_FLAG_FRAME_LATENCY_WAITABLE_OBJECT | DXGI_SWAP_CHAIN_FLAG_ALLOW_TEARING;
   if (is_transparent)
@@ -86,17 +105,13 @@ void SwapchainResource::destroy() noexcept
 
 void SwapchainResource::resize(uint32_t width, uint32_t height) noexcept
 {
-  auto core     = Core::instance();
   auto renderer = Renderer::instance();
 
   // set viewport and scissor
   viewport = CD3DX12_VIEWPORT{ 0.f, 0.f, static_cast<float>(width), static_cast<float>(height) };
   scissor  = CD3DX12_RECT{     0,   0,   static_cast<LONG>(width),  static_cast<LONG>(height)  };
 
-  // wait gpu finish
-  core->wait_gpu_complete();
-
-  // reset swapchain relation resources
+  // reset swapchain relation resources, caller promises gpu finished using them
   std::ranges::for_each(swapchain_images, [](auto& image) { image.destroy(); });
   if (is_transparent)
     _comp_visual->SetContent(nullptr);
@@ -121,6 +136,40 @@ void SwapchainResource::resize(uint32_t width, uint32_t height) noexcept
     dsv_image.resize(width, height);
 }
 
+void DragCache::reserve(uint32_t width, uint32_t height) noexcept
+{
+  if (target.valid())
+  {
+    auto extent = g_image_pool[target].extent();
+    if (extent.x >= width && extent.y >= height) return;
+    width  = std::max(width,  extent.x);
+    height = std::max(height, extent.y);
+    release();
+  }
+
+  width  = align(width,  Granularity);
+  height = align(height, Granularity);
+  target  = g_image_pool.alloc();
+  texture = g_image_pool.alloc();
+  g_image_pool[target].init(ImageType::rtv,  SwapchainResource::Image_Format, width, height);
+  g_image_pool[texture].init(ImageType::srv, SwapchainResource::Image_Format, width, height);
+  if (Renderer::instance()->enable_depth_test)
+  {
+    depth = g_image_pool.alloc();
+    g_image_pool[depth].init(ImageType::dsv, ImageFormat::d32, width, height);
+  }
+}
+
+void DragCache::release() noexcept
+{
+  if (!target.valid()) return;
+  auto renderer = Renderer::instance();
+  renderer->retire(std::exchange(target,  {}));
+  renderer->retire(std::exchange(texture, {}));
+  if (depth.valid())
+    renderer->retire(std::exchange(depth, {}));
+}
+
 void WindowResource::init(Window const& window, bool transparent) noexcept
 {
   auto core   = Core::instance();
@@ -128,7 +177,7 @@ void WindowResource::init(Window const& window, bool transparent) noexcept
 
   // initialize swapchain resource
   this->window = window;
-  swapchain_resource.init(window.handle, window.real_width(), window.real_width(), transparent);
+  swapchain_resource.init(window.handle, window.real_width(), window.real_height(), transparent);
 
   // create frame resources
   for (auto& frame_resource : frame_resources)
@@ -145,14 +194,64 @@ void WindowResource::init(Window const& window, bool transparent) noexcept
   err_if(device->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT, frame_resources[0].cmd_alloc.Get(), nullptr, IID_PPV_ARGS(&cmd)),
           "failed to create command list");
   err_if(cmd->Close(), "failed to close command list");
+
+  // create pipeline statistics queries and their readback
+  if (Renderer::instance()->enable_overdraw_stats)
+  {
+    auto query_heap_desc = D3D12_QUERY_HEAP_DESC{};
+    query_heap_desc.Type  = D3D12_QUERY_HEAP_TYPE_PIPELINE_STATISTICS;
+    query_heap_desc.Count = Frame_Count;
+    err_if(device->CreateQueryHeap(&query_heap_desc, IID_PPV_ARGS(&query_heap)), "failed to create query heap");
+    auto heap_properties = CD3DX12_HEAP_PROPERTIES{ D3D12_HEAP_TYPE_READBACK };
+    auto buffer_desc     = CD3DX12_RESOURCE_DESC::Buffer(sizeof(D3D12_QUERY_DATA_PIPELINE_STATISTICS) * Frame_Count);
+    err_if(device->CreateCommittedResource(&heap_properties, D3D12_HEAP_FLAG_NONE, &buffer_desc, D3D12_RESOURCE_STATE_COPY_DEST, nullptr, IID_PPV_ARGS(&query_readback)),
+            "failed to create query readback buffer");
+    err_if(query_readback->Map(0, nullptr, reinterpret_cast<void**>(const_cast<D3D12_QUERY_DATA_PIPELINE_STATISTICS**>(&query_results))),
+            "failed to map query readback buffer");
+  }
+
+  damage_all();
 }
 
 void WindowResource::destroy() noexcept
 {
+  if (resize_stats.count)
+    info("[WindowResource] resized {} times, blocked {:.2f} ms in total, {:.2f} ms at most",
+         resize_stats.count, resize_stats.total_wait.count(), resize_stats.max_wait.count());
+  if (overdraw_stats.pixel_count)
+    info("[WindowResource] {:.2f} pixel shader invocations per redrawn pixel over {} frames",
+         static_cast<double>(overdraw_stats.ps_invocations) / overdraw_stats.pixel_count, overdraw_stats.frame_count);
+
   swapchain_resource.destroy();
   std::ranges::for_each(frame_resources, [](auto& frame) { frame.buffer.destroy(); });
 }
 
+void WindowResource::resize(uint32_t width, uint32_t height) noexcept
+{
+  // back buffers can only be resized after all references are released,
+  // only frames of this window reference them, so other windows keep running on gpu
+  auto beg = std::chrono::steady_clock::now();
+  wait_all_frames_render_finish();
+  auto wait = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - beg);
+  ++resize_stats.count;
+  resize_stats.total_wait += wait;
+  resize_stats.max_wait    = std::max(resize_stats.max_wait, wait);
+
+  swapchain_resource.resize(width, height);
+  damage_all();
+}
+
+void WindowResource::wait_all_frames_render_finish() const noexcept
+{
+  auto core        = Core::instance();
+  auto fence_value = std::ranges::max(frame_resources | std::views::transform([](auto const& frame) { return frame.fence_value; }));
+  if (core->fence()->GetCompletedValue() < fence_value)
+  {
+    err_if(core->fence()->SetEventOnCompletion(fence_value, core->fence_event()), "failed to set event on completion");
+    WaitForSingleObjectEx(core->fence_event(), INFINITE, false);
+  }
+}
+
 void WindowResource::wait_current_frame_render_finish() const noexcept
 {
   auto        core           = Core::instance();
@@ -194,11 +293,7 @@ void WindowResource::clear_window() noexcept
   // clear color
   swapchain_image->clear_render_target(cmd.Get());
   if (renderer->enable_depth_test)
-  {
     cmd->ClearDepthStencilView(dsv_handle, D3D12_CLEAR_FLAG_DEPTH, 1.f, 0, 0, nullptr);
-    // set depth range
-    cmd->OMSetDepthBounds(0.f, 1.f);
-  }
 
   // record finish, change render target view type to present
   swapchain_image->set_state(cmd.Get(), ImageState::present);
@@ -208,17 +303,84 @@ void WindowResource::clear_window() noexcept
 
   // move to next frame resource
   frame_index = (frame_index + 1) % Frame_Count;
+
+  // cleared back buffer is presented whole, others still have old content
+  present_rects.clear();
+  skip_present = false;
+  damage_all();
 }
 
-void WindowResource::render(std::span<Vertex const> vertices, std::span<uint16_t const> indices, std::span<ShapeProperty const> shape_properties, std::optional<Window> fullscreen_target_window) noexcept
+void WindowResource::damage(std::span<ui::DirtyRect const> rects) noexcept
+{
+  auto bounds = to_dirty_rect(swapchain_resource.scissor);
+  auto offset = static_cast<int32_t>(Window_Shadow_Thickness);
+
+  present_rects.clear();
+  for (auto const& rect : rects)
+  {
+    auto r = ui::DirtyRect{ rect.left + offset, rect.top + offset, rect.right + offset, rect.bottom + offset }.intersect(bounds);
+    if (!r.empty()) present_rects.emplace_back(r);
+  }
+
+  for (auto& damage : damages)
+  {
+    damage.append_range(present_rects);
+    ui::merge_rects(damage, ui::DirtyTracker::Max_Rect_Count);
+  }
+}
+
+void WindowResource::damage_all() noexcept
+{
+  for (auto& damage : damages)
+    damage = { to_dirty_rect(swapchain_resource.scissor) };
+  redraw_all = true;
+}
+
+void WindowResource::render(std::span<Vertex const> vertices, std::span<uint16_t const> indices, std::span<ShapeProperty const> shape_properties, std::span<DrawBatch const> batches, std::optional<Window> fullscreen_target_window, bool capture_drag_cache) noexcept
 {
   auto  core            = Core::instance();
   auto  renderer        = Renderer::instance();
   auto& frame_resource  = frame_resources[frame_index];
   auto  swapchain_image = swapchain_resource.current_image();
 
+  // window redraws damage of current back buffer, and neither draws nor presents if nothing changed
+  auto rects = std::vector<RECT>{};
+  if (!fullscreen_target_window.has_value())
+  {
+    if (std::exchange(redraw_all, false))
+      present_rects = { to_dirty_rect(swapchain_resource.scissor) };
+    else if (present_rects.empty())
+    {
+      skip_present = true;
+      return;
+    }
+    auto& damage = damages[swapchain_resource.swapchain->GetCurrentBackBufferIndex()];
+    rects.append_range(damage | std::views::transform(to_rect));
+    damage.clear();
+  }
+  skip_present = false;
+
   wait_current_frame_render_finish();
 
+  // statistics of last frame on this frame resource are resolved now
+  if (query_heap)
+  {
+    if (frame_resource.pixel_count)
+    {
+      overdraw_stats.ps_invocations += query_results[frame_index].PSInvocations;
+      overdraw_stats.pixel_count    += std::exchange(frame_resource.pixel_count, {});
+      ++overdraw_stats.frame_count;
+    }
+    auto area = [](RECT const& rect) { return static_cast<uint64_t>(rect.right - rect.left) * (rect.bottom - rect.top); };
+    if (fullscreen_target_window.has_value())
+      frame_resource.pixel_count = area(fullscreen_target_window->real_rect());
+    else if (rects.empty())
+      frame_resource.pixel_count = area(swapchain_resource.scissor);
+    else
+      for (auto const& rect : rects)
+        frame_resource.pixel_count += area(rect);
+  }
+
   // reset command
   err_if(frame_resource.cmd_alloc->Reset() == E_FAIL, "failed to reset command allocator");
   err_if(cmd->Reset(frame_resource.cmd_alloc.Get(), nullptr), "failed to reset command list");
@@ -226,9 +388,34 @@ void WindowResource::render(std::span<Vertex const> vertices, std::span<uint16_t
   // set descriptor heaps
   DescriptorHeapManager::instance()->bind_heaps(cmd.Get());
 
+  if (query_heap)
+    cmd->BeginQuery(query_heap.Get(), D3D12_QUERY_TYPE_PIPELINE_STATISTICS, frame_index);
+
+  // upload data to buffer
+  frame_resources[frame_index].buffer.clear().upload(cmd.Get(), vertices, indices, shape_properties);
+
+  // shadow batches lead, they are out of content so are not captured into drag cache
+  auto shadow_count   = std::ranges::find_if(batches, [](auto const& batch) { return !batch.window_shadow; }) - batches.begin();
+  auto shadow_batches = batches.first(shadow_count);
+  batches = batches.subspan(shadow_count);
+
+  // capture content before drag cache quad, fullscreen only blits drag cache and draws cursor after it
+  if (capture_drag_cache)
+  {
+    auto drag_cache = std::ranges::find_if(batches, &DrawBatch::drag_cache) - batches.begin();
+    assert(drag_cache < static_cast<ptrdiff_t>(batches.size()));
+    drag_cache_render(batches.first(drag_cache), *fullscreen_target_window);
+    batches = batches.subspan(drag_cache);
+  }
+
   // render
-  window_content_render(swapchain_image, vertices, indices, shape_properties, fullscreen_target_window);
-  // window_shadow_render(cmd);
+  window_content_render(swapchain_image, shadow_batches, batches, fullscreen_target_window, rects);
+
+  if (query_heap)
+  {
+    cmd->EndQuery(query_heap.Get(), D3D12_QUERY_TYPE_PIPELINE_STATISTICS, frame_index);
+    cmd->ResolveQueryData(query_heap.Get(), D3D12_QUERY_TYPE_PIPELINE_STATISTICS, frame_index, 1, query_readback.Get(), sizeof(D3D12_QUERY_DATA_PIPELINE_STATISTICS) * frame_index);
+  }
 
   // record finish, change render target view type to present
   swapchain_image->set_state(cmd.Get(), ImageState::present);
@@ -242,12 +429,24 @@ void WindowResource::render(std::span<Vertex const> vertices, std::span<uint16_t
 
 void WindowResource::present(bool vsync) const noexcept
 {
+  // vsync present paces the render loop, so wait composition rather than spinning when nothing changed
+  if (skip_present)
+  {
+    if (vsync) DwmFlush();
+    return;
+  }
+
+  // only changed rects are told to compositor, rest of back buffer is same as last presented one
+  auto rects  = std::vector<RECT>{ std::from_range, present_rects | std::views::transform(to_rect) };
+  auto params = DXGI_PRESENT_PARAMETERS{};
+  params.DirtyRectsCount = static_cast<UINT>(rects.size());
+  params.pDirtyRects     = rects.empty() ? nullptr : rects.data();
   vsync
-    ? err_if(swapchain_resource.swapchain->Present(1, 0), "failed to present swapchain")
-    : err_if(swapchain_resource.swapchain->Present(0, DXGI_PRESENT_ALLOW_TEARING), "failed to present swapchain");
+    ? err_if(swapchain_resource.swapchain->Present1(1, 0, &params), "failed to present swapchain")
+    : err_if(swapchain_resource.swapchain->Present1(0, DXGI_PRESENT_ALLOW_TEARING, &params), "failed to present swapchain");
 }
 
-void WindowResource::window_content_render(Image* render_target_image, std::span<Vertex const> vertices, std::span<uint16_t const> indices, std::span<ShapeProperty const> shape_properties, std::optional<Window> fullscreen_target_window) noexcept
+void WindowResource::window_content_render(Image* render_target_image, std::span<DrawBatch const> shadow_batches, std::span<DrawBatch const> batches, std::optional<Window> fullscreen_target_window, std::span<RECT const> rects) noexcept
 {
   auto renderer   = Renderer::instance();
   auto rtv_handle = render_target_image->cpu_handle();
@@ -262,118 +461,110 @@ void WindowResource::window_content_render(Image* render_target_image, std::span
     cmd->OMSetRenderTargets(1, &rtv_handle, false, nullptr);
 
   // clear color
-  render_target_image->clear_render_target(cmd.Get());
+  render_target_image->clear_render_target(cmd.Get(), rects);
   if (renderer->enable_depth_test)
-  {
-    cmd->ClearDepthStencilView(dsv_handle, D3D12_CLEAR_FLAG_DEPTH, 1.f, 0, 0, nullptr);
-    // set depth range
-    cmd->OMSetDepthBounds(0.f, 1.f);
-  }
-
-  // bind pipeline
-  renderer->_sdf_pipeline.bind(cmd.Get());
+    cmd->ClearDepthStencilView(dsv_handle, D3D12_CLEAR_FLAG_DEPTH, 1.f, 0, rects.size(), rects.empty() ? nullptr : rects.data());
 
   // set viewport
   cmd->RSSetViewports(1, &swapchain_resource.viewport);
 
-  // upload data to buffer
-  frame_resources[frame_index].buffer.clear().upload(cmd.Get(), vertices, indices, shape_properties);
-
   // set descriptors
   auto constants = Constants{};
-  constants.window_extent = render_target_image->extent();
-  constants.window_pos    = window.content_pos();
+  constants.window_extent              = render_target_image->extent();
+  constants.window_pos                 = window.content_pos();
+  constants.window_shadow_index        = g_image_pool[renderer->_window_shadow].index();
+  constants.distance_field_atlas_index = g_image_pool[renderer->_distance_field_atlas.texture].index();
+  constants.glyph_atlas_index          = g_image_pool[renderer->_glyph_atlas.texture].index();
   if (fullscreen_target_window.has_value())
   {
     constants.window_pos   = fullscreen_target_window->pos();
-    constants.cursor_index = g_image_pool[renderer->_cursors[fullscreen_target_window->cursor_type].handle].index();
+    constants.cursor_index = g_image_pool[renderer->_cursors.at(fullscreen_target_window->cursor_type).handle].index();
+    if (renderer->_drag_cache.texture.valid())
+    {
+      constants.drag_cache_index = g_image_pool[renderer->_drag_cache.texture].index();
+      constants.drag_cache_scale = renderer->_drag_cache.scale;
+    }
   }
-  renderer->_sdf_pipeline.set_descriptors(cmd.Get(), "constants", constants,
-  {
-    { "images", g_descriptor_heap_mgr.first_gpu_handle(DescriptorHeapType::cbv_srv_uav) },
-    { "buffer", frame_resources[frame_index].buffer.gpu_handle()                        },
-  });
 
   // draw
   if (fullscreen_target_window.has_value())
   {
+    auto real_rect = fullscreen_target_window->real_rect();
+    cmd->RSSetScissorRects(1, &real_rect);
+    draw_batches(shadow_batches, constants);
+
+    // last batch is the cursor
     cmd->RSSetScissorRects(1, &fullscreen_target_window->rect);
-    cmd->DrawIndexedInstanced(indices.size() - 6, 1, 0, 0, 0);
+    draw_batches(batches.first(batches.size() - 1), constants);
     auto rect = window.real_rect();
     cmd->RSSetScissorRects(1, &rect);
-    cmd->DrawIndexedInstanced(6, 1, indices.size() - 6, 0, 0);
+    draw_batches(batches.last(1), constants);
   }
   else
   {
-    auto rect = RECT{};
-    rect.left   = Window_Shadow_Thickness;
-    rect.top    = Window_Shadow_Thickness;
-    rect.right  = rect.left + window.width;
-    rect.bottom = rect.top  + window.height;
-    cmd->RSSetScissorRects(1, &rect);
-    cmd->DrawIndexedInstanced(indices.size(), 1, 0, 0, 0);
+    auto content_rect = RECT{};
+    content_rect.left   = Window_Shadow_Thickness;
+    content_rect.top    = Window_Shadow_Thickness;
+    content_rect.right  = content_rect.left + window.width;
+    content_rect.bottom = content_rect.top  + window.height;
+
+    // every redrawn rect draws all batches under its scissor, rects are few after merging
+    if (rects.empty()) rects = { static_cast<RECT const*>(&swapchain_resource.scissor), 1 };
+    for (auto const& rect : rects)
+    {
+      cmd->RSSetScissorRects(1, &rect);
+      draw_batches(shadow_batches, constants);
+
+      auto clip = RECT{};
+      if (!IntersectRect(&clip, &rect, &content_rect)) continue;
+      cmd->RSSetScissorRects(1, &clip);
+      draw_batches(batches, constants);
+    }
   }
 }
 
-void WindowResource::window_shadow_render(ID3D12GraphicsCommandList1* cmd) const noexcept
+void WindowResource::drag_cache_render(std::span<DrawBatch const> batches, Window const& target_window) noexcept
 {
-#if 0
-  auto renderer = Renderer::instance();
-
-  //
-  // first, generate window mask image
-  //
-
-  // clear mask image
-  copy(renderer->_uav_clear_heap, "window mask image", renderer->_cbv_srv_uav_heap, "window mask image");
-  renderer->_window_mask_image.clear(cmd, renderer->_uav_clear_heap.cpu_handle("window mask image"), renderer->_cbv_srv_uav_heap.gpu_handle("window mask image"));
-
-  // bind window mask pipeline
-  renderer->_window_mask_pipeline.bind(cmd);
-
-  // set descriptors
-  renderer->_window_mask_pipeline.set_descriptors(cmd,
-    "constants", glm::vec4(window.rect.left, window.rect.top, window.rect.right, window.rect.bottom),
-    {{ "window_mask_image", renderer->get_descriptor("window mask image") }});
-
-  // run pipeline
-  cmd->Dispatch((renderer->_window_mask_image.width() + 7) / 8, (renderer->_window_mask_image.height() + 7) / 8, 1);
-
-  //
-  // then, use window mask image as input of gaussian blur pipeline
-  //
-
-  return;
-
-  renderer->_window_shadow_pipeline.bind(cmd);
-  renderer->_window_shadow_pipeline.set_descriptors(cmd, "constants", glm::vec2(window.width, window.height), {{ "image", renderer->get_descriptor("window shadow image") }});
-  cmd->Dispatch((renderer->_window_shadow_image.width() + 7) / 8, (renderer->_window_shadow_image.height() + 7) / 8, 1);
-  if (window.is_moving_or_resizing())
+  auto  renderer = Renderer::instance();
+  auto& target   = g_image_pool[renderer->_drag_cache.target];
+  auto& texture  = g_image_pool[renderer->_drag_cache.texture];
+  auto  scale    = renderer->_drag_cache.scale;
+
+  // content is drawn at left top of target, images may be larger than scaled window
+  // depth image of swapchain may be smaller than target, so drag cache has its own one
+  auto rtv_handle = target.cpu_handle();
+  auto dsv_handle = D3D12_CPU_DESCRIPTOR_HANDLE{};
+  if (renderer->enable_depth_test)
   {
-    auto x      = window.x;
-    auto y      = window.y;
-    auto left   = uint32_t{};
-    auto top    = uint32_t{};
-    auto right  = window.width;
-    auto bottom = window.height;
-    if (window.x < 0)
-    {
-      x    = 0;
-      left = -window.x;
-    }
-    if (window.y < 0)
-    {
-      y   = 0;
-      top = -window.y;
-    }
-    copy(cmd, renderer->_window_shadow_image, left, top,
-      std::clamp(right,  0u, swapchain_image->width()  - window.x),
-      std::clamp(bottom, 0u, swapchain_image->height() - window.y),
-      *swapchain_image, x, y);
+    dsv_handle = g_image_pool[renderer->_drag_cache.depth].cpu_handle();
+    cmd->OMSetRenderTargets(1, &rtv_handle, false, &dsv_handle);
+    cmd->ClearDepthStencilView(dsv_handle, D3D12_CLEAR_FLAG_DEPTH, 1.f, 0, 0, nullptr);
   }
   else
-    copy(cmd, renderer->_window_shadow_image, *swapchain_image);
-#endif
+    cmd->OMSetRenderTargets(1, &rtv_handle, false, nullptr);
+  target.clear_render_target(cmd.Get());
+
+  // vertices are still mapped by extent of target, smaller viewport scales them down
+  auto viewport = CD3DX12_VIEWPORT{ 0.f, 0.f, target.width() * scale, target.height() * scale };
+  auto rect     = CD3DX12_RECT{ 0, 0, static_cast<LONG>(std::ceil(target_window.width * scale)), static_cast<LONG>(std::ceil(target_window.height * scale)) };
+  cmd->RSSetViewports(1, &viewport);
+  cmd->RSSetScissorRects(1, &rect);
+
+  auto constants = Constants{};
+  constants.window_extent              = target.extent();
+  constants.render_scale               = scale;
+  constants.distance_field_atlas_index = g_image_pool[renderer->_distance_field_atlas.texture].index();
+  constants.glyph_atlas_index          = g_image_pool[renderer->_glyph_atlas.texture].index();
+  draw_batches(batches, constants);
+
+  // only the region of window is valid
+  copy(cmd.Get(), target, 0, 0, rect.right, rect.bottom, texture);
+  texture.set_state(cmd.Get(), ImageState::pixel_shader_resource);
+}
+
+void WindowResource::draw_batches(std::span<DrawBatch const> batches, Constants const& constants) noexcept
+{
+  Renderer::instance()->draw_batches(cmd.Get(), frame_resources[frame_index].buffer.gpu_handle(), batches, constants);
 }
 
 }}
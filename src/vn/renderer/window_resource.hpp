@@ -5,12 +5,14 @@
 #include "window.hpp"
 #include "config.hpp"
 #include "buffer.hpp"
+#include "../ui/dirty_region.hpp"
 
 #include <dcomp.h>
 
 #include <array>
 #include <span>
 #include <optional>
+#include <chrono>
 
 namespace vn { namespace renderer {
 
@@ -41,6 +43,28 @@ public:
   void resize(uint32_t width, uint32_t height) noexcept;
 };
 
+/**
+ * content of moving or resizing window captured once, fullscreen rendering blits it at new position
+ * rather than drawing every shape of window again
+ * content is rendered into target then copied to texture which pixel shader reads
+ * images grow by granularity and never shrink during a drag, so resizing not reallocates every frame
+ * content can be captured at lower scale, then it is upscaled when blitting
+ */
+struct DragCache
+{
+  static constexpr auto Granularity = 128u;
+
+  ImageHandle target;
+  ImageHandle texture;
+  ImageHandle depth;   // only when depth test is enabled
+  float       scale{ 1.f }; // scale of captured content
+
+  /// make sure images are able to contain extent, old images are retired because gpu may still use them
+  void reserve(uint32_t width, uint32_t height) noexcept;
+  /// retire images, only call in render thread
+  void release() noexcept;
+};
+
 struct WindowResource
 {
   struct FrameResource
@@ -48,6 +72,7 @@ struct WindowResource
     FrameBuffer                                    buffer;
     Microsoft::WRL::ComPtr<ID3D12CommandAllocator> cmd_alloc;
     uint64_t                                       fence_value{};
+    uint64_t                                       pixel_count{}; // pixels redrawn by frame, not zero when its statistics query is pending
   };
 
   Window                                             window;
@@ -56,19 +81,61 @@ struct WindowResource
   std::array<FrameResource, Frame_Count>             frame_resources;
   Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList1> cmd;
 
+  // flip sequential back buffers keep their content, so only damage is redrawn
+  // damage of every back buffer is in swapchain coordinates and accumulated since the buffer was last drawn
+  std::array<std::vector<ui::DirtyRect>, Frame_Count> damages;
+  std::vector<ui::DirtyRect>                          present_rects; // changed rects of this frame, empty presents whole swapchain
+  bool                                                redraw_all{};
+  bool                                                skip_present{}; // nothing changed, neither drawn nor presented
+
   void init(Window const& window, bool transparent) noexcept;
   void destroy() noexcept;
 
-  void resize(uint32_t width, uint32_t height) noexcept { swapchain_resource.resize(width, height); }
+  /// how long resizing blocked render thread for waiting in flight frames of this window
+  struct ResizeStats
+  {
+    uint32_t                                  count{};
+    std::chrono::duration<float, std::milli> total_wait{};
+    std::chrono::duration<float, std::milli> max_wait{};
+  };
+  ResizeStats resize_stats;
+
+  /// pixel shader invocations against redrawn pixels, overdraw which depth test and culling remove
+  struct OverdrawStats
+  {
+    uint32_t frame_count{};
+    uint64_t ps_invocations{};
+    uint64_t pixel_count{};
+  };
+  OverdrawStats                                      overdraw_stats;
+  Microsoft::WRL::ComPtr<ID3D12QueryHeap>            query_heap;     // pipeline statistics query per frame resource, only with overdraw stats enabled
+  Microsoft::WRL::ComPtr<ID3D12Resource>             query_readback;
+  D3D12_QUERY_DATA_PIPELINE_STATISTICS const*        query_results{}; // persistently mapped readback
 
+  void resize(uint32_t width, uint32_t height) noexcept;
+
+  void wait_all_frames_render_finish() const noexcept;
   void wait_current_frame_render_finish() const noexcept;
 
   void clear_window() noexcept;
-  void render(std::span<Vertex const> vertices, std::span<uint16_t const> indices, std::span<ShapeProperty const> shape_properties, std::optional<Window> fullscreen_target_window = {}) noexcept;
+
+  /// add changed rects of window content coordinates to every back buffer, call before render
+  void damage(std::span<ui::DirtyRect const> rects) noexcept;
+  /// every back buffer is redrawn, used when their content is lost
+  void damage_all() noexcept;
+
+  /**
+   * @param capture_drag_cache render content of fullscreen target window into drag cache of renderer,
+   *                           then only last two batches of drag cache and cursor are drawn
+   * window only redraws damage of current back buffer, fullscreen always redraws whole swapchain
+   */
+  void render(std::span<Vertex const> vertices, std::span<uint16_t const> indices, std::span<ShapeProperty const> shape_properties, std::span<DrawBatch const> batches, std::optional<Window> fullscreen_target_window = {}, bool capture_drag_cache = {}) noexcept;
   void present(bool vsync) const noexcept;
 
-  void window_content_render(Image* render_target_image, std::span<Vertex const> vertices, std::span<uint16_t const> indices, std::span<ShapeProperty const> shape_properties, std::optional<Window> fullscreen_target_window) noexcept;
-  void window_shadow_render(ID3D12GraphicsCommandList1* cmd) const noexcept;
+  /// @param rects redrawn rects of render target, empty redraws whole
+  void window_content_render(Image* render_target_image, std::span<DrawBatch const> shadow_batches, std::span<DrawBatch const> batches, std::optional<Window> fullscreen_target_window, std::span<RECT const> rects = {}) noexcept;
+  void drag_cache_render(std::span<DrawBatch const> batches, Window const& target_window) noexcept;
+  void draw_batches(std::span<DrawBatch const> batches, Constants const& constants) noexcept;
 };
 
 }}
@@ -0,0 +1,97 @@
+#include "window_shadow.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <assert.h>
+
+namespace {
+
+auto gaussian_kernel(uint32_t radius) noexcept
+{
+  auto kernel = std::vector<float>(radius * 2 + 1);
+  auto sigma  = std::max(radius / 3.f, 1e-3f);
+  auto sum    = 0.f;
+  for (auto i = 0u; i < kernel.size(); ++i)
+  {
+    auto x    = static_cast<float>(i) - radius;
+    kernel[i] = std::exp(-x * x / (2 * sigma * sigma));
+    sum      += kernel[i];
+  }
+  for (auto& weight : kernel)
+    weight /= sum;
+  return kernel;
+}
+
+/// blur columns, dst row is weighted sum of src rows, rows out of image are zero
+void blur_vertical(std::span<float const> src, std::span<float> dst, uint32_t width, uint32_t height, std::span<float const> kernel) noexcept
+{
+  auto radius = static_cast<int>(kernel.size() / 2);
+  std::ranges::fill(dst, 0.f);
+  for (auto y = 0; y < static_cast<int>(height); ++y)
+  {
+    auto dst_row = dst.data() + y * width;
+    for (auto k = -radius; k <= radius; ++k)
+    {
+      auto src_y = y + k;
+      if (src_y < 0 || src_y >= static_cast<int>(height)) continue;
+      auto src_row = src.data() + src_y * width;
+      auto weight  = kernel[k + radius];
+      for (auto x = 0u; x < width; ++x)
+        dst_row[x] += src_row[x] * weight;
+    }
+  }
+}
+
+void transpose(std::span<float const> src, std::span<float> dst, uint32_t width, uint32_t height) noexcept
+{
+  for (auto y = 0u; y < height; ++y)
+    for (auto x = 0u; x < width; ++x)
+      dst[x * height + y] = src[y * width + x];
+}
+
+}
+
+namespace vn { namespace renderer {
+
+void gaussian_blur(std::span<float> image, uint32_t width, uint32_t height, uint32_t radius) noexcept
+{
+  assert(image.size() == width * height);
+  if (radius == 0) return;
+
+  // horizontal pass is vertical pass on transposed image
+  auto kernel = gaussian_kernel(radius);
+  auto tmp    = std::vector<float>(image.size());
+  blur_vertical(image, tmp, width, height, kernel);
+  transpose(tmp, image, width, height);
+  blur_vertical(image, tmp, height, width, kernel);
+  transpose(tmp, image, height, width);
+}
+
+auto generate_window_shadow(uint32_t thickness, uint32_t radius, glm::vec4 color) noexcept -> WindowShadow
+{
+  assert(radius <= thickness);
+
+  auto shadow = WindowShadow{};
+  shadow.thickness = thickness;
+  auto extent = shadow.extent();
+
+  // window mask
+  auto mask = std::vector<float>(extent * extent);
+  for (auto y = thickness; y < extent - thickness; ++y)
+    std::fill_n(mask.begin() + y * extent + thickness, extent - thickness * 2, 1.f);
+
+  gaussian_blur(mask, extent, extent, radius);
+
+  shadow.pixels.resize(mask.size() * 4);
+  auto to_unorm = [](float value) { return static_cast<uint8_t>(std::clamp(value, 0.f, 1.f) * 255.f + 0.5f); };
+  for (auto i = 0u; i < mask.size(); ++i)
+  {
+    shadow.pixels[i * 4 + 0] = to_unorm(color.r);
+    shadow.pixels[i * 4 + 1] = to_unorm(color.g);
+    shadow.pixels[i * 4 + 2] = to_unorm(color.b);
+    shadow.pixels[i * 4 + 3] = to_unorm(color.a * mask[i]);
+  }
+  return shadow;
+}
+
+}}
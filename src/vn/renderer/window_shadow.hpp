@@ -0,0 +1,38 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <vector>
+#include <span>
+#include <cstdint>
+
+namespace vn { namespace renderer {
+
+/**
+ * blur single channel image in place by separable gaussian, sigma is a third of radius
+ * both passes accumulate whole rows, so inner loops are contiguous and vectorized by compiler
+ */
+void gaussian_blur(std::span<float> image, uint32_t width, uint32_t height, uint32_t radius) noexcept;
+
+/**
+ * 9-slice shadow image of a rectangle window, generated once on cpu rather than blurred every frame
+ * image extent is 4 * thickness, window rectangle occupies the middle with thickness margins,
+ * so every corner slice is 2 * thickness and the middle row and column are edge slices
+ */
+struct WindowShadow
+{
+  uint32_t             thickness{};
+  std::vector<uint8_t> pixels; // rgba8, straight alpha
+
+  auto extent()      const noexcept { return thickness * 4; }
+  auto corner_size() const noexcept { return thickness * 2; }
+};
+
+/**
+ * @param thickness extent of shadow out of window
+ * @param radius blur radius, no more than thickness so shadow fades out inside the image
+ * @param color color of shadow, alpha is of shadow under window
+ */
+auto generate_window_shadow(uint32_t thickness, uint32_t radius, glm::vec4 color) noexcept -> WindowShadow;
+
+}}
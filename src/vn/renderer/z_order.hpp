@@ -0,0 +1,64 @@
+#pragma once
+
+#include <vector>
+#include <span>
+#include <algorithm>
+#include <cstdint>
+
+namespace vn { namespace renderer {
+
+/**
+ * z order of windows by id, top-most first
+ * it is kept by window position and activation messages, so finding window under cursor never walks windows of desktop
+ * only relative order of own windows is kept, foreign windows between them not affect routing
+ * no os calls, drive it by raise, lower and place_under then check ids and find
+ */
+class ZOrder
+{
+public:
+  /// move window to top, window not in order is added
+  void raise(uint32_t id) noexcept
+  {
+    std::erase(_ids, id);
+    _ids.insert(_ids.begin(), id);
+  }
+
+  /// move window to bottom, window not in order is added
+  void lower(uint32_t id) noexcept
+  {
+    std::erase(_ids, id);
+    _ids.emplace_back(id);
+  }
+
+  /// move window right under another one, it is raised when the other one not in order
+  void place_under(uint32_t id, uint32_t above) noexcept
+  {
+    std::erase(_ids, id);
+    auto it = std::ranges::find(_ids, above);
+    _ids.insert(it != _ids.end() ? it + 1 : _ids.begin(), id);
+  }
+
+  void erase(uint32_t id) noexcept { std::erase(_ids, id); }
+
+  /// replace whole order, ids are top-most first
+  void assign(std::vector<uint32_t> ids) noexcept { _ids = std::move(ids); }
+
+  auto ids() const noexcept { return std::span<uint32_t const>{ _ids }; }
+
+  /**
+   * find top-most window accepted by predicate
+   * @param pred whether window with id is accepted, e.g. cursor on it
+   * @return id of window, 0 if none accepted
+   */
+  template <typename Pred>
+  auto find(Pred&& pred) const noexcept -> uint32_t
+  {
+    auto it = std::ranges::find_if(_ids, pred);
+    return it != _ids.end() ? *it : 0;
+  }
+
+private:
+  std::vector<uint32_t> _ids;
+};
+
+}}
@@ -0,0 +1,63 @@
+#include "curve.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <assert.h>
+
+namespace
+{
+
+/// n = ceil(sqrt(degree * (degree - 1) / 8 * max length of second differences / tolerance))
+auto wang_segment_count(float degree_factor, float second_difference, float tolerance) noexcept
+{
+  assert(tolerance > 0.f);
+  auto count = std::ceil(std::sqrt(degree_factor * second_difference / tolerance));
+  return static_cast<uint32_t>(std::clamp(count, 1.f, static_cast<float>(vn::ui::Max_Curve_Segment_Count)));
+}
+
+}
+
+namespace vn { namespace ui {
+
+auto quadratic_segment_count(glm::vec2 p0, glm::vec2 p1, glm::vec2 p2, float tolerance) noexcept -> uint32_t
+{
+  return wang_segment_count(2.f * 1.f / 8.f, glm::length(p0 - p1 * 2.f + p2), tolerance);
+}
+
+auto cubic_segment_count(glm::vec2 p0, glm::vec2 p1, glm::vec2 p2, glm::vec2 p3, float tolerance) noexcept -> uint32_t
+{
+  auto d = std::max(glm::length(p0 - p1 * 2.f + p2), glm::length(p1 - p2 * 2.f + p3));
+  return wang_segment_count(3.f * 2.f / 8.f, d, tolerance);
+}
+
+void flatten_quadratic(glm::vec2 p0, glm::vec2 p1, glm::vec2 p2, float tolerance, std::vector<glm::vec2>& points) noexcept
+{
+  auto count = quadratic_segment_count(p0, p1, p2, tolerance);
+  auto beg   = points.size();
+  points.resize(beg + count + 1);
+  auto out = points.data() + beg;
+  for (auto i = 0u; i <= count; ++i)
+  {
+    auto t  = static_cast<float>(i) / count;
+    auto mt = 1.f - t;
+    out[i] = p0 * (mt * mt) + p1 * (2.f * mt * t) + p2 * (t * t);
+  }
+  out[count] = p2;
+}
+
+void flatten_cubic(glm::vec2 p0, glm::vec2 p1, glm::vec2 p2, glm::vec2 p3, float tolerance, std::vector<glm::vec2>& points) noexcept
+{
+  auto count = cubic_segment_count(p0, p1, p2, p3, tolerance);
+  auto beg   = points.size();
+  points.resize(beg + count + 1);
+  auto out = points.data() + beg;
+  for (auto i = 0u; i <= count; ++i)
+  {
+    auto t  = static_cast<float>(i) / count;
+    auto mt = 1.f - t;
+    out[i] = p0 * (mt * mt * mt) + p1 * (3.f * mt * mt * t) + p2 * (3.f * mt * t * t) + p3 * (t * t * t);
+  }
+  out[count] = p3;
+}
+
+}}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <vector>
+#include <cstdint>
+
+namespace vn { namespace ui {
+
+constexpr auto Default_Curve_Tolerance = 0.25f; // quarter pixel is invisible after anti-aliasing
+constexpr auto Max_Curve_Segment_Count = 64u;   // bound per pixel cost of huge curves
+
+/**
+ * segment count of flattening curve by Wang's formula, flattened segments are no farther than tolerance from curve
+ * count is decided directly from control points, so curves are split uniformly without recursive subdivision
+ * count is clamped to Max_Curve_Segment_Count, huge curves exceed tolerance then
+ * @param tolerance max distance in pixels between curve and its segments
+ */
+auto quadratic_segment_count(glm::vec2 p0, glm::vec2 p1, glm::vec2 p2, float tolerance) noexcept -> uint32_t;
+auto cubic_segment_count(glm::vec2 p0, glm::vec2 p1, glm::vec2 p2, glm::vec2 p3, float tolerance) noexcept -> uint32_t;
+
+/**
+ * flatten curve into polyline, points from p0 to last control point are appended
+ * points are evaluated by one loop without branch over uniform parameters, so compiler is able to vectorize it
+ * cpu only, check appended points against curve
+ */
+void flatten_quadratic(glm::vec2 p0, glm::vec2 p1, glm::vec2 p2, float tolerance, std::vector<glm::vec2>& points) noexcept;
+void flatten_cubic(glm::vec2 p0, glm::vec2 p1, glm::vec2 p2, glm::vec2 p3, float tolerance, std::vector<glm::vec2>& points) noexcept;
+
+}}
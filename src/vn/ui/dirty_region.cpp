@@ -0,0 +1,171 @@
+#include "dirty_region.hpp"
+#include "window_render_data.hpp"
+#include "../hash.hpp"
+
+#include <cmath>
+#include <string_view>
+#include <utility>
+#include <assert.h>
+
+using namespace vn::renderer;
+
+namespace
+{
+
+constexpr auto Quad_Vertex_Count = 4;
+
+auto hash_bytes(void const* data, size_t size) noexcept
+{
+  return std::hash<std::string_view>{}({ static_cast<char const*>(data), size });
+}
+
+}
+
+namespace vn { namespace ui {
+
+void merge_rects(std::vector<DirtyRect>& rects, uint32_t max_count) noexcept
+{
+  std::erase_if(rects, [](auto const& rect) { return rect.empty(); });
+
+  // merge touched rects until stable, a merged rect may touch rects already visited
+  for (auto merged = true; merged;)
+  {
+    merged = false;
+    for (auto i = size_t{}; i < rects.size(); ++i)
+      for (auto j = i + 1; j < rects.size();)
+      {
+        if (rects[i].touch(rects[j]))
+        {
+          rects[i] = rects[i].unite(rects[j]);
+          rects[j] = rects.back();
+          rects.pop_back();
+          merged   = true;
+        }
+        else
+          ++j;
+      }
+  }
+
+  // merge pairs which waste least area
+  while (rects.size() > std::max(max_count, 1u))
+  {
+    auto best       = std::pair<size_t, size_t>{};
+    auto best_waste = INT64_MAX;
+    for (auto i = size_t{}; i < rects.size(); ++i)
+      for (auto j = i + 1; j < rects.size(); ++j)
+      {
+        auto waste = rects[i].unite(rects[j]).area() - rects[i].area() - rects[j].area();
+        if (waste < best_waste)
+        {
+          best       = { i, j };
+          best_waste = waste;
+        }
+      }
+    rects[best.first]  = rects[best.first].unite(rects[best.second]);
+    rects[best.second] = rects.back();
+    rects.pop_back();
+  }
+}
+
+auto DirtyTracker::update(WindowRenderData const& data, DirtyRect const& bounds) noexcept -> std::vector<DirtyRect>
+{
+  auto offsets = data.shape_property_offsets();
+
+  auto quads = std::vector<Quad>{};
+  quads.reserve(data.vertices.size() / Quad_Vertex_Count);
+  for (auto i = size_t{}; i + Quad_Vertex_Count <= data.vertices.size(); i += Quad_Vertex_Count)
+  {
+    auto const& v0 = data.vertices[i];
+    auto const& v2 = data.vertices[i + 2];
+
+    // buffer offset and depth are excluded, they change when shapes before are changed
+    auto quad = Quad{};
+    for (auto j = i; j < i + Quad_Vertex_Count; ++j)
+    {
+      auto pos = glm::vec2{ data.vertices[j].pos };
+      combine_hash(quad.hash, hash_bytes(&pos,                 sizeof(pos)));
+      combine_hash(quad.hash, hash_bytes(&data.vertices[j].uv, sizeof(data.vertices[j].uv)));
+    }
+
+    // shape of quad with its operator chain, chain ends at the shape without operator
+    auto it = std::ranges::lower_bound(offsets, v0.buffer_offset);
+    assert(it != offsets.end() && *it == v0.buffer_offset);
+    for (auto k = static_cast<size_t>(it - offsets.begin()); k < data.shape_properties.size(); ++k)
+    {
+      auto const& shape_property = data.shape_properties[k];
+      combine_hash(quad.hash, hash_bytes(shape_property.data(), shape_property.byte_size()));
+      if (shape_property.op() == ShapeProperty::Operator::none)
+        break;
+    }
+
+    quad.order = static_cast<uint32_t>(i / Quad_Vertex_Count);
+    quad.rect  =
+    {
+      static_cast<int32_t>(std::floor(std::min(v0.pos.x, v2.pos.x))) - Rect_Padding,
+      static_cast<int32_t>(std::floor(std::min(v0.pos.y, v2.pos.y))) - Rect_Padding,
+      static_cast<int32_t>(std::ceil( std::max(v0.pos.x, v2.pos.x))) + Rect_Padding,
+      static_cast<int32_t>(std::ceil( std::max(v0.pos.y, v2.pos.y))) + Rect_Padding,
+    };
+    quads.emplace_back(quad);
+  }
+  std::ranges::sort(quads, {}, [](auto const& quad) { return std::pair{ quad.hash, quad.order }; });
+
+  auto valid = std::exchange(_valid, true);
+  std::swap(_quads, quads);
+  if (!valid) return { bounds };
+
+  // walk both sorted frames, quads only in one frame are dirty, same quads are paired in recorded order
+  auto rects   = std::vector<DirtyRect>{};
+  auto matched = std::vector<std::pair<Quad const*, Quad const*>>{};
+  auto add     = [&](Quad const& quad) { rects.emplace_back(quad.rect.intersect(bounds)); };
+  auto prev    = quads.begin();
+  auto curr    = _quads.begin();
+  while (prev != quads.end() || curr != _quads.end())
+  {
+    if (curr == _quads.end() || (prev != quads.end() && prev->hash < curr->hash))
+      add(*prev++);
+    else if (prev == quads.end() || curr->hash < prev->hash)
+      add(*curr++);
+    else
+      matched.emplace_back(&*prev++, &*curr++);
+  }
+
+  // matched quads in longest run keeping order of last frame are drawn in same order,
+  // every swapped pair has one quad out of the run, so rects of those quads cover the change
+  std::ranges::sort(matched, {}, [](auto const& match) { return match.second->order; });
+  auto tails   = std::vector<uint32_t>{}; // matched index ending the run of every length, with smallest order
+  auto parents = std::vector<uint32_t>(matched.size());
+  for (auto i = uint32_t{}; i < matched.size(); ++i)
+  {
+    auto it = std::ranges::lower_bound(tails, matched[i].first->order, {}, [&](auto j) { return matched[j].first->order; });
+    parents[i] = it == tails.begin() ? UINT32_MAX : *(it - 1);
+    if (it == tails.end())
+      tails.emplace_back(i);
+    else
+      *it = i;
+  }
+  auto in_run = std::vector<bool>(matched.size());
+  for (auto i = tails.empty() ? UINT32_MAX : tails.back(); i != UINT32_MAX; i = parents[i])
+    in_run[i] = true;
+  for (auto i = size_t{}; i < matched.size(); ++i)
+    if (!in_run[i]) add(*matched[i].second);
+
+  // too many changes, merging costs more than drawing
+  if (rects.size() > Max_Merge_Count)
+  {
+    auto rect = rects.front();
+    for (auto const& r : rects)
+      rect = rect.unite(r);
+    rects = { rect };
+  }
+  merge_rects(rects, Max_Rect_Count);
+
+  auto area = int64_t{};
+  for (auto const& rect : rects)
+    area += rect.area();
+  if (area > bounds.area() * Full_Area_Ratio)
+    return { bounds };
+  return rects;
+}
+
+}}
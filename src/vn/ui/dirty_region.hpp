@@ -0,0 +1,87 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+
+namespace vn { namespace ui {
+
+struct WindowRenderData;
+
+struct DirtyRect
+{
+  int32_t left{};
+  int32_t top{};
+  int32_t right{};
+  int32_t bottom{};
+
+  auto empty() const noexcept { return left >= right || top >= bottom; }
+  auto area()  const noexcept { return empty() ? int64_t{} : int64_t{ right - left } * (bottom - top); }
+
+  auto unite(DirtyRect const& rect) const noexcept
+  {
+    return DirtyRect{ std::min(left, rect.left), std::min(top, rect.top), std::max(right, rect.right), std::max(bottom, rect.bottom) };
+  }
+
+  auto intersect(DirtyRect const& rect) const noexcept
+  {
+    return DirtyRect{ std::max(left, rect.left), std::max(top, rect.top), std::min(right, rect.right), std::min(bottom, rect.bottom) };
+  }
+
+  /// overlapping or adjacent
+  auto touch(DirtyRect const& rect) const noexcept
+  {
+    return left <= rect.right && rect.left <= right && top <= rect.bottom && rect.top <= bottom;
+  }
+
+  bool operator==(DirtyRect const&) const noexcept = default;
+};
+
+/**
+ * merge rects into no more than max count, touched rects are always merged,
+ * then pairs which waste least area by merging are merged until count fits
+ * empty rects are removed
+ */
+void merge_rects(std::vector<DirtyRect>& rects, uint32_t max_count) noexcept;
+
+/**
+ * find area changed between recorded frames of a window
+ * every quad is keyed by hash of its vertices and the shape properties it references, so shapes
+ * which only move in the stream, for example after a shape before them is added, are not dirty
+ * quads of last frame and this frame are matched as multisets, unmatched quads of both frames are dirty
+ * matched quads whose drawing order changed are dirty too, so swapping overlapped quads redraws them
+ * content of images is keyed by descriptor index and load generation in their shape properties
+ * cpu only, feed recorded render datas and check output rects
+ */
+class DirtyTracker
+{
+public:
+  static constexpr auto Max_Rect_Count   = 4u;
+  static constexpr auto Rect_Padding     = 1;    // covers rounding of rasterization
+  static constexpr auto Max_Merge_Count  = 64u;  // more changed quads than this collapse into bounding rect
+  static constexpr auto Full_Area_Ratio  = 0.5f; // dirty area over this ratio of bounds becomes full redraw
+
+  /**
+   * compare render data with last updated one
+   * @param data render data of this frame, batches are not required
+   * @param bounds area able to be drawn, rects are clipped by it
+   * @return changed rects, empty if nothing changed, bounds if everything should be redrawn
+   */
+  auto update(WindowRenderData const& data, DirtyRect const& bounds) noexcept -> std::vector<DirtyRect>;
+
+  /// forget last frame, next update returns bounds
+  void reset() noexcept { _valid = false; }
+
+private:
+  struct Quad
+  {
+    size_t    hash{};
+    DirtyRect rect{};
+    uint32_t  order{}; // index in recorded stream
+  };
+
+  std::vector<Quad> _quads; // quads of last frame sorted by hash then order
+  bool              _valid{};
+};
+
+}}
@@ -0,0 +1,124 @@
+#include "distance_field_cache.hpp"
+#include "../hash.hpp"
+
+#include <string_view>
+#include <vector>
+#include <bit>
+#include <utility>
+#include <ranges>
+#include <assert.h>
+
+using namespace vn::renderer;
+
+namespace
+{
+
+auto hash_bytes(void const* data, size_t size) noexcept
+{
+  return std::hash<std::string_view>{}({ static_cast<char const*>(data), size });
+}
+
+/// values of shape with its points moved by -origin, so same shape at any position has same values
+void translated_values(ShapeProperty const& shape_property, glm::vec2 origin, std::vector<uint32_t>& values) noexcept
+{
+  // values follow header, see ShapeProperty::Header
+  constexpr auto Values_Index = sizeof(ShapeProperty::Header) / sizeof(uint32_t);
+
+  auto data = shape_property.data();
+  values.assign(data + Values_Index, data + shape_property.byte_size() / sizeof(uint32_t));
+
+  auto translate = [&](size_t index, uint32_t point_count)
+  {
+    assert(index + point_count * 2 <= values.size());
+    for (auto i = index; i < index + point_count * 2; i += 2)
+    {
+      values[i]     = std::bit_cast<uint32_t>(std::bit_cast<float>(values[i])     - origin.x);
+      values[i + 1] = std::bit_cast<uint32_t>(std::bit_cast<float>(values[i + 1]) - origin.y);
+    }
+  };
+
+  // layouts of values are same as get_sd of shader
+  switch (shape_property.type())
+  {
+  case ShapeProperty::Type::circle:    translate(0, 1); break;
+  case ShapeProperty::Type::rectangle:
+  case ShapeProperty::Type::line:      translate(0, 2); break;
+  case ShapeProperty::Type::triangle:
+  case ShapeProperty::Type::bezier:    translate(0, 3); break;
+  case ShapeProperty::Type::path:
+  {
+    // count of partitions, then every partition is its type and points
+    auto index = size_t{ 1 };
+    for (auto i = 0u; i < values[0]; ++i)
+    {
+      auto point_count = static_cast<ShapeProperty::Type>(values[index++]) == ShapeProperty::Type::path_line ? 2u : 3u;
+      translate(index, point_count);
+      index += point_count * 2;
+    }
+    break;
+  }
+  default: break;
+  }
+}
+
+}
+
+namespace vn { namespace ui {
+
+auto distance_field_key(std::span<ShapeProperty const> shape_properties, glm::vec2 origin, glm::vec<2, uint32_t> extent) noexcept -> size_t
+{
+  // geometry is keyed relative to origin, origin is on pixel grid so fractional position of shape is still in key
+  auto key    = generic_hash(extent.x, extent.y);
+  auto values = std::vector<uint32_t>{};
+  for (auto const& shape_property : shape_properties)
+  {
+    translated_values(shape_property, origin, values);
+    combine_hash(key, std::to_underlying(shape_property.type()));
+    combine_hash(key, std::to_underlying(shape_property.op()));
+    combine_hash(key, hash_bytes(values.data(), values.size() * sizeof(uint32_t)));
+  }
+  return key;
+}
+
+DistanceFieldCache::DistanceFieldCache() noexcept
+{
+  // pop from back, so tiles are handed out from left top of atlas
+  _free_tiles = std::views::iota(0u, Tile_Count) | std::views::reverse | std::ranges::to<std::vector>();
+}
+
+auto DistanceFieldCache::acquire(size_t key) noexcept -> std::optional<Tile>
+{
+  auto to_tile = [](uint32_t index, bool need_bake)
+  {
+    return Tile{ { index % Tile_Per_Row * Tile_Size, index / Tile_Per_Row * Tile_Size }, need_bake };
+  };
+
+  if (auto it = _lookup.find(key); it != _lookup.end())
+  {
+    _entries.splice(_entries.begin(), _entries, it->second);
+    it->second->frame = _frame;
+    return to_tile(it->second->tile, false);
+  }
+
+  auto tile = uint32_t{};
+  if (!_free_tiles.empty())
+  {
+    tile = _free_tiles.back();
+    _free_tiles.pop_back();
+  }
+  else
+  {
+    // least recently used one is still drawn in this frame, so are all the others
+    assert(!_entries.empty());
+    if (_entries.back().frame == _frame) return {};
+    tile = _entries.back().tile;
+    _lookup.erase(_entries.back().key);
+    _entries.pop_back();
+  }
+
+  _entries.emplace_front(key, tile, _frame);
+  _lookup[key] = _entries.begin();
+  return to_tile(tile, true);
+}
+
+}}
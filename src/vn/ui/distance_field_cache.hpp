@@ -0,0 +1,75 @@
+#pragma once
+
+#include "../renderer/shader_type.hpp"
+#include "../renderer/config.hpp"
+
+#include <glm/glm.hpp>
+
+#include <list>
+#include <unordered_map>
+#include <vector>
+#include <optional>
+#include <span>
+#include <cstdint>
+
+namespace vn { namespace ui {
+
+/// distance of shape to bake into atlas of renderer, window position origin maps to left top of tile
+struct DistanceFieldBake
+{
+  glm::vec<2, uint32_t>                tile{};
+  glm::vec2                            origin{};
+  glm::vec<2, uint32_t>                extent{};
+  std::vector<renderer::ShapeProperty> shape_properties; // operator chain of shape, ends with the one without operator
+};
+
+/**
+ * key of distance field by geometry of operator chain, colors and thicknesses are excluded,
+ * they are applied when sampling, so shapes which only change color share the baked distance
+ * geometry is translated by origin, sampling maps tile relative to origin, so moved shapes share it too
+ */
+auto distance_field_key(std::span<renderer::ShapeProperty const> shape_properties, glm::vec2 origin, glm::vec<2, uint32_t> extent) noexcept -> size_t;
+
+/**
+ * lru bookkeeping of distance field atlas, renderer owns the atlas image and bakes tiles this cache hands out
+ * atlas is divided into square tiles of same size, every cached shape takes one tile
+ * tiles used in current frame are never evicted, shapes which are not able to get a tile are evaluated analytically
+ * cpu only, drive it by keys and check returned tiles
+ */
+class DistanceFieldCache
+{
+public:
+  static constexpr auto Atlas_Size     = static_cast<uint32_t>(renderer::Distance_Field_Atlas_Size);
+  static constexpr auto Tile_Size      = static_cast<uint32_t>(renderer::Distance_Field_Tile_Size);
+  static constexpr auto Tile_Per_Row   = Atlas_Size / Tile_Size;
+  static constexpr auto Tile_Count     = Tile_Per_Row * Tile_Per_Row;
+
+  struct Tile
+  {
+    glm::vec<2, uint32_t> pos{};       // left top in atlas
+    bool                  need_bake{}; // newly allocated, distance is not in atlas yet
+  };
+
+  DistanceFieldCache() noexcept;
+
+  /// tiles acquired after this are kept until next frame
+  void begin_frame() noexcept { ++_frame; }
+
+  /// @return tile of key, empty if every tile is used by current frame
+  auto acquire(size_t key) noexcept -> std::optional<Tile>;
+
+private:
+  struct Entry
+  {
+    size_t   key{};
+    uint32_t tile{};
+    uint64_t frame{}; // last frame used
+  };
+
+  std::list<Entry>                                       _entries; // most recently used first
+  std::unordered_map<size_t, std::list<Entry>::iterator> _lookup;
+  std::vector<uint32_t>                                  _free_tiles;
+  uint64_t                                               _frame{};
+};
+
+}}
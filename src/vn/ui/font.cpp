@@ -0,0 +1,136 @@
+#include "font.hpp"
+#include "curve.hpp"
+#include "error_handling.hpp"
+
+#include <utf8.h>
+
+#include <fstream>
+#include <iterator>
+
+#include <shlobj.h>
+
+#define STB_TRUETYPE_IMPLEMENTATION
+#include <stb_truetype.h>
+
+namespace vn { namespace ui {
+
+auto default_font() noexcept -> std::string
+{
+  // windows is not always installed on drive c
+  auto dir  = PWSTR{};
+  auto path = std::string{};
+  if (SUCCEEDED(SHGetKnownFolderPath(FOLDERID_Fonts, 0, nullptr, &dir)))
+    path = utf8::utf16to8(std::u16string_view{ reinterpret_cast<char16_t const*>(dir) }) + "/msyh.ttc";
+  else
+    error("failed to find fonts folder");
+  CoTaskMemFree(dir);
+  return path;
+}
+
+void Font::init(std::string_view filename) noexcept
+{
+  // missing font only skips text, rest of ui still works
+  auto file = std::ifstream{ std::string{ filename }, std::ios::binary };
+  if (!file)
+  {
+    error("failed to open font {}, text of it is skipped", filename);
+    return;
+  }
+  _data.assign(std::istreambuf_iterator<char>{ file }, {});
+
+  auto offset = _data.empty() ? -1 : stbtt_GetFontOffsetForIndex(_data.data(), 0);
+  if (offset < 0 || !stbtt_InitFont(&_info, _data.data(), offset))
+  {
+    error("failed to parse font {}, text of it is skipped", filename);
+    _data.clear();
+    return;
+  }
+  _valid = true;
+
+  auto ascent   = int{};
+  auto descent  = int{};
+  auto line_gap = int{};
+  stbtt_GetFontVMetrics(&_info, &ascent, &descent, &line_gap);
+  _scale       = stbtt_ScaleForMappingEmToPixels(&_info, 1.f);
+  _ascent      = ascent * _scale;
+  _descent     = -descent * _scale;
+  _line_gap    = line_gap * _scale;
+  _has_kerning = _info.kern || _info.gpos;
+}
+
+auto Font::glyph(uint32_t codepoint) noexcept -> Glyph const&
+{
+  if (auto it = _glyphs.find(codepoint); it != _glyphs.end())
+    return it->second;
+
+  auto glyph = Glyph{};
+  glyph.index = stbtt_FindGlyphIndex(&_info, static_cast<int>(codepoint));
+
+  auto advance = int{};
+  auto bearing = int{};
+  stbtt_GetGlyphHMetrics(&_info, glyph.index, &advance, &bearing);
+  glyph.advance = advance * _scale;
+
+  // font units are y up, flip box to y down
+  auto x0 = int{}, y0 = int{}, x1 = int{}, y1 = int{};
+  glyph.empty = stbtt_IsGlyphEmpty(&_info, glyph.index) || !stbtt_GetGlyphBox(&_info, glyph.index, &x0, &y0, &x1, &y1);
+  glyph.min   = glm::vec2{ x0, -y1 } * _scale;
+  glyph.max   = glm::vec2{ x1, -y0 } * _scale;
+
+  return _glyphs.emplace(codepoint, glyph).first->second;
+}
+
+auto Font::kerning(int glyph0, int glyph1) noexcept -> float
+{
+  if (!_has_kerning) return {};
+
+  auto key = static_cast<uint64_t>(static_cast<uint32_t>(glyph0)) << 32 | static_cast<uint32_t>(glyph1);
+  if (auto it = _kernings.find(key); it != _kernings.end())
+    return it->second;
+  return _kernings.emplace(key, stbtt_GetGlyphKernAdvance(&_info, glyph0, glyph1) * _scale).first->second;
+}
+
+auto Font::outline(int glyph_index, float tolerance) const noexcept -> GlyphOutline
+{
+  auto vertices = static_cast<stbtt_vertex*>(nullptr);
+  auto count    = stbtt_GetGlyphShape(&_info, glyph_index, &vertices);
+
+  auto to_em = [this](auto x, auto y) { return glm::vec2{ x, -y } * _scale; };
+
+  auto outline = GlyphOutline{};
+  auto pos     = glm::vec2{};
+  for (auto i = 0; i < count; ++i)
+  {
+    auto const& vertex = vertices[i];
+    auto        p      = to_em(vertex.x, vertex.y);
+    if (vertex.type == STBTT_vmove)
+    {
+      outline.emplace_back();
+      pos = p;
+      continue;
+    }
+    if (outline.empty()) outline.emplace_back();
+
+    auto& edge = outline.back().emplace_back();
+    switch (vertex.type)
+    {
+    case STBTT_vline:
+      edge = { pos, p };
+      break;
+    case STBTT_vcurve:
+      flatten_quadratic(pos, to_em(vertex.cx, vertex.cy), p, tolerance, edge);
+      break;
+    case STBTT_vcubic:
+      flatten_cubic(pos, to_em(vertex.cx, vertex.cy), to_em(vertex.cx1, vertex.cy1), p, tolerance, edge);
+      break;
+    }
+    pos = p;
+  }
+  stbtt_FreeShape(&_info, vertices);
+
+  // contour without edges only moves pen
+  std::erase_if(outline, [](auto const& contour) { return contour.empty(); });
+  return outline;
+}
+
+}}
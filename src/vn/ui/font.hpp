@@ -0,0 +1,79 @@
+#pragma once
+
+#include "msdf.hpp"
+
+#include <stb_truetype.h>
+
+#include <glm/glm.hpp>
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <cstdint>
+
+namespace vn { namespace ui {
+
+/**
+ * font file parsed by stb_truetype, metrics are in ems and y is down, so they scale by pixel size of text directly
+ * glyph and kerning lookups are cached and only for main thread, outline is const and is used by rasterizing workers
+ */
+/// msyh.ttc in fonts folder of system, empty when folder is not found
+auto default_font() noexcept -> std::string;
+
+class Font
+{
+public:
+  struct Glyph
+  {
+    int       index{};   // glyph index in font
+    float     advance{};
+    glm::vec2 min{};     // bounding box from pen position on baseline
+    glm::vec2 max{};
+    bool      empty{};   // no outline, like space
+  };
+
+  Font()                       = default;
+  Font(Font const&)            = delete;
+  Font(Font&&)                 = delete;
+  Font& operator=(Font const&) = delete;
+  Font& operator=(Font&&)      = delete;
+
+  /// load font file, first font of collection like ttc is used, font stays invalid and error is logged when it fails
+  void init(std::string_view filename) noexcept;
+
+  /// other functions are only called on valid font
+  auto valid() const noexcept { return _valid; }
+
+  /// @return glyph of codepoint, it is the missing glyph of font if codepoint is not in font
+  auto glyph(uint32_t codepoint) noexcept -> Glyph const&;
+
+  /// @return advance adjustment between two glyph indices
+  auto kerning(int glyph0, int glyph1) noexcept -> float;
+
+  auto ascent()      const noexcept { return _ascent;                       }
+  auto descent()     const noexcept { return _descent;                      } // positive, below baseline
+  auto line_gap()    const noexcept { return _line_gap;                     }
+  auto line_height() const noexcept { return _ascent + _descent + _line_gap; }
+
+  /**
+   * outline of glyph in ems, every line and curve of font is an edge, curves are flattened into polylines
+   * @param glyph_index
+   * @param tolerance max distance in ems between curve and its polyline
+   */
+  auto outline(int glyph_index, float tolerance) const noexcept -> GlyphOutline;
+
+private:
+  std::vector<unsigned char>               _data;
+  stbtt_fontinfo                           _info{};
+  float                                    _scale{}; // ems per font unit
+  float                                    _ascent{};
+  float                                    _descent{};
+  float                                    _line_gap{};
+  bool                                     _has_kerning{};
+  bool                                     _valid{};
+  std::unordered_map<uint32_t, Glyph>      _glyphs;
+  std::unordered_map<uint64_t, float>      _kernings;
+};
+
+}}
@@ -0,0 +1,150 @@
+#include "glyph_cache.hpp"
+#include "msdf.hpp"
+#include "../hash.hpp"
+
+#include <algorithm>
+#include <ranges>
+#include <cmath>
+#include <assert.h>
+
+namespace vn { namespace ui {
+
+GlyphCache::GlyphCache() noexcept
+{
+  // pop from back, so cells are handed out from left top of atlas
+  _free_cells = std::views::iota(0u, Cell_Count) | std::views::reverse | std::ranges::to<std::vector>();
+}
+
+auto GlyphCache::font(std::string_view filename) noexcept -> Font&
+{
+  auto [it, inserted] = _fonts.try_emplace(std::string{ filename });
+  if (inserted)
+    it->second.init(filename);
+  return it->second;
+}
+
+void GlyphCache::begin_frame(std::vector<GlyphUpload>& uploads) noexcept
+{
+  ++_frame;
+
+  auto done = std::vector<std::pair<Use, GlyphUpload>>{};
+  {
+    auto lock = std::lock_guard{ _mutex };
+    std::swap(done, _done);
+  }
+
+  // rasterizing cells are never evicted, so entry of every result is still there
+  for (auto& [use, upload] : done)
+  {
+    auto it = _lookup.find(use.key);
+    assert(it != _lookup.end() && it->second->glyph.use.version == use.version);
+    it->second->ready = true;
+    ++_ready_count;
+    uploads.emplace_back(std::move(upload));
+  }
+}
+
+auto GlyphCache::acquire(Font const& font, Font::Glyph const& glyph) noexcept -> std::optional<Glyph>
+{
+  assert(!glyph.empty);
+
+  auto key = generic_hash(&font, glyph.index);
+  if (auto it = _lookup.find(key); it != _lookup.end())
+  {
+    _entries.splice(_entries.begin(), _entries, it->second);
+    it->second->frame = _frame;
+    return it->second->ready ? std::optional{ it->second->glyph } : std::nullopt;
+  }
+
+  auto cell = uint32_t{};
+  if (!_free_cells.empty())
+  {
+    cell = _free_cells.back();
+    _free_cells.pop_back();
+  }
+  else
+  {
+    // least recently used ready one, stop at entries of current frame as all the ones before them are also used
+    auto it = std::ranges::find_if(_entries | std::views::reverse, [this](auto const& entry) { return entry.ready || entry.frame == _frame; });
+    if (it == _entries.rend() || it->frame == _frame) return {};
+    cell = it->cell;
+    _lookup.erase(it->key);
+    _entries.erase(std::next(it).base());
+  }
+
+  // msdf of glyph is at most em size, large glyphs are shrunk to fit cell with distance range around it,
+  // region starts a pixel inside cell, so filtering never reads neighbor cells
+  auto pad    = Distance_Range / 2.f;
+  auto inner  = Cell_Size - 2.f - pad * 2.f;
+  auto box    = glyph.max - glyph.min;
+  auto scale  = std::min(Em_Size, inner / std::max({ box.x, box.y, 1.f / Em_Size }));
+  auto extent = glm::vec<2, uint32_t>
+  {
+    std::min(static_cast<uint32_t>(std::ceil(box.x * scale + pad * 2.f)), Cell_Size - 2),
+    std::min(static_cast<uint32_t>(std::ceil(box.y * scale + pad * 2.f)), Cell_Size - 2),
+  };
+  auto pos = glm::vec<2, uint32_t>{ cell % Cell_Per_Row * Cell_Size + 1, cell / Cell_Per_Row * Cell_Size + 1 };
+
+  auto& entry = _entries.emplace_front(key, cell, _frame);
+  _lookup[key] = _entries.begin();
+  entry.glyph.uv_min = glm::vec2{ pos } / static_cast<float>(Atlas_Size);
+  entry.glyph.uv_max = glm::vec2{ pos + extent } / static_cast<float>(Atlas_Size);
+  entry.glyph.offset = glyph.min - pad / scale;
+  entry.glyph.extent = glm::vec2{ extent } / scale;
+  entry.glyph.range  = Distance_Range / scale;
+  entry.glyph.use    = { key, ++_version };
+
+  {
+    auto lock = std::lock_guard{ _mutex };
+    _jobs.emplace_back(entry.glyph.use, &font, glyph.index, scale, entry.glyph.offset, GlyphUpload{ pos, extent });
+  }
+  _job_cv.notify_one();
+
+  if (_workers.empty())
+  {
+    // main thread keeps recording, so only take part of cores
+    auto count = std::clamp(std::thread::hardware_concurrency() / 2, 1u, 4u);
+    for (auto i = 0u; i < count; ++i)
+      _workers.emplace_back([this](std::stop_token token) { work(token); });
+  }
+  return {};
+}
+
+auto GlyphCache::touch(std::span<Use const> uses) noexcept -> bool
+{
+  for (auto const& use : uses)
+  {
+    auto it = _lookup.find(use.key);
+    if (it == _lookup.end() || it->second->glyph.use.version != use.version) return false;
+    _entries.splice(_entries.begin(), _entries, it->second);
+    it->second->frame = _frame;
+  }
+  return true;
+}
+
+void GlyphCache::work(std::stop_token token) noexcept
+{
+  while (true)
+  {
+    auto job = Job{};
+    {
+      auto lock = std::unique_lock{ _mutex };
+      if (!_job_cv.wait(lock, token, [this] { return !_jobs.empty(); })) return;
+      job = std::move(_jobs.front());
+      _jobs.pop_front();
+    }
+
+    // outline is in ems, move it to pixels of region
+    auto outline = job.font->outline(job.glyph_index, Curve_Tolerance / job.scale);
+    for (auto& contour : outline)
+      for (auto& edge : contour)
+        for (auto& point : edge)
+          point = (point - job.origin) * job.scale;
+    job.upload.pixels = generate_msdf(outline, job.upload.extent, Distance_Range);
+
+    auto lock = std::lock_guard{ _mutex };
+    _done.emplace_back(job.use, std::move(job.upload));
+  }
+}
+
+}}
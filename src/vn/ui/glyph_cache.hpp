@@ -0,0 +1,122 @@
+#pragma once
+
+#include "font.hpp"
+#include "../renderer/config.hpp"
+
+#include <glm/glm.hpp>
+
+#include <list>
+#include <deque>
+#include <unordered_map>
+#include <vector>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <cstdint>
+
+namespace vn { namespace ui {
+
+/// rasterized glyph to copy into atlas of renderer
+struct GlyphUpload
+{
+  glm::vec<2, uint32_t> pos{};
+  glm::vec<2, uint32_t> extent{};
+  std::vector<uint8_t>  pixels; // rgba8, row major
+};
+
+/**
+ * lru bookkeeping of glyph atlas, renderer owns the atlas image and copies the glyphs this cache rasterizes
+ * atlas is divided into square cells of same size, every glyph takes one cell at most em size of pixels,
+ * its msdf keeps edges sharp when text of any size samples it
+ * missing glyphs are rasterized by workers and are ready from a later frame, text skips them until then
+ * cells used in current frame or still rasterizing are never evicted
+ * cpu only, drive it by fonts and check returned glyphs and uploads
+ */
+class GlyphCache
+{
+public:
+  static constexpr auto Atlas_Size      = static_cast<uint32_t>(renderer::Glyph_Atlas_Size);
+  static constexpr auto Cell_Size       = static_cast<uint32_t>(renderer::Glyph_Cell_Size);
+  static constexpr auto Cell_Per_Row    = Atlas_Size / Cell_Size;
+  static constexpr auto Cell_Count      = Cell_Per_Row * Cell_Per_Row;
+  static constexpr auto Em_Size         = static_cast<float>(renderer::Glyph_Em_Size);
+  static constexpr auto Distance_Range  = static_cast<float>(renderer::Glyph_Distance_Range);
+  static constexpr auto Curve_Tolerance = 0.1f; // pixels of atlas
+
+  /// glyph drawn by text, kept by static blocks to use it again without acquiring
+  struct Use
+  {
+    size_t   key{};
+    uint32_t version{};
+  };
+
+  /// geometry in ems from pen position on baseline, so it scales by pixel size of text
+  struct Glyph
+  {
+    glm::vec2 uv_min{};
+    glm::vec2 uv_max{};
+    glm::vec2 offset{}; // left top of quad
+    glm::vec2 extent{}; // quad covering msdf of glyph
+    float     range{};  // distance encoded across msdf
+    Use       use;      // version changes whenever its cell is given to another glyph
+  };
+
+  GlyphCache() noexcept;
+
+  /// @return font of file, loaded at first use and kept until exit
+  auto font(std::string_view filename) noexcept -> Font&;
+
+  /// glyphs acquired after this are kept until next frame, rasterized glyphs are appended to uploads
+  void begin_frame(std::vector<GlyphUpload>& uploads) noexcept;
+
+  /// @return glyph in atlas, empty if it is still rasterizing or every cell is used by current frame
+  auto acquire(Font const& font, Font::Glyph const& glyph) noexcept -> std::optional<Glyph>;
+
+  /// mark glyphs used in current frame like acquire, @return whether all of them are still in their cells
+  auto touch(std::span<Use const> uses) noexcept -> bool;
+
+  /// increases whenever glyphs become ready, content drawn while glyphs missing is stale until it changes
+  auto ready_count() const noexcept { return _ready_count; }
+
+private:
+  struct Entry
+  {
+    size_t   key{};
+    uint32_t cell{};
+    uint64_t frame{}; // last frame used
+    Glyph    glyph;
+    bool     ready{}; // msdf is uploaded with frame
+  };
+
+  struct Job
+  {
+    Use                   use;
+    Font const*           font{};
+    int                   glyph_index{};
+    float                 scale{};  // atlas pixels per em
+    glm::vec2             origin{}; // em position of left top pixel
+    GlyphUpload           upload;
+  };
+
+  void work(std::stop_token token) noexcept;
+
+  std::unordered_map<std::string, Font>                  _fonts; // outlive workers using them
+  std::list<Entry>                                       _entries; // most recently used first
+  std::unordered_map<size_t, std::list<Entry>::iterator> _lookup;
+  std::vector<uint32_t>                                  _free_cells;
+  uint64_t                                               _frame{};
+  uint32_t                                               _version{};
+  uint32_t                                               _ready_count{};
+
+  std::mutex                                             _mutex;
+  std::condition_variable_any                            _job_cv;
+  std::deque<Job>                                        _jobs;
+  std::vector<std::pair<Use, GlyphUpload>>               _done;
+  std::vector<std::jthread>                              _workers; // started at first job, stopped first on destroy
+};
+
+}}
@@ -0,0 +1,89 @@
+#include "hit_grid.hpp"
+
+#include <ranges>
+#include <algorithm>
+
+namespace vn { namespace ui {
+
+void HitGrid::reset(glm::vec<2, uint32_t> extent) noexcept
+{
+  auto cell_count = glm::vec<2, int>
+  {
+    std::max((static_cast<int>(extent.x) + Cell_Size - 1) / Cell_Size, 1),
+    std::max((static_cast<int>(extent.y) + Cell_Size - 1) / Cell_Size, 1),
+  };
+  if (cell_count != _cell_count)
+  {
+    _cell_count = cell_count;
+    _cells.assign(static_cast<size_t>(cell_count.x) * cell_count.y, {});
+  }
+  else
+  {
+    // cells keep their capacity, next recording mostly inserts same widgets
+    for (auto cell : _touched_cells)
+      _cells[cell].clear();
+  }
+  _touched_cells.clear();
+  _widgets.clear();
+  _extent = glm::vec2{ extent };
+}
+
+void HitGrid::insert(size_t id, glm::vec2 left_top, glm::vec2 right_bottom) noexcept
+{
+  left_top     = glm::max(left_top, glm::vec2{});
+  right_bottom = glm::min(right_bottom, _extent);
+  if (left_top.x > right_bottom.x || left_top.y > right_bottom.y) return;
+
+  auto index = static_cast<uint32_t>(_widgets.size());
+  _widgets.emplace_back(id, left_top, right_bottom);
+
+  auto cell_min = cell_of(left_top);
+  auto cell_max = cell_of(right_bottom);
+  for (auto y = cell_min.y; y <= cell_max.y; ++y)
+    for (auto x = cell_min.x; x <= cell_max.x; ++x)
+    {
+      auto  cell    = static_cast<uint32_t>(y * _cell_count.x + x);
+      auto& widgets = _cells[cell];
+      if (widgets.empty())
+        _touched_cells.emplace_back(cell);
+      widgets.emplace_back(index);
+    }
+}
+
+auto HitGrid::query(glm::vec2 point) const noexcept -> std::optional<size_t>
+{
+  return query_index(point).transform([&](auto index) { return _widgets[index].id; });
+}
+
+auto HitGrid::query_index(glm::vec2 point) const noexcept -> std::optional<uint32_t>
+{
+  if (point.x < 0.f || point.y < 0.f || point.x > _extent.x || point.y > _extent.y) return {};
+
+  auto cell = cell_of(point);
+  for (auto index : _cells[cell.y * _cell_count.x + cell.x] | std::views::reverse)
+  {
+    auto const& widget = _widgets[index];
+    if (point.x >= widget.left_top.x && point.x <= widget.right_bottom.x &&
+        point.y >= widget.left_top.y && point.y <= widget.right_bottom.y)
+      return index;
+  }
+  return {};
+}
+
+auto HitGrid::query_click(glm::vec2 down, glm::vec2 up) const noexcept -> std::optional<size_t>
+{
+  auto widget = query(up);
+  return widget == query(down) ? widget : std::nullopt;
+}
+
+auto HitGrid::cell_of(glm::vec2 point) const noexcept -> glm::vec<2, int>
+{
+  // right and bottom edges of window belong to last cells
+  return
+  {
+    std::clamp(static_cast<int>(point.x) / Cell_Size, 0, _cell_count.x - 1),
+    std::clamp(static_cast<int>(point.y) / Cell_Size, 0, _cell_count.y - 1),
+  };
+}
+
+}}
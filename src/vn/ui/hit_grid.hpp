@@ -0,0 +1,58 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <vector>
+#include <optional>
+#include <cstdint>
+
+namespace vn { namespace ui {
+
+/**
+ * uniform grid of widget rectangles in a window, widgets are inserted while recording in z order,
+ * so the one inserted last is top-most, cursor is resolved by scanning only its cell from top
+ * only cells touched by last recording are cleared, so cost follows widget count rather than window size
+ * window queries the grid of last recording before inserting widgets again, widgets drawn later are not known
+ * while earlier ones ask for hover, so a widget appearing, moving or raised under cursor is hovered one recording later
+ * cpu only, insert rectangles and check queried ids
+ */
+class HitGrid
+{
+public:
+  static constexpr auto Cell_Size = 64; // pixels
+
+  /// drop widgets of last recording and cover window of extent
+  void reset(glm::vec<2, uint32_t> extent) noexcept;
+
+  /// add widget on top of widgets inserted before it, part outside of window is dropped
+  void insert(size_t id, glm::vec2 left_top, glm::vec2 right_bottom) noexcept;
+
+  /// @return id of top-most widget containing point, edges included
+  auto query(glm::vec2 point) const noexcept -> std::optional<size_t>;
+
+  /// @return z order of top-most widget containing point, which is count of widgets inserted before it
+  auto query_index(glm::vec2 point) const noexcept -> std::optional<uint32_t>;
+
+  /// @return id of widget top-most at both press and release position, so releasing on another widget not clicks
+  auto query_click(glm::vec2 down, glm::vec2 up) const noexcept -> std::optional<size_t>;
+
+  auto size() const noexcept { return _widgets.size(); }
+
+private:
+  struct Widget
+  {
+    size_t    id{};
+    glm::vec2 left_top{};
+    glm::vec2 right_bottom{};
+  };
+
+  auto cell_of(glm::vec2 point) const noexcept -> glm::vec<2, int>;
+
+  glm::vec2                          _extent{};
+  glm::vec<2, int>                   _cell_count{};
+  std::vector<Widget>                _widgets;       // index is z order
+  std::vector<std::vector<uint32_t>> _cells;         // widget indices in z order, row major
+  std::vector<uint32_t>              _touched_cells; // cells not empty
+};
+
+}}
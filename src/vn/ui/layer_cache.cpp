@@ -0,0 +1,60 @@
+#include "layer_cache.hpp"
+#include "../util.hpp"
+
+namespace vn { namespace ui {
+
+auto layer_image_extent(glm::vec<2, uint32_t> extent) noexcept -> glm::vec<2, uint32_t>
+{
+  return { align(extent.x, renderer::Layer_Granularity), align(extent.y, renderer::Layer_Granularity) };
+}
+
+auto layer_byte_size(glm::vec<2, uint32_t> extent) noexcept -> uint64_t
+{
+  // bgra8 render target and texture copied from it
+  auto image_extent = layer_image_extent(extent);
+  return static_cast<uint64_t>(image_extent.x) * image_extent.y * 4 * 2;
+}
+
+auto LayerCache::acquire(size_t id, size_t key, glm::vec<2, uint32_t> extent) noexcept -> Layer
+{
+  if (auto it = _lookup.find(id); it != _lookup.end())
+  {
+    auto& entry = *it->second;
+    _entries.splice(_entries.begin(), _entries, it->second);
+    entry.frame = _frame;
+    if (entry.key == key && entry.extent == extent)
+    {
+      ++_stats.hit_count;
+      return { entry.version, false };
+    }
+
+    ++_stats.miss_count;
+    _byte_size   += layer_byte_size(extent) - layer_byte_size(entry.extent);
+    entry.key     = key;
+    entry.extent  = extent;
+    entry.version = ++_version;
+    return { entry.version, true };
+  }
+
+  ++_stats.miss_count;
+  _byte_size += layer_byte_size(extent);
+  _entries.emplace_front(id, key, extent, ++_version, _frame);
+  _lookup[id] = _entries.begin();
+  return { _version, true };
+}
+
+void LayerCache::evict(std::vector<size_t>& released) noexcept
+{
+  // layers of current frame lead the list, so eviction stops at the first one
+  while ((_byte_size > Memory_Budget || _entries.size() > Max_Count) && !_entries.empty() && _entries.back().frame != _frame)
+  {
+    auto const& entry = _entries.back();
+    _byte_size -= layer_byte_size(entry.extent);
+    released.emplace_back(entry.id);
+    _lookup.erase(entry.id);
+    _entries.pop_back();
+    ++_stats.evicted_count;
+  }
+}
+
+}}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "window_render_data.hpp"
+#include "../renderer/config.hpp"
+
+#include <glm/glm.hpp>
+
+#include <list>
+#include <unordered_map>
+#include <vector>
+#include <cstdint>
+
+namespace vn { namespace ui {
+
+/// content of layer to render into its image, shapes are in window coordinates, origin maps to left top of image
+struct LayerRender
+{
+  size_t                id{};
+  glm::vec2             origin{};
+  glm::vec<2, uint32_t> extent{};
+  WindowRenderData      content;
+};
+
+/// extent of layer image, aligned by granularity so layers of similar extent reuse images of each other
+auto layer_image_extent(glm::vec<2, uint32_t> extent) noexcept -> glm::vec<2, uint32_t>;
+
+/// bytes of render target and texture of layer
+auto layer_byte_size(glm::vec<2, uint32_t> extent) noexcept -> uint64_t;
+
+/**
+ * lru bookkeeping of layer images, renderer owns the images and renders layers this cache asks for
+ * layer is rendered again only when its key or extent changes, or after it was evicted
+ * layers used in current frame are never evicted, so budget may be exceeded until they are unused
+ * cpu only, drive it by ids and keys and check versions and stats
+ */
+class LayerCache
+{
+public:
+  static constexpr auto Memory_Budget = static_cast<uint64_t>(renderer::Layer_Memory_Budget);
+  static constexpr auto Max_Count     = static_cast<size_t>(renderer::Max_Layer_Count);
+
+  struct Layer
+  {
+    uint32_t version{};     // changes whenever content of layer image changes
+    bool     need_render{}; // image not holds content of key yet
+  };
+
+  struct Stats
+  {
+    uint64_t hit_count{};
+    uint64_t miss_count{};
+    uint64_t evicted_count{};
+  };
+
+  /// layers acquired after this are kept until next frame
+  void begin_frame() noexcept { ++_frame; }
+
+  auto acquire(size_t id, size_t key, glm::vec<2, uint32_t> extent) noexcept -> Layer;
+
+  /**
+   * evict least recently used layers until memory and count are under budget, call after recording of frame
+   * @param released ids of evicted layers are appended, renderer returns their images to its pool
+   */
+  void evict(std::vector<size_t>& released) noexcept;
+
+  auto stats()     const noexcept { return _stats;     }
+  auto byte_size() const noexcept { return _byte_size; }
+
+private:
+  struct Entry
+  {
+    size_t                id{};
+    size_t                key{};
+    glm::vec<2, uint32_t> extent{};
+    uint32_t              version{};
+    uint64_t              frame{}; // last frame used
+  };
+
+  std::list<Entry>                                       _entries; // most recently used first
+  std::unordered_map<size_t, std::list<Entry>::iterator> _lookup;
+  uint64_t                                               _byte_size{};
+  uint32_t                                               _version{};
+  uint64_t                                               _frame{};
+  Stats                                                  _stats;
+};
+
+}}
@@ -52,6 +52,14 @@ public:
     _is_reversed = !_is_reversed;
   }
 
+  // drop pending event of timer, must call before destroying a running animation
+  void stop() noexcept
+  {
+    if (_state == State::running && _timer->contains(_event))
+      _timer->remove_event(_event);
+    _state = State::idle;
+  }
+
   auto state() const noexcept { return _state; }
 
   auto is_reversed() const noexcept { return _is_reversed; }
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "../hash.hpp"
+
+#include <cstdint>
+
+namespace vn { namespace ui {
+
+/**
+ * glyphs still rasterizing and images still uploading are skipped when drawn, they appear from a later frame
+ * content kept across frames, like static blocks and layers, takes a snapshot of counts before recording,
+ * content whose counts grew since then misses some of them and is stale
+ * cpu only, count skipped content and check snapshots
+ */
+struct MissingContent
+{
+  uint32_t glyph_count{};
+  uint32_t image_count{};
+
+  /// whether content recorded since snapshot skipped glyphs or images
+  auto missed_since(MissingContent const& snapshot) const noexcept { return *this != snapshot; }
+
+  /**
+   * key of content recorded since snapshot, it changes once skipped glyphs or images become ready
+   * @param glyph_ready_count increases whenever glyphs become ready
+   * @param image_uploaded_count increases whenever images become uploaded
+   */
+  auto stale_key(MissingContent const& snapshot, size_t key, uint32_t glyph_ready_count, uint32_t image_uploaded_count) const noexcept
+  {
+    if (glyph_count != snapshot.glyph_count)
+      key = generic_hash(key, glyph_ready_count);
+    if (image_count != snapshot.image_count)
+      key = generic_hash(key, image_uploaded_count);
+    return key;
+  }
+
+  bool operator==(MissingContent const&) const noexcept = default;
+};
+
+}}
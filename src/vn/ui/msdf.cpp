@@ -0,0 +1,297 @@
+#include "msdf.hpp"
+
+#include <algorithm>
+#include <array>
+#include <ranges>
+#include <cmath>
+#include <limits>
+#include <assert.h>
+
+using namespace vn::ui;
+
+namespace
+{
+
+// channels of edge color
+constexpr auto Red   = 1u;
+constexpr auto Green = 2u;
+constexpr auto Blue  = 4u;
+constexpr auto White = Red | Green | Blue;
+
+// corner when directions turn more than this, it is sin of 3 radians
+constexpr auto Corner_Cross_Threshold = 0.1411f;
+
+struct Edge
+{
+  std::vector<glm::vec2> points;
+  uint32_t               color{ White };
+};
+
+/// closest point on edge, dot is how far pixel is from being orthogonal to edge at it, lower one has more reliable sign
+struct EdgeDistance
+{
+  float distance{ std::numeric_limits<float>::max() }; // signed, positive on left of edge
+  float dot{};
+  float param{}; // < 0 before start of edge, > 1 after end, else on edge
+
+  auto operator<(EdgeDistance const& other) const noexcept
+  {
+    auto a = std::abs(distance);
+    auto b = std::abs(other.distance);
+    return a < b || (a == b && dot < other.dot);
+  }
+};
+
+auto cross(glm::vec2 a, glm::vec2 b) noexcept { return a.x * b.y - a.y * b.x; }
+
+auto normalize(glm::vec2 v) noexcept
+{
+  auto length = glm::length(v);
+  return length > 0.f ? v / length : glm::vec2{};
+}
+
+auto start_direction(Edge const& edge) noexcept { return normalize(edge.points[1] - edge.points[0]); }
+auto end_direction(Edge const& edge)   noexcept { return normalize(edge.points.back() - edge.points[edge.points.size() - 2]); }
+
+auto is_corner(glm::vec2 a, glm::vec2 b) noexcept
+{
+  return glm::dot(a, b) <= 0.f || std::abs(cross(a, b)) > Corner_Cross_Threshold;
+}
+
+/// next color of cycle cyan, magenta, yellow, channel shared with banned color is kept out
+auto switch_color(uint32_t color, uint32_t banned = {}) noexcept -> uint32_t
+{
+  auto combined = color & banned;
+  if (combined == Red || combined == Green || combined == Blue)
+    return combined ^ White;
+  if (color == White || color == 0)
+    return Green | Blue;
+  auto shifted = color << 1;
+  return (shifted | shifted >> 3) & White;
+}
+
+/// split polyline into three by length, so teardrops have enough edges to color
+auto split_in_three(std::vector<glm::vec2> const& points) noexcept -> std::array<std::vector<glm::vec2>, 3>
+{
+  auto length = 0.f;
+  for (auto i = 1u; i < points.size(); ++i)
+    length += glm::length(points[i] - points[i - 1]);
+
+  auto parts   = std::array<std::vector<glm::vec2>, 3>{};
+  auto part    = 0u;
+  auto walked  = 0.f;
+  parts[0].emplace_back(points[0]);
+  for (auto i = 1u; i < points.size(); ++i)
+  {
+    auto a  = points[i - 1];
+    auto b  = points[i];
+    auto ab = glm::length(b - a);
+    while (part < 2 && walked + ab >= length * (part + 1) / 3.f)
+    {
+      auto t     = ab > 0.f ? (length * (part + 1) / 3.f - walked) / ab : 0.f;
+      auto point = a + (b - a) * t;
+      parts[part].emplace_back(point);
+      parts[++part].emplace_back(point);
+    }
+    parts[part].emplace_back(b);
+    walked += ab;
+  }
+  return parts;
+}
+
+/// color edges so that the two edges at every corner share only one channel
+void color_edges(std::vector<Edge>& edges) noexcept
+{
+  auto corners = std::vector<uint32_t>{};
+  for (auto i = 0u; i < edges.size(); ++i)
+    if (is_corner(end_direction(edges[(i + edges.size() - 1) % edges.size()]), start_direction(edges[i])))
+      corners.emplace_back(i);
+
+  // smooth contour, every channel sees whole of it
+  if (corners.empty()) return;
+
+  if (corners.size() == 1)
+  {
+    // teardrop, two colors meet at corner and white is between them
+    if (edges.size() < 3)
+    {
+      auto splitted = std::vector<Edge>{};
+      for (auto const& edge : edges)
+        for (auto& points : split_in_three(edge.points))
+          splitted.emplace_back(std::move(points));
+      edges = std::move(splitted);
+      corners[0] *= 3;
+    }
+    constexpr auto Colors = std::array{ Red | Blue, White, Red | Green };
+    auto m = static_cast<uint32_t>(edges.size());
+    for (auto i = 0u; i < m; ++i)
+      edges[(corners[0] + i) % m].color = Colors[static_cast<int>(3.f + 2.875f * i / (m - 1) - 1.4375f + .5f) - 2];
+    return;
+  }
+
+  // color changes at every corner, last run avoids channel of first one as they also meet
+  auto color   = switch_color(White);
+  auto initial = color;
+  auto spline  = 0u;
+  for (auto i = 0u; i < edges.size(); ++i)
+  {
+    auto index = (corners[0] + i) % edges.size();
+    if (spline + 1 < corners.size() && corners[spline + 1] == index)
+    {
+      ++spline;
+      color = switch_color(color, spline == corners.size() - 1 ? initial : 0u);
+    }
+    edges[index].color = color;
+  }
+}
+
+auto edge_distance(Edge const& edge, glm::vec2 p) noexcept -> EdgeDistance
+{
+  auto result = EdgeDistance{};
+  auto last   = edge.points.size() - 2;
+  for (auto i = 0u; i <= last; ++i)
+  {
+    auto a  = edge.points[i];
+    auto ab = edge.points[i + 1] - a;
+    auto ap = p - a;
+    auto l2 = glm::dot(ab, ab);
+    if (l2 == 0.f) continue;
+
+    // parameter is only kept out of [0, 1] at ends of edge
+    auto t       = glm::dot(ap, ab) / l2;
+    auto clamped = std::clamp(t, 0.f, 1.f);
+    auto q       = a + ab * clamped;
+    auto d       = glm::length(p - q);
+    auto sign    = cross(ab, p - q) >= 0.f ? 1.f : -1.f;
+    auto dot     = t == clamped ? 0.f : std::abs(glm::dot(normalize(ab), normalize(p - q)));
+
+    auto distance = EdgeDistance{ d * sign, dot, t };
+    if (distance < result)
+    {
+      result = distance;
+      if (i != 0    && result.param < 0.f) result.param = 0.f;
+      if (i != last && result.param > 1.f) result.param = 1.f;
+    }
+  }
+  return result;
+}
+
+/// extend ends of edge to lines, so distances of channels meet at corners rather than rounding them
+auto pseudo_distance(Edge const& edge, EdgeDistance distance, glm::vec2 p) noexcept
+{
+  auto extend = [&](glm::vec2 point, glm::vec2 dir, bool before)
+  {
+    auto ap = p - point;
+    auto ts = glm::dot(ap, dir);
+    if (before ? ts < 0.f : ts > 0.f)
+    {
+      auto perpendicular = cross(dir, ap);
+      if (std::abs(perpendicular) <= std::abs(distance.distance))
+        distance.distance = perpendicular;
+    }
+  };
+  if (distance.param < 0.f)
+    extend(edge.points[0], start_direction(edge), true);
+  else if (distance.param > 1.f)
+    extend(edge.points.back(), end_direction(edge), false);
+  return distance.distance;
+}
+
+auto median(float a, float b, float c) noexcept
+{
+  return std::max(std::min(a, b), std::min(std::max(a, b), c));
+}
+
+auto area(std::vector<Edge> const& contour) noexcept
+{
+  auto area = 0.f;
+  for (auto const& edge : contour)
+    for (auto i = 1u; i < edge.points.size(); ++i)
+      area += cross(edge.points[i - 1], edge.points[i]);
+  return area * .5f;
+}
+
+}
+
+namespace vn { namespace ui {
+
+auto generate_msdf(GlyphOutline const& outline, glm::vec<2, uint32_t> extent, float range) noexcept -> std::vector<uint8_t>
+{
+  assert(range > 0.f);
+
+  auto pixels = std::vector<uint8_t>(static_cast<size_t>(extent.x) * extent.y * 4);
+
+  // drop repeated points and degenerated edges, they have no direction to color or sign
+  auto contours = std::vector<std::vector<Edge>>{};
+  for (auto const& contour : outline)
+  {
+    auto edges = std::vector<Edge>{};
+    for (auto const& points : contour)
+    {
+      auto edge = Edge{};
+      for (auto point : points)
+        if (edge.points.empty() || edge.points.back() != point)
+          edge.points.emplace_back(point);
+      if (edge.points.size() >= 2)
+        edges.emplace_back(std::move(edge));
+    }
+    if (edges.empty()) continue;
+    color_edges(edges);
+    contours.emplace_back(std::move(edges));
+  }
+
+  // pixels are zero, so empty glyph is outside everywhere
+  if (contours.empty()) return pixels;
+
+  // sign of edges follows orientation of contours, outer contour decides which side is inside
+  auto orientation = std::ranges::max(contours | std::views::transform(area), {}, [](auto a) { return std::abs(a); }) >= 0.f ? 1.f : -1.f;
+
+  auto edges = contours | std::views::join | std::ranges::to<std::vector>();
+
+  auto encode = [range](float distance)
+  {
+    return static_cast<uint8_t>(std::clamp(0.5f + distance / range, 0.f, 1.f) * 255.f + .5f);
+  };
+
+  for (auto y = 0u; y < extent.y; ++y)
+    for (auto x = 0u; x < extent.x; ++x)
+    {
+      auto p = glm::vec2{ x + .5f, y + .5f };
+
+      // closest edge of every channel, and closest one of all for true distance
+      auto closest       = std::array<EdgeDistance, 3>{};
+      auto closest_edges = std::array<Edge const*, 3>{};
+      auto true_distance = EdgeDistance{};
+      for (auto const& edge : edges)
+      {
+        auto distance = edge_distance(edge, p);
+        if (distance < true_distance)
+          true_distance = distance;
+        for (auto channel = 0u; channel < 3; ++channel)
+          if (edge.color & (1u << channel) && distance < closest[channel])
+          {
+            closest[channel]       = distance;
+            closest_edges[channel] = &edge;
+          }
+      }
+
+      auto channels = std::array<float, 3>{};
+      for (auto channel = 0u; channel < 3; ++channel)
+        channels[channel] = closest_edges[channel] ? pseudo_distance(*closest_edges[channel], closest[channel], p) * orientation : -range;
+      auto distance = true_distance.distance * orientation;
+
+      // channels clash where edges of same color are close, trust true distance there
+      if ((median(channels[0], channels[1], channels[2]) >= 0.f) != (distance >= 0.f))
+        channels.fill(distance);
+
+      auto pixel = pixels.data() + (static_cast<size_t>(y) * extent.x + x) * 4;
+      pixel[0] = encode(channels[0]);
+      pixel[1] = encode(channels[1]);
+      pixel[2] = encode(channels[2]);
+      pixel[3] = encode(distance);
+    }
+
+  return pixels;
+}
+
+}}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <vector>
+#include <cstdint>
+
+namespace vn { namespace ui {
+
+/// contours of edges, every edge is a polyline from its start to its end, corners only lie between edges
+using GlyphOutline = std::vector<std::vector<std::vector<glm::vec2>>>;
+
+/**
+ * multi-channel signed distance field of outline
+ * edges are colored so that channels of the two edges at every corner differ, each channel only measures edges of
+ * its color, so median of channels keeps corners sharp when the field is magnified, see get_glyph_color of shader
+ * channels are rgb and alpha is true distance, distance is encoded as 0.5 + distance / range and is positive inside
+ * pixels whose median disagrees with true distance about inside take true distance, so clashing channels not leave holes
+ * cpu only, generate outlines and check pixels
+ * @param outline in pixels of bitmap, orientation of contours not matters
+ * @param extent of bitmap
+ * @param range distance in pixels encoded across [0, 1]
+ * @return rgba8 pixels, row major
+ */
+auto generate_msdf(GlyphOutline const& outline, glm::vec<2, uint32_t> extent, float range) noexcept -> std::vector<uint8_t>;
+
+}}
@@ -0,0 +1,52 @@
+#include "scroll_list.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace vn { namespace ui {
+
+void ListIndex::update(uint32_t item_count, std::function<float(uint32_t)> const& item_height, uint32_t version) noexcept
+{
+  if (version != _version)
+  {
+    _tops.resize(1);
+    _version = version;
+  }
+
+  // removed items only drop their tops, appended ones are measured
+  if (item_count < count())
+    _tops.resize(item_count + 1);
+  _tops.reserve(item_count + 1);
+  for (auto i = count(); i < item_count; ++i)
+    _tops.emplace_back(_tops.back() + item_height(i));
+}
+
+auto ListIndex::range(float top, float bottom) const noexcept -> std::pair<uint32_t, uint32_t>
+{
+  // first item whose bottom is under top, and first item whose top is at or under bottom
+  auto first = std::ranges::upper_bound(_tops.begin() + 1, _tops.end(), top) - _tops.begin() - 1;
+  auto last  = std::ranges::lower_bound(_tops.begin(), _tops.end() - 1, bottom) - _tops.begin();
+  return { static_cast<uint32_t>(first), static_cast<uint32_t>(std::max(first, last)) };
+}
+
+void ScrollState::update(float notches, float delta_time, float max_offset) noexcept
+{
+  // distance of velocity until stop is velocity / friction
+  velocity -= notches * Scroll_Distance_Of_Notch * Scroll_Friction;
+
+  // exact integration of exponential decay
+  auto decay = std::exp(-Scroll_Friction * delta_time);
+  offset   += velocity / Scroll_Friction * (1.f - decay);
+  velocity *= decay;
+  if (std::abs(velocity) < Scroll_Min_Velocity)
+    velocity = 0.f;
+
+  auto clamped = std::clamp(offset, 0.f, std::max(max_offset, 0.f));
+  if (clamped != offset)
+  {
+    offset   = clamped;
+    velocity = 0.f;
+  }
+}
+
+}}
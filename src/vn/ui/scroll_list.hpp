@@ -0,0 +1,54 @@
+#pragma once
+
+#include <functional>
+#include <utility>
+#include <vector>
+#include <cstdint>
+
+namespace vn { namespace ui {
+
+constexpr auto Scroll_Friction          = 8.f;   // velocity decays by exp(-friction * seconds)
+constexpr auto Scroll_Distance_Of_Notch = 100.f; // pixels one wheel notch scrolls until kinetic scrolling stops
+constexpr auto Scroll_Min_Velocity      = 5.f;   // pixels per second, slower scrolling stops
+constexpr auto List_Overscan_Count      = 2u;    // items recorded beyond each side of view
+
+/**
+ * prefix sums of item heights, items are measured once and visible ones are found by binary search,
+ * so cost of a frame not grows with item count
+ * cpu only, drive it by heights and check tops and ranges
+ */
+class ListIndex
+{
+public:
+  /// measure items appended since last update, all items are measured again when version changes
+  void update(uint32_t item_count, std::function<float(uint32_t)> const& item_height, uint32_t version) noexcept;
+
+  auto count()                 const noexcept { return static_cast<uint32_t>(_tops.size() - 1); }
+  auto height()                const noexcept { return _tops.back();                            }
+  auto item_top(uint32_t i)    const noexcept { return _tops[i];                                }
+  auto item_height(uint32_t i) const noexcept { return _tops[i + 1] - _tops[i];                 }
+
+  /// @return [first, last) items overlapping [top, bottom)
+  auto range(float top, float bottom) const noexcept -> std::pair<uint32_t, uint32_t>;
+
+private:
+  std::vector<float> _tops{ 0.f }; // top of every item then bottom of last one
+  uint32_t           _version{};
+};
+
+/// offset and kinetic velocity of scrolling, advanced by frame time so speed not depends on frame rate
+struct ScrollState
+{
+  float offset{};
+  float velocity{}; // pixels per second
+
+  /**
+   * @param notches wheel notches since last frame, positive scrolls up
+   * @param max_offset offset is clamped into [0, max_offset], velocity stops at the bounds
+   */
+  void update(float notches, float delta_time, float max_offset) noexcept;
+
+  auto scrolling() const noexcept { return velocity != 0.f; }
+};
+
+}}
@@ -4,6 +4,9 @@
 #include "error_handling.hpp"
 #include "lerp_animation.hpp"
 #include "../renderer/image.hpp"
+#include "../renderer/renderer.hpp"
+
+#include <utf8.h>
 
 #include <ranges>
 
@@ -51,16 +54,18 @@ auto get_bounding_rectangle(std::vector<glm::vec2> const& data) noexcept -> std:
   return { min, max };
 }
 
-void add_shape(
+/// @return whether shape property is recorded, shape out of union which is fully clipped records nothing
+auto add_shape(
   ShapeProperty::Type                    type,
   glm::vec4                              color,
   float                                  thickness,
   std::vector<float> const&              values,
-  std::pair<glm::vec2, glm::vec2> const& bounding_rectangle) noexcept
+  std::pair<glm::vec2, glm::vec2> const& bounding_rectangle) noexcept -> bool
 {
   auto ctx        = UIContext::instance();
   auto [min, max] = bounding_rectangle;
 
+  ctx->shape_culled = false;
   if (ctx->op_data.op == ShapeProperty::Operator::u)
   {
     ctx->op_data.points.emplace_back(min);
@@ -68,10 +73,72 @@ void add_shape(
     goto add_shape_property;
   }
 
-  add_vertices_indices(bounding_rectangle);
+  // no quad references the property, so it is not uploaded either
+  if (!add_vertices_indices(bounding_rectangle))
+  {
+    ctx->shape_culled = true;
+    return false;
+  }
 
 add_shape_property:
   add_shape_property(type, color, thickness, values);
+  return true;
+}
+
+/**
+ * lay out utf-8 text in ems from left top of its first line, lines are broken by '\n'
+ * @param func called by glyph and its pen position on baseline, only for glyphs with outline
+ * @return extent of text in ems
+ */
+template <typename Func>
+auto layout_text(Font& font, std::string_view str, Func&& func) noexcept -> glm::vec2
+{
+  err_if(!utf8::is_valid(str.begin(), str.end()), "text is not valid utf-8");
+
+  auto pen   = glm::vec2{ 0.f, font.ascent() };
+  auto width = 0.f;
+  auto prev  = std::optional<int>{};
+  for (auto it = str.begin(); it != str.end();)
+  {
+    auto codepoint = utf8::unchecked::next(it);
+    if (codepoint == '\n')
+    {
+      width = std::max(width, pen.x);
+      pen   = { 0.f, pen.y + font.line_height() };
+      prev.reset();
+      continue;
+    }
+
+    auto const& glyph = font.glyph(codepoint);
+    if (prev) pen.x += font.kerning(*prev, glyph.index);
+    if (!glyph.empty) func(glyph, pen);
+    pen.x += glyph.advance;
+    prev   = glyph.index;
+  }
+  return { std::max(width, pen.x), pen.y + font.descent() };
+}
+
+/// lines of flattened curve are added into drawing path, outside path they are a path of their own drawn as thin line
+void add_polyline(std::vector<glm::vec2> const& points, glm::vec4 color) noexcept
+{
+  auto ctx       = UIContext::instance();
+  auto data      = std::vector<float>{ std::bit_cast<float>(0u) };
+  auto path_data = ctx->path_draw ? &ctx->path_draw_data : &data;
+
+  (*path_data)[0] = std::bit_cast<float>(std::bit_cast<uint32_t>((*path_data)[0]) + static_cast<uint32_t>(points.size() - 1));
+  for (auto i = 1u; i < points.size(); ++i)
+    path_data->append_range(std::array
+    {
+      std::bit_cast<float>(ShapeProperty::Type::path_line),
+      points[i - 1].x, points[i - 1].y,
+      points[i].x,     points[i].y,
+    });
+
+  // path of thickness 1 is unsigned distance to its lines, same as line shape
+  if (ctx->path_draw)
+    ctx->path_draw_points.append_range(points);
+  else
+    add_shape(ShapeProperty::Type::path, color, 1.f, data, get_bounding_rectangle(points));
 }
 
 }
@@ -98,7 +165,7 @@ auto color_lerp(Color x, Color y, float v) noexcept -> glm::vec4
   };
 }
 
-void add_vertices_indices(std::pair<glm::vec2, glm::vec2> const& bounding_rectangle) noexcept
+auto add_vertices_indices(std::pair<glm::vec2, glm::vec2> const& bounding_rectangle) noexcept -> bool
 {
   auto ctx         = UIContext::instance();
   auto render_data = ctx->current_render_data();
@@ -106,12 +173,27 @@ void add_vertices_indices(std::pair<glm::vec2, glm::vec2> const& bounding_rectan
 
   auto offset = ctx->op_data.op == ShapeProperty::Operator::none ? ctx->shape_properties_offset : ctx->op_data.offset;
 
+  // shapes are evaluated by pixel position, so shrinking quad clips them, uv follows position for images
+  auto uv_min = glm::vec2{ 0.f, 0.f };
+  auto uv_max = glm::vec2{ 1.f, 1.f };
+  if (!ctx->clip_rects.empty())
+  {
+    auto [clip_min, clip_max] = ctx->clip_rects.back();
+    auto clipped_min = glm::max(min, clip_min);
+    auto clipped_max = glm::min(max, clip_max);
+    if (clipped_min.x >= clipped_max.x || clipped_min.y >= clipped_max.y) return false;
+    uv_min = (clipped_min - min) / (max - min);
+    uv_max = (clipped_max - min) / (max - min);
+    min    = clipped_min;
+    max    = clipped_max;
+  }
+
   render_data->vertices.append_range(std::vector<Vertex>
   {
-    { { min.x, min.y, 0.f }, { 0.f, 0.f }, offset },
-    { { max.x, min.y, 0.f }, { 1.f, 0.f }, offset },
-    { { max.x, max.y, 0.f }, { 1.f, 1.f }, offset },
-    { { min.x, max.y, 0.f }, { 0.f, 1.f }, offset },
+    { { min.x, min.y, 0.f }, { uv_min.x, uv_min.y }, offset },
+    { { max.x, min.y, 0.f }, { uv_max.x, uv_min.y }, offset },
+    { { max.x, max.y, 0.f }, { uv_max.x, uv_max.y }, offset },
+    { { min.x, max.y, 0.f }, { uv_min.x, uv_max.y }, offset },
   });
   render_data->indices.append_range(std::vector<uint16_t>
   {
@@ -123,6 +205,7 @@ void add_vertices_indices(std::pair<glm::vec2, glm::vec2> const& bounding_rectan
     static_cast<uint16_t>(render_data->idx_beg + 3),
   });
   render_data->idx_beg += 4;
+  return true;
 }
 
 void add_shape_property(
@@ -166,7 +249,7 @@ auto window_count() noexcept -> uint32_t
 auto window_extent() noexcept -> std::pair<uint32_t, uint32_t>
 {
   check_in_update_callback();
-  return { UIContext::instance()->window.width, UIContext::instance()->window.height};
+  return { UIContext::instance()->window->width, UIContext::instance()->window->height};
 }
 
 auto content_extent() noexcept -> std::pair<uint32_t, uint32_t>
@@ -185,52 +268,58 @@ void add_move_invalid_area(glm::vec2 left_top, glm::vec2 right_bottom) noexcept
 auto is_active() noexcept -> bool
 {
   check_in_update_callback();
-  return UIContext::instance()->window.is_active();
+  return UIContext::instance()->window->is_active();
 }
 
 auto is_moving() noexcept -> bool
 {
   check_in_update_callback();
-  return UIContext::instance()->window.moving;
+  return UIContext::instance()->window->moving;
 }
 
 auto is_resizing() noexcept -> bool
 {
   check_in_update_callback();
-  return UIContext::instance()->window.resizing;
+  return UIContext::instance()->window->resizing;
 }
 
 auto is_maxmized() noexcept -> bool
 {
   check_in_update_callback();
-  return UIContext::instance()->window.is_maximized;
+  return UIContext::instance()->window->is_maximized;
 }
 
 auto is_minimized() noexcept -> bool
 {
   check_in_update_callback();
-  return UIContext::instance()->window.is_minimized;
+  return UIContext::instance()->window->is_minimized;
+}
+
+void invalidate_window() noexcept
+{
+  check_in_update_callback();
+  UIContext::instance()->invalidate_current_window();
 }
 
 void minimize_window() noexcept
 {
   check_in_update_callback();
-  ShowWindow(UIContext::instance()->window.handle, SW_MINIMIZE);
+  ShowWindow(UIContext::instance()->window->handle, SW_MINIMIZE);
 }
 
 void maximize_window() noexcept
 {
   check_in_update_callback();
-  PostMessageW(UIContext::instance()->window.handle, WM_SIZE, SIZE_MAXIMIZED, 0);
+  PostMessageW(UIContext::instance()->window->handle, WM_SIZE, SIZE_MAXIMIZED, 0);
 }
 
 void restore_window() noexcept
 {
   check_in_update_callback();
   auto ctx = UIContext::instance();
-  ShowWindow(ctx->window.handle, SW_RESTORE);
+  ShowWindow(ctx->window->handle, SW_RESTORE);
   if (is_maxmized())
-    PostMessageW(ctx->window.handle, static_cast<uint32_t>(WindowManager::Message::window_restore_from_maximize), 0, 0);
+    PostMessageW(ctx->window->handle, static_cast<uint32_t>(WindowManager::Message::window_restore_from_maximize), 0, 0);
 }
 
 void set_background_color(Color color) noexcept
@@ -247,7 +336,7 @@ void timer_repeate_event(uint32_t duration, std::function<void(float)> func, std
   // generic unique id for this call by source location
   auto id = generic_hash(location.file_name(), location.line(), location.column());
 
-	auto& window = ctx->windows.at(ctx->window.handle);
+	auto& window = *ctx->current_window;
 
   // first call, create timer event
   if (!window.timer_events.contains(id))
@@ -273,6 +362,18 @@ auto get_render_pos() noexcept -> glm::vec2
   return UIContext::instance()->window_render_pos();
 }
 
+void set_curve_tolerance(float tolerance) noexcept
+{
+  err_if(tolerance <= 0.f, "curve tolerance must be positive");
+  UIContext::instance()->curve_tolerance = tolerance;
+}
+
+void set_font(std::string_view filename) noexcept
+{
+  err_if(filename.empty(), "font filename cannot be empty");
+  UIContext::instance()->font = filename;
+}
+
 void enable_tmp_color(glm::vec4 const& color) noexcept
 {
   check_in_update_callback();
@@ -350,6 +451,11 @@ void discard_rectangle(glm::vec2 left_top, glm::vec2 right_bottom) noexcept
   err_if(render_data->shape_properties.empty(), "failed must draw a shape then use discard rectangle");
   err_if(ctx->using_union, "don't use discard rectangle in union operator, I'm not test for this");
   err_if(ctx->path_draw, "don't use discard rectangle in part draw, I'm not test for this");
+  err_if(ctx->recording_static_block.has_value() && render_data->shape_properties.size() <= ctx->recording_static_block->mark.shape_property_count,
+         "discard rectangle in static block must follow a shape of the block");
+
+  // shape is clipped out, nothing to discard from
+  if (ctx->shape_culled) return;
 
   auto& shape_property = render_data->shape_properties.back();
   shape_property.set_operator(ShapeProperty::Operator::discard);
@@ -361,6 +467,154 @@ void discard_rectangle(glm::vec2 left_top, glm::vec2 right_bottom) noexcept
   add_shape_property(ShapeProperty::Type::rectangle, {}, {}, { left_top.x, left_top.y, right_bottom.x, right_bottom.y });
 }
 
+void push_clip_rect(glm::vec2 left_top, glm::vec2 right_bottom) noexcept
+{
+  check_in_update_callback();
+
+  auto ctx    = UIContext::instance();
+  auto offset = ctx->window_render_pos();
+  left_top     += offset;
+  right_bottom += offset;
+
+  if (!ctx->clip_rects.empty())
+  {
+    left_top     = glm::max(left_top,     ctx->clip_rects.back().first);
+    right_bottom = glm::min(right_bottom, ctx->clip_rects.back().second);
+  }
+  ctx->clip_rects.emplace_back(left_top, right_bottom);
+}
+
+void pop_clip_rect() noexcept
+{
+  check_in_update_callback();
+
+  auto ctx = UIContext::instance();
+  err_if(ctx->clip_rects.empty(), "pop clip rect without push");
+  ctx->clip_rects.pop_back();
+}
+
+void begin_layer(size_t id, glm::vec2 extent) noexcept
+{
+  check_in_update_callback();
+  check_not_path_draw();
+
+  auto ctx = UIContext::instance();
+  err_if(ctx->recording_layer.has_value(), "cannot begin layer in a layer");
+  err_if(ctx->recording_static_block.has_value(), "cannot begin layer in a static block");
+  err_if(ctx->op_data.op != ShapeProperty::Operator::none, "cannot begin layer in a union");
+  err_if(extent.x < 1.f || extent.y < 1.f, "layer extent must not be empty");
+
+  auto  origin = ctx->window_render_pos();
+  auto& layer  = ctx->recording_layer.emplace();
+  layer.id      = generic_hash(ctx->window->id, ctx->window->generation, id);
+  layer.origin  = origin;
+  layer.extent  = glm::vec<2, uint32_t>{ glm::ceil(extent) };
+  layer.mark    = ctx->record_mark();
+  layer.missing = ctx->missing;
+
+  // content is clipped by layer itself, clips of window apply to the composite
+  layer.clip_rects = std::exchange(ctx->clip_rects, { { origin, origin + glm::vec2{ layer.extent } } });
+}
+
+void end_layer(size_t invalidate_key, float opacity, glm::vec2 offset, float scale) noexcept
+{
+  check_in_update_callback();
+  check_not_path_draw();
+
+  auto ctx = UIContext::instance();
+  err_if(!ctx->recording_layer.has_value(), "end layer without begin");
+  err_if(ctx->op_data.op != ShapeProperty::Operator::none, "must clear operator before end layer");
+  err_if(ctx->clip_rects.size() != 1, "must pop every clip rect in layer");
+
+  auto layer       = std::move(*std::exchange(ctx->recording_layer, {}));
+  auto render_data = ctx->current_render_data();
+  ctx->clip_rects  = std::move(layer.clip_rects);
+
+  // layer missing glyphs or images is rendered again once more of them are ready
+  invalidate_key = ctx->missing.stale_key(layer.missing, invalidate_key, ctx->glyph_cache.ready_count(), g_external_image_loader.uploaded_count());
+
+  // shapes of layer are taken out of window, they are only rendered into layer image when key changes
+  auto cached = ctx->layer_cache.acquire(layer.id, invalidate_key, layer.extent);
+  if (cached.need_render)
+  {
+    auto& render  = ctx->layer_renders.emplace_back(layer.id, layer.origin, layer.extent);
+    auto& content = render.content;
+    ctx->copy_shapes(layer.mark, content);
+
+    // same passes as window, layer is rendered alone so opaque quads only hide shapes inside it
+    content.sample_distance_fields(ctx->distance_field_cache, ctx->distance_field_bakes);
+    ctx->current_window->occlusion_stats += content.cull_occluded(layer.origin + glm::vec2{ layer.extent });
+    content.build_batches(Renderer::instance()->enable_depth_test);
+  }
+  ctx->truncate_shapes(layer.mark);
+
+  // version changes with content, so window is redrawn though composite is at same place
+  auto min = layer.origin + offset;
+  auto max = min + glm::vec2{ layer.extent } * scale;
+  auto index = static_cast<uint32_t>(render_data->shape_properties.size());
+  if (add_shape(ShapeProperty::Type::layer, {}, {}, { std::bit_cast<float>(0u), static_cast<float>(layer.extent.x), static_cast<float>(layer.extent.y), std::bit_cast<float>(cached.version) }, { min, max }))
+  {
+    render_data->shape_properties.back().set_color({ 1.f, 1.f, 1.f, opacity });
+    render_data->layers.emplace_back(layer.id, index);
+  }
+}
+
+auto begin_static_block(size_t id, uint32_t version) noexcept -> bool
+{
+  check_in_update_callback();
+  check_not_path_draw();
+
+  auto ctx = UIContext::instance();
+  err_if(ctx->recording_static_block.has_value(), "cannot begin static block in a static block");
+  err_if(ctx->op_data.op != ShapeProperty::Operator::none, "cannot begin static block in a union");
+
+  // shapes are recorded in window coordinates and clipped, so moving or clipping block records it again
+  auto& block      = ctx->current_window->static_blocks[id];
+  auto  render_pos = ctx->window_render_pos();
+  auto  clip_rect  = ctx->clip_rects.empty() ? std::nullopt : std::optional{ ctx->clip_rects.back() };
+  block.used = true;
+
+  auto& recording = ctx->recording_static_block.emplace();
+  recording.id      = id;
+  recording.spliced = block.valid && block.version == version && block.render_pos == render_pos && block.clip_rect == clip_rect &&
+                      ctx->glyph_cache.touch(block.glyphs);
+  if (recording.spliced)
+  {
+    ctx->splice_shapes(block.shapes);
+    ctx->current_window->widget_count += block.widget_count;
+    return false;
+  }
+
+  block.valid      = false;
+  block.version    = version;
+  block.render_pos = render_pos;
+  block.clip_rect  = clip_rect;
+  recording.mark         = ctx->record_mark();
+  recording.widget_count = ctx->current_window->widget_count;
+  recording.missing      = ctx->missing;
+  return true;
+}
+
+void end_static_block() noexcept
+{
+  check_in_update_callback();
+  check_not_path_draw();
+
+  auto ctx = UIContext::instance();
+  err_if(!ctx->recording_static_block.has_value(), "end static block without begin");
+  err_if(ctx->op_data.op != ShapeProperty::Operator::none, "must clear operator before end static block");
+
+  auto recording = *std::exchange(ctx->recording_static_block, {});
+  if (recording.spliced) return;
+
+  // shapes stay in window, block keeps a copy for later frames, block missing glyphs or images is recorded again
+  auto& block = ctx->current_window->static_blocks[recording.id];
+  ctx->copy_shapes(recording.mark, block.shapes);
+  block.glyphs       = std::move(recording.glyphs);
+  block.widget_count = ctx->current_window->widget_count - recording.widget_count;
+  block.valid        = !ctx->missing.missed_since(recording.missing);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 ///                            Basic Shape
 ////////////////////////////////////////////////////////////////////////////////
@@ -434,25 +688,22 @@ void bezier(glm::vec2 p0, glm::vec2 p1, glm::vec2 p2, Color color) noexcept
 {
   check_in_update_callback();
 
-  auto ctx = UIContext::instance();
-
+  auto ctx    = UIContext::instance();
   auto offset = ctx->window_render_pos();
-  p0 += offset;
-  p1 += offset;
-  p2 += offset;
+  auto points = std::vector<glm::vec2>{};
+  flatten_quadratic(p0 + offset, p1 + offset, p2 + offset, ctx->curve_tolerance, points);
+  add_polyline(points, color);
+}
 
-  if (ctx->path_draw)
-  {
-    ctx->path_draw_data[0] = std::bit_cast<float>(std::bit_cast<uint32_t>(ctx->path_draw_data[0]) + 1);
-    auto points = { p0, p1, p2 };
-    ctx->path_draw_points.append_range(points);
-    ctx->path_draw_data.emplace_back(std::bit_cast<float>(ShapeProperty::Type::path_bezier));
-    ctx->path_draw_data.append_range(std::ranges::to<std::vector<float>>(points
-      | std::views::transform([](auto const& p) { return std::array<float, 2>{ p.x, p.y }; })
-      | std::views::join));
-  }
-  else
-    add_shape(ShapeProperty::Type::bezier, color, {}, { p0.x, p0.y, p1.x, p1.y, p2.x, p2.y }, get_bounding_rectangle({ p0, p1, p2 }));
+void cubic_bezier(glm::vec2 p0, glm::vec2 p1, glm::vec2 p2, glm::vec2 p3, Color color) noexcept
+{
+  check_in_update_callback();
+
+  auto ctx    = UIContext::instance();
+  auto offset = ctx->window_render_pos();
+  auto points = std::vector<glm::vec2>{};
+  flatten_cubic(p0 + offset, p1 + offset, p2 + offset, p3 + offset, ctx->curve_tolerance, points);
+  add_polyline(points, color);
 }
 
 void image(std::string_view filename, int x, int y) noexcept
@@ -467,50 +718,87 @@ void image(std::string_view filename, int x, int y) noexcept
 
   if (!g_external_image_loader.contains(filename))
     g_external_image_loader.load(filename);
-  if (g_external_image_loader.is_uploaded(filename))
+  if (auto image = g_external_image_loader.get(filename))
+  {
+    // generation only keys content for dirty tracking, shader only reads index
+    if (add_shape(ShapeProperty::Type::image, {}, {}, { std::bit_cast<float>(image->index), std::bit_cast<float>(image->generation) }, { { x, y }, { x + image->width, y + image->height }}) && image->opaque)
+      ctx->current_render_data()->shape_properties.back().set_flags(ShapeProperty::Flag::opaque);
+  }
+  else
   {
-	  auto const& image = g_external_image_loader[filename];
-    add_shape(ShapeProperty::Type::image, {}, {}, { std::bit_cast<float>(image.index()) }, { { x, y }, { x + image.width(), y + image.height() }});
+    // image is drawn once uploaded, so window is recorded again rather than reusing content without it
+    ++ctx->missing.image_count;
+    ctx->invalidate_current_window();
   }
 }
 
+auto text(std::string_view str, glm::vec2 left_top, float size, Color color) noexcept -> glm::vec2
+{
+  check_in_update_callback();
+  check_not_path_draw();
+
+  auto ctx = UIContext::instance();
+  err_if(ctx->op_data.op != ShapeProperty::Operator::none, "cannot draw text in a union");
+  err_if(size <= 0.f, "text size must be positive");
+
+  // font failed to load is already logged, text of it is skipped
+  auto& font = ctx->glyph_cache.font(ctx->font);
+  if (!font.valid()) return {};
+
+  // every glyph is a quad sampling its msdf in atlas, values are same as Type::glyph
+  auto origin = ctx->window_render_pos() + left_top;
+  auto extent = layout_text(font, str, [&](auto const& glyph, glm::vec2 pen)
+  {
+    auto cached = ctx->glyph_cache.acquire(font, glyph);
+    if (!cached)
+    {
+      // glyph is drawn once rasterized, so window is recorded again rather than reusing content without it
+      ++ctx->missing.glyph_count;
+      ctx->invalidate_current_window();
+      return;
+    }
+    if (ctx->recording_static_block)
+      ctx->recording_static_block->glyphs.emplace_back(cached->use);
+
+    auto min = origin + (pen + cached->offset) * size;
+    auto max = min + cached->extent * size;
+    add_shape(ShapeProperty::Type::glyph, color, {}, { cached->uv_min.x, cached->uv_min.y, cached->uv_max.x, cached->uv_max.y, cached->range * size, std::bit_cast<float>(cached->use.version) }, { min, max });
+  });
+  return extent * size;
+}
+
+auto text_extent(std::string_view str, float size) noexcept -> glm::vec2
+{
+  auto  ctx  = UIContext::instance();
+  auto& font = ctx->glyph_cache.font(ctx->font);
+  if (!font.valid()) return {};
+  return layout_text(font, str, [](auto const&, glm::vec2) {}) * size;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 ///                              UI Widget
 ////////////////////////////////////////////////////////////////////////////////
 
-auto is_hover_on(glm::vec2 left_top, glm::vec2 right_bottom) noexcept -> bool
+auto is_hover_on(size_t id, glm::vec2 left_top, glm::vec2 right_bottom) noexcept -> bool
 {
   check_in_update_callback();
 
-  auto ctx = UIContext::instance();
-
-  auto render_pos = ctx->window_render_pos();
-  left_top     += render_pos;
-  right_bottom += render_pos;
-
-  if (!ctx->window.cursor_valid_area() || ctx->window.is_moving_or_resizing()) return false;
-  auto p = ctx->window.cursor_pos();
-  return p.x >= left_top.x && p.x <= right_bottom.x && p.y >= left_top.y && p.y <= right_bottom.y && ctx->mouse_on_window == ctx->window.handle;
+  // overlapped widgets are resolved by hit grid, only top-most one is hovered
+  return UIContext::instance()->hit_test(id, left_top, right_bottom);
 }
 
-auto is_click_on(glm::vec2 left_top, glm::vec2 right_bottom) noexcept -> bool
+auto is_click_on(size_t id, glm::vec2 left_top, glm::vec2 right_bottom) noexcept -> bool
 {
   check_in_update_callback();
-  return UIContext::instance()->is_click_on(left_top, right_bottom);
+
+  auto ctx = UIContext::instance();
+  ctx->hit_test(id, left_top, right_bottom);
+  return ctx->is_click_on(id);
 }
 
-auto is_hover_on(uint32_t id, glm::vec2 left_top, glm::vec2 right_bottom, LerpAnimation& lerp_anim) noexcept
+auto is_hover_on(size_t id, glm::vec2 left_top, glm::vec2 right_bottom, LerpAnimation& lerp_anim) noexcept
 {
-  return lerp_anim.update([&]
-  {
-    if (is_hover_on(left_top, right_bottom))
-    {
-      auto ctx = UIContext::instance();
-      ctx->hovered_widget_ids.push_back(id);
-      return id == ctx->prev_hovered_widget_id;
-    }
-    return false;
-  });
+  return lerp_anim.update([&] { return is_hover_on(id, left_top, right_bottom); });
 }
 
 auto button(
@@ -552,7 +840,67 @@ auto button(
     disable_tmp_color();
   }
 
-  return hovered && is_click_on(left_top, right_bottom);
+  // button is already in hit grid, click is resolved against it
+  return hovered && ctx->is_click_on(id);
+}
+
+void list(
+  size_t                                          id,
+  glm::vec2                                       left_top,
+  glm::vec2                                       extent,
+  uint32_t                                        item_count,
+  std::function<float(uint32_t)> const&           item_height,
+  std::function<void(uint32_t, glm::vec2)> const& draw_item,
+  uint32_t                                        version) noexcept
+{
+  check_in_update_callback();
+  check_not_path_draw();
+
+  auto  ctx   = UIContext::instance();
+  auto& state = ctx->current_window->lists[id];
+  state.used = true;
+  state.index.update(item_count, item_height, version);
+
+  // list is inserted under its items, wheel only scrolls it when it or one of its items is top-most under cursor,
+  // so widgets drawn over list keep wheel, velocity then decays by frame time
+  auto& hit_grid      = ctx->current_window->hit_grid;
+  auto  widgets_begin = static_cast<uint32_t>(hit_grid.size());
+  auto  notches       = 0.f;
+  if (ctx->hit_test(id, left_top, left_top + extent) || ctx->current_window->wheel_list == id)
+    notches = std::exchange(ctx->current_window->wheel_notches, 0.f);
+  state.scroll.update(notches, ctx->frame_delta, state.index.height() - extent.y);
+
+  // keep recording while scrolling, moving window would blit a stale drag cache
+  if (state.scroll.scrolling())
+    ctx->invalidate_current_window();
+
+  // only items in view and overscan are drawn, they are found by binary search of item tops
+  auto [first, last] = state.index.range(state.scroll.offset, state.scroll.offset + extent.y);
+  first = first > List_Overscan_Count ? first - List_Overscan_Count : 0;
+  last  = std::min(last + List_Overscan_Count, item_count);
+
+  auto pos = ctx->window_render_pos() + left_top;
+  push_clip_rect(left_top, left_top + extent);
+  for (auto i = first; i < last; ++i)
+  {
+    auto y = pos.y + state.index.item_top(i) - state.scroll.offset;
+    Tmp_Render_Pos(static_cast<int>(pos.x), static_cast<int>(std::floor(y)))
+      draw_item(i, { extent.x, state.index.item_height(i) });
+  }
+  pop_clip_rect();
+  state.widgets = { widgets_begin, static_cast<uint32_t>(hit_grid.size()) };
+}
+
+void list(
+  size_t                                          id,
+  glm::vec2                                       left_top,
+  glm::vec2                                       extent,
+  uint32_t                                        item_count,
+  float                                           item_height,
+  std::function<void(uint32_t, glm::vec2)> const& draw_item) noexcept
+{
+  // index is rebuilt when height changes
+  list(id, left_top, extent, item_count, [=](uint32_t) { return item_height; }, draw_item, std::bit_cast<uint32_t>(item_height));
 }
 
 }}
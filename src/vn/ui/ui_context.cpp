@@ -5,18 +5,11 @@
 #include "ui.hpp"
 
 #include <ranges>
+#include <array>
+#include <algorithm>
 
 using namespace vn::renderer;
 
-namespace {
-
-auto point_on_rect(glm::vec<2, int> const& p, glm::vec2 const& left_top, glm::vec2 const& right_bottom) noexcept
-{
-  return p.x >= left_top.x && p.x <= right_bottom.x && p.y >= left_top.y && p.y <= right_bottom.y;
-}
-
-}
-
 namespace vn { namespace ui {
 
 void UIContext::add_window(std::string_view name, uint32_t x, uint32_t y, uint32_t width, uint32_t height, std::function<void()> update_func, bool use_title_bar) noexcept
@@ -25,171 +18,292 @@ void UIContext::add_window(std::string_view name, uint32_t x, uint32_t y, uint32
 
   // empty window is renderer used fullscreen window for moving and resive other windows
   err_if(name.empty() || !update_func, "window name or update function cannot be empty");
-  err_if(std::ranges::any_of(windows | std::views::keys,
-    [&] (auto handle) { return wm->get_window_name(handle) == name; }), "duplicate window of {}", name);
+  err_if(std::ranges::any_of(windows.ids(), [&] (auto id) { return wm->get_window_name(id) == name; }) ||
+         std::ranges::any_of(_pending_windows, [&] (auto const& window) { return window.name == name; }),
+         "duplicate window of {}", name);
 
-  auto handle = wm->create_window(name, x, y, width, height);
-  windows[handle].update         = update_func;
-  windows[handle].draw_title_bar = use_title_bar;
+  // creating window would move windows, so delay it when recording
+  if (updating)
+  {
+    _pending_windows.emplace_back(std::string{ name }, x, y, width, height, update_func, use_title_bar);
+    return;
+  }
+
+  auto  id     = wm->create_window(name, x, y, width, height);
+  auto& window = windows.emplace(id);
+  window.update         = update_func;
+  window.draw_title_bar = use_title_bar;
 }
 
 void UIContext::close_current_window() noexcept
 {
-  PostMessageW(window.handle, WM_CLOSE, 0, 0);
+  PostMessageW(window->handle, WM_CLOSE, 0, 0);
+}
+
+void UIContext::destroy_window(WindowId id) noexcept
+{
+  auto& window = windows[id];
+  if (auto const& stats = window.occlusion_stats; stats.quad_count)
+    info("[UIContext] culled {} of {} quads under opaque shapes, clipped {}", stats.culled_count, stats.quad_count, stats.clipped_count);
+  for (auto anim : window.lerp_anims)
+  {
+    _lerp_anims[anim].stop();
+    _lerp_anims.erase(anim);
+  }
+  windows.erase(id);
 }
 
 auto UIContext::content_extent() noexcept -> std::pair<uint32_t, uint32_t>
 {
-  auto width  = window.width;
-  auto height = window.height;
-  if (windows[window.handle].draw_title_bar)
+  auto width  = window->width;
+  auto height = window->height;
+  if (current_window->draw_title_bar)
     height -= Titler_Bar_Height;
   return { width, height };
 }
 
 void UIContext::render() noexcept
 {
-  // clear last frame hovered widget ids
-  hovered_widget_ids.clear();
+  distance_field_cache.begin_frame();
+  layer_cache.begin_frame();
+  glyph_cache.begin_frame(glyph_uploads);
+
+  // long stall like blocking by os is not a jump of animations
+  auto now    = std::chrono::steady_clock::now();
+  frame_delta = _frame_begin ? std::min(std::chrono::duration<float>(now - *_frame_begin).count(), Max_Frame_Delta) : 0.f;
+  _frame_begin = now;
 
   // get unminimized windows as render targets
   auto render_windows = WindowManager::instance()->_windows
-    | std::views::values
     | std::views::filter([](auto const& window) { return !window.is_minimized; });
 
   // generate render data
-  std::ranges::for_each(render_windows, [this](auto const& render_window) { generate_render_data(render_window); });
+  std::ranges::for_each(render_windows, [this](auto const& render_window) { generate_render_data(render_window.id); });
+  window         = {};
+  current_window = {};
 
   // if have any rendering window
   if (!render_windows.empty())
   {
     auto renderer = Renderer::instance();
+    auto frame    = renderer->current_frame();
 
-    // commit render commands
-    auto need_clear_window     = HWND{};
-    auto use_fullscreen_window = HWND{};
+    // hand over render datas to frame, the swapped back buffers are reused by next recording
     for (auto const& render_window : render_windows)
     {
-			auto& window = windows[render_window.handle];
-
-      // for moving or resizing window, use fullscreen promise smooth winodw size change and move sync with cursor
-      if (render_window.is_moving_or_resizing())
-      {
-        use_fullscreen_window = render_window.handle;
-
-        // use fullscreen render first frame need to clear window content
-        if (window.need_clear)
-        {
-          need_clear_window = render_window.handle;
-					renderer->clear_window(render_window.handle);
-        }
-
-        // use window render data to render on fullscreen
-        renderer->render_fullscreen(render_window.handle, window.render_data);
-      }
-      else
-        renderer->render(render_window.handle, window.render_data);
-
-      // clear render data
+      auto& window       = windows[render_window.id];
+      auto& frame_window = frame->add_window(render_window.id);
+      frame_window.moving_or_resizing = render_window.is_moving_or_resizing();
+      frame_window.need_clear         = window.need_clear;
+      frame_window.capture_drag_cache = window.capture_drag_cache;
+      std::swap(frame_window.render_data, window.render_data);
       window.render_data.clear();
     }
-
-    if (moving_or_resizing_finish_window) renderer->clear_fullscreen();
-
-    // present windows
-    // at least one vsync present promise all window vsync support present barrier
-    if (use_fullscreen_window)
-    {
-      if (need_clear_window)
-        renderer->present(need_clear_window);
-      std::ranges::for_each(render_windows | std::views::filter([&](auto const& window) { return window.handle != use_fullscreen_window; }),
-        [&](auto const& window) { renderer->present(window.handle); });
-      renderer->present_fullscreen(true);
-    }
-    else
-    {
-      // HACK:
-      // I can't implement two window present at same monitor frame beside nvidia which NvApi 
-      // intel and amd driver I'm not see any api support present barrier
-      // so this process which present two windows, mostly it's ok
-      // but some pc's performance problem can be cause two windows present in differet monitor frame
-      // so the filcker will happen
-      if (moving_or_resizing_finish_window)
-      {
-        std::ranges::for_each(render_windows | std::views::filter([&](auto const& window) { return window.handle != moving_or_resizing_finish_window; }),
-          [&](auto const& window) { renderer->present(window.handle); });
-        renderer->present_fullscreen();
-        renderer->present(moving_or_resizing_finish_window, true);
-        moving_or_resizing_finish_window = {};
-      }
-      else
-      {
-        std::ranges::for_each(render_windows | std::views::take(std::ranges::distance(render_windows) - 1),
-          [&](auto const& window) { renderer->present(window.handle); });
-        std::ranges::for_each(render_windows | std::views::reverse | std::views::take(1),
-          [&](auto const& window) { renderer->present(window.handle, true); });
-      }
-    }
-
-    // update mouse hovered widget id
-    if (!hovered_widget_ids.empty())
-      prev_hovered_widget_id = hovered_widget_ids.back();
+    frame->moving_or_resizing_finish_window = std::exchange(moving_or_resizing_finish_window, {});
+    std::swap(frame->distance_field_bakes, distance_field_bakes);
+    distance_field_bakes.clear();
+    std::swap(frame->glyph_uploads, glyph_uploads);
+    glyph_uploads.clear();
+    layer_cache.evict(released_layers);
+    std::swap(frame->layer_renders, layer_renders);
+    std::swap(frame->released_layers, released_layers);
+    layer_renders.clear();
+    released_layers.clear();
+
+    // render and present in render thread
+    renderer->submit_frame();
 
     // timer events process
     _lerp_anim_timer.process_events();
   }
   else
     Sleep(1); // FIXME: any better way?
+
+  // create windows which are added in update callbacks
+  std::ranges::for_each(std::exchange(_pending_windows, {}), [this](auto& window)
+  {
+    add_window(window.name, window.x, window.y, window.width, window.height, window.update, window.use_title_bar);
+  });
 }
 
-void UIContext::generate_render_data(vn::renderer::Window const& render_window) noexcept
+void UIContext::generate_render_data(WindowId id) noexcept
 {
-  // initialize data per window
-  auto& window = windows[render_window.handle];
-  this->window            = render_window;
+  // initialize data per window, window pointers are stable until recording finish
+  auto& window = windows[id];
+  this->window            = &WindowManager::instance()->_windows[id];
+  current_window          = &window;
   shape_properties_offset = {};
   updating                = true;
   window.widget_count     = {};
   op_data.offset          = {};
 
-  // use title bar, move draw position under the title bar
-  if (window.draw_title_bar)
-    set_render_pos(0, Titler_Bar_Height);
+  // moving or resizing window records its content once into drag cache,
+  // later frames only blit the cache until extent changes or content is invalidated
+  auto extent    = glm::vec<2, uint32_t>{ this->window->width, this->window->height };
+  auto use_cache = false;
+  if (!this->window->is_moving_or_resizing())
+    window.drag_cache_extent.reset();
+  else if (window.drag_cache_extent == extent)
+    use_cache = true;
+  else
+    window.drag_cache_extent = extent; // invalidating in update callback resets it
 
-  // update render data from user render callback
-  window.update();
+  // shadow is under content, and still drawn around drag cache
+  update_window_shadow();
 
-  // promise last shape is normal operator
-  err_if(op_data.op != ShapeProperty::Operator::none, "must clear operator after using finish");
+  if (!use_cache)
+  {
+    // widget under cursor is the top-most one of last recording, then widgets of this recording are inserted again
+    // widgets drawn later in this recording are not known yet, so hover lags changes of widgets by one recording
+    window.hovered_widget.reset();
+    window.clicked_widget.reset();
+    window.wheel_list.reset();
+    if (this->window->is_active() && this->window->cursor_valid_area() && !this->window->is_moving_or_resizing() &&
+        _mouse_down_pos && _mouse_up_pos && _mouse_down_window == id && _mouse_up_window == id)
+      window.clicked_widget = window.hit_grid.query_click(*_mouse_down_pos, *_mouse_up_pos);
+    if (mouse_on_window == id && this->window->cursor_valid_area() && !this->window->is_moving_or_resizing())
+    {
+      auto cursor = glm::vec2{ this->window->cursor_pos() };
+      window.hovered_widget = window.hit_grid.query(cursor);
 
-  // draw title bar
-  if (window.draw_title_bar)
-    update_title_bar();
+      // lists of last recording cover z order of their items, nested list has narrower range
+      if (auto index = window.hit_grid.query_index(cursor))
+      {
+        auto width = UINT32_MAX;
+        for (auto const& [list_id, list] : window.lists)
+          if (*index >= list.widgets.first && *index < list.widgets.second && list.widgets.second - list.widgets.first < width)
+          {
+            window.wheel_list = list_id;
+            width             = list.widgets.second - list.widgets.first;
+          }
+      }
+    }
+    window.hit_grid.reset(extent);
 
-  update_window_shadow();
+    // use title bar, move draw position under the title bar
+    if (window.draw_title_bar)
+      set_render_pos(0, Titler_Bar_Height);
+
+    // update render data from user render callback
+    window.update();
+
+    // promise last shape is normal operator
+    err_if(op_data.op != ShapeProperty::Operator::none, "must clear operator after using finish");
+    err_if(!clip_rects.empty(), "must pop every clip rect in update callback");
+    err_if(recording_layer.has_value(), "must end every layer in update callback");
+    err_if(recording_static_block.has_value(), "must end every static block in update callback");
+
+    // static blocks and lists not drawn by this recording are dropped, the rest are unmarked for next one
+    std::erase_if(window.static_blocks, [](auto& pair) { return !std::exchange(pair.second.used, false); });
+    std::erase_if(window.lists,         [](auto& pair) { return !std::exchange(pair.second.used, false); });
+
+    // draw title bar
+    if (window.draw_title_bar)
+      update_title_bar();
+  }
+  window.capture_drag_cache = !use_cache && window.drag_cache_extent.has_value();
+  window.wheel_notches      = {};
+
+  // fullscreen draws drag cache rather than content, content is only rendered into cache when capturing
+  if (use_cache || window.capture_drag_cache)
+  {
+    add_vertices_indices({ {}, glm::vec2{ extent } });
+    add_shape_property(ShapeProperty::Type::drag_cache, {}, {}, {});
+  }
 
   update_cursor();
 
+  // paths and unions sample distance baked by renderer rather than being evaluated per pixel
+  window.render_data.sample_distance_fields(distance_field_cache, distance_field_bakes);
+
+  // drop quads hidden under opaque ones, pixel shader not runs for them
+  window.occlusion_stats += window.render_data.cull_occluded(glm::vec2{ extent });
+
+  // group quads by pixel shader permutation
+  window.render_data.build_batches(Renderer::instance()->enable_depth_test);
+
+  // moving or resizing window is drawn on fullscreen, its swapchain is redrawn entirely after that
+  if (this->window->is_moving_or_resizing())
+    window.dirty_tracker.reset();
+  else
+  {
+    auto t = static_cast<int32_t>(Window_Shadow_Thickness);
+    window.render_data.dirty_rects = window.dirty_tracker.update(window.render_data,
+      { -t, -t, static_cast<int32_t>(this->window->width) + t, static_cast<int32_t>(this->window->height) + t });
+  }
+
   // update render data finish
   updating = false;
 }
 
 void UIContext::add_move_invalid_area(glm::vec2 left_top, glm::vec2 right_bottom) noexcept
 {
-  WindowManager::instance()->_windows.at(window.handle).move_invalid_area.emplace_back(left_top.x, left_top.y, right_bottom.x, right_bottom.y);
+  WindowManager::instance()->_windows[window->id].move_invalid_area.emplace_back(left_top.x, left_top.y, right_bottom.x, right_bottom.y);
+}
+
+auto UIContext::record_mark() noexcept -> RecordMark
+{
+  auto render_data = current_render_data();
+  return
+  {
+    render_data->vertices.size(),
+    render_data->indices.size(),
+    render_data->shape_properties.size(),
+    shape_properties_offset,
+    render_data->idx_beg,
+  };
+}
+
+void UIContext::copy_shapes(RecordMark const& mark, WindowRenderData& data) noexcept
+{
+  auto render_data = current_render_data();
+  data.vertices.assign(render_data->vertices.begin() + mark.vertex_count, render_data->vertices.end());
+  data.indices.assign(render_data->indices.begin() + mark.index_count, render_data->indices.end());
+  data.shape_properties.assign(render_data->shape_properties.begin() + mark.shape_property_count, render_data->shape_properties.end());
+  data.idx_beg = render_data->idx_beg - mark.idx_beg;
+  for (auto& vertex : data.vertices) vertex.buffer_offset -= mark.shape_properties_offset;
+  for (auto& index  : data.indices)  index -= mark.idx_beg;
+}
+
+void UIContext::truncate_shapes(RecordMark const& mark) noexcept
+{
+  auto render_data = current_render_data();
+  render_data->vertices.resize(mark.vertex_count);
+  render_data->indices.resize(mark.index_count);
+  render_data->shape_properties.erase(render_data->shape_properties.begin() + mark.shape_property_count, render_data->shape_properties.end());
+  render_data->idx_beg    = mark.idx_beg;
+  shape_properties_offset = mark.shape_properties_offset;
+}
+
+void UIContext::splice_shapes(WindowRenderData const& data) noexcept
+{
+  // vertices and indices are copied in bulk then moved by base of window
+  auto render_data = current_render_data();
+  auto vertex_beg  = render_data->vertices.size();
+  auto index_beg   = render_data->indices.size();
+  render_data->vertices.append_range(data.vertices);
+  render_data->indices.append_range(data.indices);
+  for (auto& vertex : render_data->vertices | std::views::drop(vertex_beg)) vertex.buffer_offset += shape_properties_offset;
+  for (auto& index  : render_data->indices  | std::views::drop(index_beg))  index += render_data->idx_beg;
+  render_data->idx_beg += data.idx_beg;
+  for (auto const& shape_property : data.shape_properties)
+  {
+    render_data->shape_properties.emplace_back(shape_property);
+    shape_properties_offset += shape_property.byte_size();
+  }
 }
 
 void UIContext::update_cursor() noexcept
 {
   auto renderer    = Renderer::instance();
   auto render_data = current_render_data();
-  if (window.is_moving_or_resizing())
+  if (window->is_moving_or_resizing())
   {
-    auto pos = window.cursor_pos();
-    if (window.cursor_type != CursorType::arrow)
+    auto pos = window->cursor_pos();
+    if (window->cursor_type != CursorType::arrow)
     {
-      pos.x -= renderer->_cursors[window.cursor_type].pos.x;
-      pos.y -= renderer->_cursors[window.cursor_type].pos.y;
+      pos.x -= renderer->_cursors.at(window->cursor_type).pos.x;
+      pos.y -= renderer->_cursors.at(window->cursor_type).pos.y;
     }
     render_data->vertices.append_range(std::vector<Vertex>
     {
@@ -216,10 +330,32 @@ void UIContext::update_cursor() noexcept
 
 void UIContext::update_window_shadow() noexcept
 {
-	// ui::rectangle({}, { window.real_width(), window.real_height() });
-  //add_vertices_indices({{ rect.left, rect.top }, { rect.right, rect.bottom }});
-  //add_shape_property(ShapeProperty::Type::rectangle, {}, {}, { static_cast<float>(window.rect.left), static_cast<float>(window.rect.top), static_cast<float>(window.rect.right), static_cast<float>(window.rect.bottom) });
-  // current_render_data()->shape_properties.back().set_flags(ShapeProperty::Flag::window_shadow);
+  // maximized window has no margin for shadow
+  if (window->is_maximized) return;
+
+  // 9-slice quads around content, corners cover thickness on both sides of window border,
+  // edges stretch middle row or column of shadow image, center is covered by content so skipped
+  // every slice is { left_top, right_bottom, uv_left_top, uv_right_bottom }
+  auto t = static_cast<float>(Window_Shadow_Thickness);
+  auto w = static_cast<float>(window->width);
+  auto h = static_cast<float>(window->height);
+  using Slice = std::array<glm::vec2, 4>;
+  auto slices = std::array<Slice, 8>
+  {
+    Slice{ glm::vec2{ -t,    -t    }, glm::vec2{ t,     t     }, glm::vec2{ 0.f, 0.f }, glm::vec2{ .5f, .5f } },
+    Slice{ glm::vec2{ w - t, -t    }, glm::vec2{ w + t, t     }, glm::vec2{ .5f, 0.f }, glm::vec2{ 1.f, .5f } },
+    Slice{ glm::vec2{ -t,    h - t }, glm::vec2{ t,     h + t }, glm::vec2{ 0.f, .5f }, glm::vec2{ .5f, 1.f } },
+    Slice{ glm::vec2{ w - t, h - t }, glm::vec2{ w + t, h + t }, glm::vec2{ .5f, .5f }, glm::vec2{ 1.f, 1.f } },
+    Slice{ glm::vec2{ t,     -t    }, glm::vec2{ w - t, t     }, glm::vec2{ .5f, 0.f }, glm::vec2{ .5f, .5f } },
+    Slice{ glm::vec2{ t,     h - t }, glm::vec2{ w - t, h + t }, glm::vec2{ .5f, .5f }, glm::vec2{ .5f, 1.f } },
+    Slice{ glm::vec2{ -t,    t     }, glm::vec2{ t,     h - t }, glm::vec2{ 0.f, .5f }, glm::vec2{ .5f, .5f } },
+    Slice{ glm::vec2{ w - t, t     }, glm::vec2{ w + t, h - t }, glm::vec2{ .5f, .5f }, glm::vec2{ 1.f, .5f } },
+  };
+  for (auto const& [left_top, right_bottom, uv_left_top, uv_right_bottom] : slices)
+  {
+    add_vertices_indices({ left_top, right_bottom });
+    add_shape_property(ShapeProperty::Type::window_shadow, {}, {}, { uv_left_top.x, uv_left_top.y, uv_right_bottom.x, uv_right_bottom.y });
+  }
 }
 
 void UIContext::update_title_bar() noexcept
@@ -232,7 +368,12 @@ void UIContext::update_title_bar() noexcept
   uint32_t background_colors[2] = { 0xffffffff, 0xeeeeeeff };
   auto i = is_active() || is_moving() || is_resizing();
 
-  auto background_color = color_lerp(background_colors[0], background_colors[1], add_lerp_anim(generic_id("__update_title_bar"), 200)->update(i).get_lerp());
+  auto background_anim  = add_lerp_anim(generic_id("__update_title_bar"), 200);
+  auto background_color = color_lerp(background_colors[0], background_colors[1], background_anim->update(i).get_lerp());
+
+  // title bar highlights when moving starts, keep recording until animation finish
+  if (background_anim->state() == LerpAnimation::State::running)
+    invalidate_current_window();
 
   auto [w, h] = window_extent();
 
@@ -290,49 +431,47 @@ void UIContext::message_process() noexcept
     _mouse_up_pos      = {};
   }
 
-  auto z_orders = wm->get_window_z_orders();
-  if (auto it = std::ranges::find_if(z_orders, [wm](auto handle) { return wm->_windows.at(handle).point_on(get_cursor_pos()); });
-      it != z_orders.end())
-    mouse_on_window = *it;
-  else
-    mouse_on_window = {};
+  mouse_on_window = wm->get_window_on(get_cursor_pos());
 
-  for (auto const& [handle, _] : windows)
+  for (auto id : windows.ids())
   {
-    auto const& window = wm->_windows.at(handle);
+    auto const& window = wm->_windows[id];
     if (window.mouse_state == MouseState::left_button_down)
     {
-      _mouse_down_window = handle;
+      _mouse_down_window = id;
       _mouse_down_pos    = window.cursor_pos();
     }
     else if (window.mouse_state == MouseState::left_button_up)
     {
-      _mouse_up_window = handle;
+      _mouse_up_window = id;
       _mouse_up_pos    = window.cursor_pos();
     }
   }
 }
 
-auto UIContext::is_click_on(glm::vec2 left_top, glm::vec2 right_bottom) noexcept -> bool
+auto UIContext::hit_test(size_t id, glm::vec2 left_top, glm::vec2 right_bottom) noexcept -> bool
 {
   auto render_pos = window_render_pos();
   left_top     += render_pos;
   right_bottom += render_pos;
 
-  if (!window.is_active()             ||
-      !window.cursor_valid_area()     ||
-		   window.is_moving_or_resizing() ||
-      !_mouse_down_pos.has_value()    ||
-      !_mouse_up_pos.has_value()      ||
-       _mouse_down_window != _mouse_up_window) return false;
-  return point_on_rect(_mouse_down_pos.value(), left_top, right_bottom) &&
-         point_on_rect(_mouse_up_pos.value(),   left_top, right_bottom);
+  // clipped part of widget is not able to be hovered
+  if (!clip_rects.empty())
+  {
+    left_top     = glm::max(left_top,     clip_rects.back().first);
+    right_bottom = glm::min(right_bottom, clip_rects.back().second);
+  }
+  current_window->hit_grid.insert(id, left_top, right_bottom);
+  return id == current_window->hovered_widget;
 }
 
 auto UIContext::add_lerp_anim(uint32_t id, uint32_t dur) noexcept -> LerpAnimation*
 {
   if (!_lerp_anims.contains(id))
+  {
     _lerp_anims[id].init(&_lerp_anim_timer, dur);
+    current_window->lerp_anims.emplace_back(id);
+  }
   return &_lerp_anims[id];
 }
 
@@ -2,15 +2,25 @@
 
 #include "../renderer/shader_type.hpp"
 #include "../renderer/window.hpp"
+#include "window_render_data.hpp"
 #include "lerp_animation.hpp"
+#include "curve.hpp"
+#include "layer_cache.hpp"
+#include "scroll_list.hpp"
+#include "hit_grid.hpp"
+#include "glyph_cache.hpp"
+#include "missing_content.hpp"
 #include "../hash.hpp"
+#include "../dense_map.hpp"
 #include "timer.hpp"
 
+#include <string>
 #include <string_view>
 #include <functional>
 #include <unordered_map>
 #include <optional>
 #include <span>
+#include <chrono>
 
 #include <windows.h>
 
@@ -27,24 +37,33 @@ namespace vn { namespace ui {
     for (auto __old_render_pos = get_render_pos(); __call_once; set_render_pos(__old_render_pos.x, __old_render_pos.y)) \
       for (set_render_pos(__x, __y); __call_once; __call_once = false)
 
-void add_vertices_indices(std::pair<glm::vec2, glm::vec2> const& bounding_rectangle) noexcept;
+/// @return whether quad is added, quad fully out of clip rect is not
+auto add_vertices_indices(std::pair<glm::vec2, glm::vec2> const& bounding_rectangle) noexcept -> bool;
 
 void add_shape_property(renderer::ShapeProperty::Type type, glm::vec4 color, float thickness, std::vector<float> const& values) noexcept;
 
-struct WindowRenderData
+/// shapes recorded once and spliced into later frames of same version without running the code drawing them
+struct StaticBlock
 {
-  std::vector<renderer::Vertex>        vertices;
-  std::vector<uint16_t>                indices;
-  uint16_t                             idx_beg{};
-  std::vector<renderer::ShapeProperty> shape_properties;
+  uint32_t                                       version{};
+  glm::vec2                                      render_pos{};
+  std::optional<std::pair<glm::vec2, glm::vec2>> clip_rect;
+  WindowRenderData                               shapes;
+  std::vector<GlyphCache::Use>                   glyphs;         // block is recorded again when any of them leaves its cell
+  uint32_t                                       widget_count{}; // generic ids after block stay same when it is spliced
+  bool                                           valid{};
+  bool                                           used{};
+};
 
-  void clear() noexcept
-  {
-    vertices.clear();
-    indices.clear();
-    idx_beg = {};
-    shape_properties.clear();
-  }
+/// scrolling of list widget, heights of items are indexed once
+struct ListState
+{
+  ListIndex   index;
+  ScrollState scroll;
+  bool        used{};
+
+  // z order range of list and its items in hit grid of last recording, wheel over any of them scrolls list
+  std::pair<uint32_t, uint32_t> widgets{};
 };
 
 struct Window
@@ -57,6 +76,31 @@ struct Window
   bool                                 need_clear{};
   Timer                                timer;
   std::unordered_map<size_t, uint32_t> timer_events;
+
+  // extent of content in drag cache of renderer, empty when content needs recording again
+  std::optional<glm::vec<2, uint32_t>> drag_cache_extent;
+  bool                                 capture_drag_cache{};
+
+  // shapes of static blocks and states of lists by id, the ones not used by a recording are dropped
+  std::unordered_map<size_t, StaticBlock> static_blocks;
+  std::unordered_map<size_t, ListState>   lists;
+
+  // wheel notches since last recording, hovered list consumes them
+  float                                wheel_notches{};
+
+  // widgets of last recording by z order, widgets under cursor and clicked are resolved from it once per recording
+  // widgets drawn later in recording are not known yet, so hover and click lag changes of widgets by one recording
+  HitGrid                              hit_grid;
+  std::optional<size_t>                hovered_widget;
+  std::optional<size_t>                clicked_widget;
+  std::optional<size_t>                wheel_list;    // innermost list containing hovered widget, it consumes wheel
+
+  // lerp animations added by widgets of window, erased when window is destroyed
+  std::vector<uint32_t>                lerp_anims;
+
+  // compare recorded frames, so renderer only redraws changed area of window
+  DirtyTracker                         dirty_tracker;
+  OcclusionStats                       occlusion_stats;
 };
 
 class UIContext
@@ -81,6 +125,9 @@ public:
   void add_window(std::string_view name, uint32_t x, uint32_t y, uint32_t width, uint32_t height, std::function<void()> update_func, bool use_title_bar) noexcept;
   void close_current_window() noexcept;
 
+  /// drop ui state of closed window, its animations are stopped and its statistics are reported
+  void destroy_window(renderer::WindowId id) noexcept;
+
   auto content_extent() noexcept -> std::pair<uint32_t, uint32_t>;
 
   void add_move_invalid_area(glm::vec2 left_top, glm::vec2 right_bottom) noexcept;
@@ -88,31 +135,60 @@ public:
   void render() noexcept;
   void message_process() noexcept;
 
-  auto set_window_render_pos(int x, int y) noexcept { windows[window.handle].render_pos = { x, y }; }
-  auto window_render_pos() noexcept { return windows[window.handle].render_pos; }
+  auto set_window_render_pos(int x, int y) noexcept { current_window->render_pos = { x, y }; }
+  auto window_render_pos() noexcept { return current_window->render_pos; }
 
-  auto is_click_on(glm::vec2 left_top, glm::vec2 right_bottom) noexcept -> bool;
+  /// insert widget into hit grid of current window, @return whether it is the top-most widget under cursor
+  auto hit_test(size_t id, glm::vec2 left_top, glm::vec2 right_bottom) noexcept -> bool;
+
+  /// @return whether widget inserted by hit_test is clicked, it is top-most at both press and release position
+  auto is_click_on(size_t id) noexcept { return id == current_window->clicked_widget; }
 
   auto add_lerp_anim(uint32_t id, uint32_t dur) noexcept -> LerpAnimation*;
 
-  auto current_render_data() noexcept { return &windows[window.handle].render_data; }
+  auto current_render_data() noexcept { return &current_window->render_data; }
+
+  void invalidate_current_window() noexcept { current_window->drag_cache_extent.reset(); }
+
+  /// position in render data of current window, shapes recorded after it are able to be taken out
+  struct RecordMark
+  {
+    size_t   vertex_count{};
+    size_t   index_count{};
+    size_t   shape_property_count{};
+    uint32_t shape_properties_offset{};
+    uint16_t idx_beg{};
+  };
+  auto record_mark() noexcept -> RecordMark;
+
+  /// copy shapes recorded after mark into data, shape property offsets and indices are rebased to start of data
+  void copy_shapes(RecordMark const& mark, WindowRenderData& data) noexcept;
+  /// drop shapes recorded after mark
+  void truncate_shapes(RecordMark const& mark) noexcept;
+  /// append shapes of data copied by copy_shapes, they are rebased to end of current window
+  void splice_shapes(WindowRenderData const& data) noexcept;
 
 private:
   void update_cursor()        noexcept;
   void update_window_shadow() noexcept;
 
+  static constexpr auto Max_Frame_Delta = .1f; // seconds
+
   static constexpr auto Titler_Bar_Height             = 35;
   static constexpr auto Titler_Bar_Button_Width       = 46;
   static constexpr auto Titler_Bar_Button_Icon_Width  = 10;
   static constexpr auto Titler_Bar_Button_Icon_Height = 10;
   void update_title_bar() noexcept;
 
-  void generate_render_data(vn::renderer::Window const& render_window) noexcept;
+  void generate_render_data(renderer::WindowId id) noexcept;
 
 public:
-  std::unordered_map<HWND, Window> windows;
-  renderer::Window                 window;
-  uint32_t                         shape_properties_offset{};
+  DenseMap<Window>        windows;
+  uint32_t                shape_properties_offset{};
+
+  // cache of current recording window, avoid looking up windows per shape
+  renderer::Window const* window{};
+  Window*                 current_window{};
 
   struct OperatorShapeRenderData
   {
@@ -127,22 +203,85 @@ public:
 
   bool updating{}; // promise ui functinos only call in update callback
   bool using_union{};
+  bool shape_culled{}; // last shape is fully clipped and recorded nothing
 
   std::optional<glm::vec4> tmp_color;
 
-  size_t              prev_hovered_widget_id{};
-  std::vector<size_t> hovered_widget_ids;
+  float curve_tolerance{ Default_Curve_Tolerance };
+
+  // seconds since last frame, animations driven by it not depend on frame rate
+  float frame_delta{};
+
+  // clip rectangles of window content, every one is already intersected with the ones under it
+  std::vector<std::pair<glm::vec2, glm::vec2>> clip_rects;
+
+  renderer::WindowId mouse_on_window{};
+
+  renderer::WindowId moving_or_resizing_finish_window{};
 
-  HWND mouse_on_window{};
+  // distance fields of paths and unions shared by all windows, bakes are handed over to renderer with frame
+  DistanceFieldCache             distance_field_cache;
+  std::vector<DistanceFieldBake> distance_field_bakes;
 
-  HWND moving_or_resizing_finish_window{};
+  // layers shared by all windows, layers to render and evicted ones are handed over to renderer with frame
+  LayerCache               layer_cache;
+  std::vector<LayerRender> layer_renders;
+  std::vector<size_t>      released_layers;
+
+  // glyphs shared by all windows, rasterized ones are handed over to renderer with frame
+  // text skips glyphs still rasterizing, content recorded while count of them grows is stale
+  GlyphCache               glyph_cache;
+  std::vector<GlyphUpload> glyph_uploads;
+  std::string              font{ default_font() };
+
+  // glyphs still rasterizing and images still uploading skipped by recording
+  MissingContent           missing;
+
+  // layer between begin and end, its shapes are recorded into window then taken out at end
+  struct RecordingLayer
+  {
+    size_t                                       id{};
+    glm::vec2                                    origin{};
+    glm::vec<2, uint32_t>                        extent{};
+    RecordMark                                   mark;
+    std::vector<std::pair<glm::vec2, glm::vec2>> clip_rects; // clips of window, restored at end
+    MissingContent                               missing;
+  };
+  std::optional<RecordingLayer> recording_layer;
+
+  // static block between begin and end, shapes are captured at end unless they were spliced from cache at begin
+  struct RecordingStaticBlock
+  {
+    size_t                       id{};
+    bool                         spliced{};
+    RecordMark                   mark;
+    uint32_t                     widget_count{};
+    MissingContent               missing;
+    std::vector<GlyphCache::Use> glyphs;
+  };
+  std::optional<RecordingStaticBlock> recording_static_block;
 
 private:
-  HWND                     _mouse_down_window{};
+  renderer::WindowId       _mouse_down_window{};
   std::optional<glm::vec2> _mouse_down_pos{};
-  HWND                     _mouse_up_window{};
+  renderer::WindowId       _mouse_up_window{};
   std::optional<glm::vec2> _mouse_up_pos{};
 
+  // windows created in update callback are delayed to the end of recording, keep cached window pointers valid
+  struct PendingWindow
+  {
+    std::string           name;
+    uint32_t              x{};
+    uint32_t              y{};
+    uint32_t              width{};
+    uint32_t              height{};
+    std::function<void()> update;
+    bool                  use_title_bar{};
+  };
+  std::vector<PendingWindow> _pending_windows;
+
+  std::optional<std::chrono::steady_clock::time_point> _frame_begin;
+
   Timer                                     _lerp_anim_timer;
   std::unordered_map<size_t, LerpAnimation> _lerp_anims;
 };
@@ -151,7 +290,7 @@ template <typename... T>
 constexpr auto generic_id(T&&... args) noexcept
 {
   auto ctx = UIContext::instance();
-  return generic_hash(ctx->window.handle, ++ctx->windows[ctx->window.handle].widget_count, std::forward<T>(args)...);
+  return generic_hash(ctx->window->id, ctx->window->generation, ++ctx->current_window->widget_count, std::forward<T>(args)...);
 }
 
 }}
@@ -0,0 +1,356 @@
+#include "window_render_data.hpp"
+
+#include <algorithm>
+#include <span>
+#include <array>
+#include <numeric>
+#include <optional>
+#include <utility>
+#include <assert.h>
+
+using namespace vn::renderer;
+
+namespace
+{
+
+constexpr auto Quad_Vertex_Count = 4;
+constexpr auto Quad_Index_Count  = 6;
+
+// bound the cost of looking back, quads which can not find batch in range open new one
+constexpr auto Max_Batch_Lookback = 16;
+
+// bound the cost of occlusion test, larger occluders replace smaller ones when full
+constexpr auto Max_Occluder_Count = 16;
+
+struct Batch
+{
+  PixelShaderPermutation permutation{};
+  glm::vec2              min{};
+  glm::vec2              max{};
+  uint32_t               quad_count{};
+  bool                   sealed{};
+  bool                   window_shadow{};
+  bool                   opaque{};
+  bool                   drag_cache{};
+
+  auto overlap(glm::vec2 min, glm::vec2 max) const noexcept
+  {
+    return min.x < this->max.x && this->min.x < max.x &&
+           min.y < this->max.y && this->min.y < max.y;
+  }
+};
+
+struct Occluder
+{
+  glm::vec2 min{};
+  glm::vec2 max{};
+
+  auto area() const noexcept { return (max.x - min.x) * (max.y - min.y); }
+};
+
+/// shrink quad to rectangle inside it, uv follows position so images are not stretched
+void clip_quad(std::span<Vertex> quad, glm::vec2 min, glm::vec2 max) noexcept
+{
+  auto old_min = glm::vec2{ quad[0].pos };
+  auto size    = glm::vec2{ quad[2].pos } - old_min;
+  auto uv_min  = quad[0].uv;
+  auto uv_max  = quad[2].uv;
+  for (auto& vertex : quad)
+  {
+    auto pos   = glm::mix(min, max, (glm::vec2{ vertex.pos } - old_min) / size);
+    vertex.pos = glm::vec3{ pos, vertex.pos.z };
+    vertex.uv  = glm::mix(uv_min, uv_max, (pos - old_min) / size);
+  }
+}
+
+/// bounds of whole shape, quad may be clipped to part of it, uv still spans whole shape from 0 to 1
+auto shape_bounds(std::span<Vertex const> quad) noexcept -> std::pair<glm::vec2, glm::vec2>
+{
+  auto pos_min = glm::vec2{ quad[0].pos };
+  auto pos_max = glm::vec2{ quad[2].pos };
+  auto size    = (pos_max - pos_min) / (quad[2].uv - quad[0].uv);
+  auto min     = pos_min - quad[0].uv * size;
+  return { min, min + size };
+}
+
+}
+
+namespace vn { namespace ui {
+
+auto WindowRenderData::shape_property_offsets() const noexcept -> std::vector<uint32_t>
+{
+  auto offsets = std::vector<uint32_t>{};
+  offsets.reserve(shape_properties.size());
+  auto offset = uint32_t{};
+  for (auto const& shape_property : shape_properties)
+  {
+    offsets.emplace_back(offset);
+    offset += shape_property.byte_size();
+  }
+  return offsets;
+}
+
+void WindowRenderData::sample_distance_fields(DistanceFieldCache& cache, std::vector<DistanceFieldBake>& bakes) noexcept
+{
+  auto quad_count = static_cast<uint32_t>(vertices.size() / Quad_Vertex_Count);
+  if (quad_count == 0) return;
+
+  // sampling shapes are appended after recorded ones
+  auto offsets = shape_property_offsets();
+  auto offset  = offsets.back() + shape_properties.back().byte_size();
+  for (auto quad = uint32_t{}; quad < quad_count; ++quad)
+  {
+    auto quad_vertices = std::span{ vertices }.subspan(quad * Quad_Vertex_Count, Quad_Vertex_Count);
+
+    // operator chain of quad ends at the shape without operator
+    auto it = std::ranges::lower_bound(offsets, quad_vertices[0].buffer_offset);
+    assert(it != offsets.end() && *it == quad_vertices[0].buffer_offset);
+    auto beg = static_cast<size_t>(it - offsets.begin());
+    auto end = beg;
+    while (shape_properties[end].op() != ShapeProperty::Operator::none) ++end;
+    auto chain = std::span{ shape_properties }.subspan(beg, end - beg + 1);
+
+    // single primitive is cheap to evaluate, discarded area is not part of distance
+    if (chain.size() == 1 && chain[0].type() != ShapeProperty::Type::path) continue;
+    if (std::ranges::any_of(chain, [](auto const& shape_property) { return shape_property.op() == ShapeProperty::Operator::discard; })) continue;
+
+    // one more texel around shape, bilinear filtering of border pixels reads it
+    auto [min, max] = shape_bounds(quad_vertices);
+    auto origin = glm::floor(min) - 1.f;
+    auto extent = glm::vec<2, uint32_t>{ glm::ceil(max) + 1.f - origin };
+    if (extent.x > DistanceFieldCache::Tile_Size || extent.y > DistanceFieldCache::Tile_Size) continue;
+
+    auto tile = cache.acquire(distance_field_key(chain, origin, extent));
+    if (!tile) continue;
+    if (tile->need_bake)
+    {
+      bakes.emplace_back(tile->pos, origin, extent, std::vector<ShapeProperty>{ chain.begin(), chain.end() });
+      continue;
+    }
+
+    // color and thickness of chain are of its last shape
+    auto color     = chain.back().color();
+    auto thickness = chain.back().thickness();
+    auto uv_min    = (glm::vec2{ tile->pos } + min - origin) / static_cast<float>(DistanceFieldCache::Atlas_Size);
+    auto uv_max    = (glm::vec2{ tile->pos } + max - origin) / static_cast<float>(DistanceFieldCache::Atlas_Size);
+    shape_properties.emplace_back(ShapeProperty{ ShapeProperty::Type::distance_field, color, thickness, {}, { uv_min.x, uv_min.y, uv_max.x, uv_max.y } });
+    for (auto& vertex : quad_vertices)
+      vertex.buffer_offset = offset;
+    offset += shape_properties.back().byte_size();
+  }
+}
+
+auto WindowRenderData::cull_occluded(glm::vec2 extent) noexcept -> OcclusionStats
+{
+  auto stats      = OcclusionStats{};
+  auto quad_count = static_cast<uint32_t>(vertices.size() / Quad_Vertex_Count);
+  stats.quad_count = quad_count;
+  if (quad_count == 0) return stats;
+
+  auto offsets = shape_property_offsets();
+
+  // quads only hide quads submitted before them, so walk from last one
+  auto occluders = std::vector<Occluder>{};
+  auto culled    = std::vector<bool>(quad_count);
+  for (auto quad = quad_count; quad-- > 0;)
+  {
+    auto quad_vertices = std::span{ vertices }.subspan(quad * Quad_Vertex_Count, Quad_Vertex_Count);
+    auto rect_min      = glm::vec2{ quad_vertices[0].pos };
+    auto rect_max      = glm::vec2{ quad_vertices[2].pos };
+    if (rect_min.x >= rect_max.x || rect_min.y >= rect_max.y) continue;
+
+    // cut covered side off until nothing changes, the rest may be covered by another occluder then
+    auto min = rect_min;
+    auto max = rect_max;
+    for (auto changed = true; changed && !culled[quad];)
+    {
+      changed = false;
+      for (auto const& occluder : occluders)
+      {
+        auto cover_x = occluder.min.x <= min.x && max.x <= occluder.max.x;
+        auto cover_y = occluder.min.y <= min.y && max.y <= occluder.max.y;
+        if (cover_x && cover_y)
+        {
+          culled[quad] = true;
+          break;
+        }
+        if (cover_x && occluder.min.y <= min.y && min.y < occluder.max.y)
+          min.y = occluder.max.y;
+        else if (cover_x && occluder.min.y < max.y && max.y <= occluder.max.y)
+          max.y = occluder.min.y;
+        else if (cover_y && occluder.min.x <= min.x && min.x < occluder.max.x)
+          min.x = occluder.max.x;
+        else if (cover_y && occluder.min.x < max.x && max.x <= occluder.max.x)
+          max.x = occluder.min.x;
+        else
+          continue;
+        changed = true;
+      }
+    }
+    if (culled[quad])
+    {
+      ++stats.culled_count;
+      continue;
+    }
+    if (min != rect_min || max != rect_max)
+    {
+      clip_quad(quad_vertices, min, max);
+      ++stats.clipped_count;
+    }
+
+    // whole quad of opaque shape hides, clipped part is hidden by later occluders anyway
+    auto it = std::ranges::lower_bound(offsets, quad_vertices[0].buffer_offset);
+    assert(it != offsets.end() && *it == quad_vertices[0].buffer_offset);
+    if (!shape_properties[it - offsets.begin()].is_opaque()) continue;
+
+    // content is scissored, so opaque quad only hides area inside content
+    auto occluder = Occluder{ glm::max(rect_min, glm::vec2{}), glm::min(rect_max, extent) };
+    if (occluder.min.x >= occluder.max.x || occluder.min.y >= occluder.max.y) continue;
+    if (occluders.size() < Max_Occluder_Count)
+      occluders.emplace_back(occluder);
+    else
+    {
+      auto& smallest = *std::ranges::min_element(occluders, {}, &Occluder::area);
+      if (smallest.area() < occluder.area())
+        smallest = occluder;
+    }
+  }
+  if (stats.culled_count == 0) return stats;
+
+  // compact quads, every quad has the same index pattern so indices are generated again
+  auto count = uint32_t{};
+  for (auto quad = uint32_t{}; quad < quad_count; ++quad)
+  {
+    if (culled[quad]) continue;
+    if (count != quad)
+      std::copy_n(vertices.begin() + quad * Quad_Vertex_Count, Quad_Vertex_Count, vertices.begin() + count * Quad_Vertex_Count);
+    ++count;
+  }
+  vertices.resize(count * Quad_Vertex_Count);
+  indices.clear();
+  indices.reserve(count * Quad_Index_Count);
+  for (auto quad = uint32_t{}; quad < count; ++quad)
+  {
+    auto beg = static_cast<uint16_t>(quad * Quad_Vertex_Count);
+    indices.append_range(std::array<uint16_t, Quad_Index_Count>
+    {
+      static_cast<uint16_t>(beg + 0),
+      static_cast<uint16_t>(beg + 1),
+      static_cast<uint16_t>(beg + 2),
+      static_cast<uint16_t>(beg + 0),
+      static_cast<uint16_t>(beg + 2),
+      static_cast<uint16_t>(beg + 3),
+    });
+  }
+  idx_beg = static_cast<uint16_t>(count * Quad_Vertex_Count);
+  return stats;
+}
+
+void WindowRenderData::build_batches(bool opaque_pass) noexcept
+{
+  batches.clear();
+  auto quad_count = static_cast<uint32_t>(indices.size() / Quad_Index_Count);
+  if (quad_count == 0) return;
+
+  // quads reference their shape by byte offset of shape properties
+  auto offsets = shape_property_offsets();
+
+  // later quad is nearer, cleared depth is 1 so every quad passes on empty target
+  if (opaque_pass)
+    for (auto quad = uint32_t{}; quad < quad_count; ++quad)
+      for (auto i = 0; i < Quad_Vertex_Count; ++i)
+        vertices[quad * Quad_Vertex_Count + i].pos.z = 1.f - (quad + 1.f) / (quad_count + 1.f);
+
+  // assign every quad to a batch
+  auto building       = std::vector<Batch>{};
+  auto opaque_batches = std::array<std::optional<uint32_t>, Pixel_Shader_Permutation_Count>{};
+  auto quad_batch     = std::vector<uint32_t>(quad_count);
+  for (auto quad = uint32_t{}; quad < quad_count; ++quad)
+  {
+    auto const& v0 = vertices[quad * Quad_Vertex_Count];
+    auto const& v2 = vertices[quad * Quad_Vertex_Count + 2];
+    auto it        = std::ranges::lower_bound(offsets, v0.buffer_offset);
+    assert(it != offsets.end() && *it == v0.buffer_offset);
+
+    auto const& shape_property = shape_properties[it - offsets.begin()];
+    auto permutation = shape_property.permutation();
+    auto min         = glm::vec2{ v0.pos };
+    auto max         = glm::vec2{ v2.pos };
+    auto sealed      = shape_property.type() == ShapeProperty::Type::cursor ||
+                       shape_property.type() == ShapeProperty::Type::drag_cache;
+    auto shadow      = shape_property.type() == ShapeProperty::Type::window_shadow;
+    auto drag_cache  = shape_property.type() == ShapeProperty::Type::drag_cache;
+
+    // depth keeps opaque quads in order, so they only group by permutation and never block other quads
+    if (opaque_pass && !sealed && !shadow && shape_property.is_opaque())
+    {
+      auto& index = opaque_batches[std::to_underlying(permutation)];
+      if (!index)
+      {
+        index = static_cast<uint32_t>(building.size());
+        building.emplace_back(permutation, min, max, 0, false, false, true);
+      }
+      ++building[*index].quad_count;
+      quad_batch[quad] = *index;
+      continue;
+    }
+
+    // walk back over batches this quad can be drawn before
+    auto target = static_cast<uint32_t>(building.size());
+    if (!sealed)
+    {
+      for (auto i = building.size(), lookback = size_t{}; i-- > 0 && lookback < Max_Batch_Lookback; ++lookback)
+      {
+        auto const& batch = building[i];
+        if (batch.opaque) continue;
+        if (batch.sealed || batch.window_shadow != shadow) break;
+        if (batch.permutation == permutation)
+        {
+          target = i;
+          break;
+        }
+        if (batch.overlap(min, max)) break;
+      }
+    }
+
+    if (target == building.size())
+      building.emplace_back(permutation, min, max, 0, sealed, shadow, false, drag_cache);
+    auto& batch = building[target];
+    batch.min = glm::min(batch.min, min);
+    batch.max = glm::max(batch.max, max);
+    ++batch.quad_count;
+    quad_batch[quad] = target;
+  }
+
+  // shadow batches lead, then opaque batches, the rest keep their order
+  auto order = std::vector<uint32_t>(building.size());
+  std::iota(order.begin(), order.end(), 0u);
+  std::ranges::stable_sort(order, {}, [&](auto i) { return building[i].window_shadow ? 0 : building[i].opaque ? 1 : 2; });
+
+  // emit indices batch by batch, quads keep recorded order inside batch,
+  // except opaque batches which are filled from their end, so they are drawn front to back
+  batches.reserve(building.size());
+  auto cursors      = std::vector<uint32_t>(building.size());
+  auto index_offset = uint32_t{};
+  for (auto i : order)
+  {
+    auto const& batch       = building[i];
+    auto        index_count = batch.quad_count * Quad_Index_Count;
+    batches.emplace_back(batch.permutation, index_offset, index_count, batch.window_shadow, batch.opaque, batch.drag_cache);
+    cursors[i]    = batch.opaque ? index_offset + index_count : index_offset;
+    index_offset += index_count;
+  }
+
+  auto sorted_indices = std::vector<uint16_t>(indices.size());
+  for (auto quad = uint32_t{}; quad < quad_count; ++quad)
+  {
+    auto  opaque = building[quad_batch[quad]].opaque;
+    auto& cursor = cursors[quad_batch[quad]];
+    if (opaque) cursor -= Quad_Index_Count;
+    std::copy_n(indices.begin() + quad * Quad_Index_Count, Quad_Index_Count, sorted_indices.begin() + cursor);
+    if (!opaque) cursor += Quad_Index_Count;
+  }
+  indices = std::move(sorted_indices);
+}
+
+}}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "../renderer/shader_type.hpp"
+#include "dirty_region.hpp"
+#include "distance_field_cache.hpp"
+
+#include <vector>
+
+namespace vn { namespace ui {
+
+/// counts of quads handled by occlusion culling, accumulated over frames
+struct OcclusionStats
+{
+  uint64_t quad_count{};
+  uint64_t culled_count{};  // removed since fully covered
+  uint64_t clipped_count{}; // shrunk since one side is covered
+
+  auto& operator+=(OcclusionStats const& stats) noexcept
+  {
+    quad_count    += stats.quad_count;
+    culled_count  += stats.culled_count;
+    clipped_count += stats.clipped_count;
+    return *this;
+  }
+};
+
+/// composite quad of layer, renderer writes index of layer image into its shape property, see LayerCache
+struct LayerComposite
+{
+  size_t   id{};
+  uint32_t shape_property{}; // index into shape properties
+};
+
+struct WindowRenderData
+{
+  std::vector<renderer::Vertex>        vertices;
+  std::vector<uint16_t>                indices;
+  uint16_t                             idx_beg{};
+  std::vector<renderer::ShapeProperty> shape_properties;
+  std::vector<renderer::DrawBatch>     batches;
+  std::vector<DirtyRect>               dirty_rects; // changed area since last frame in window coordinates, empty if nothing changed
+  std::vector<LayerComposite>          layers;
+
+  void clear() noexcept
+  {
+    vertices.clear();
+    indices.clear();
+    idx_beg = {};
+    shape_properties.clear();
+    batches.clear();
+    dirty_rects.clear();
+    layers.clear();
+  }
+
+  /// byte offset of every shape property, quads reference their shape by it
+  auto shape_property_offsets() const noexcept -> std::vector<uint32_t>;
+
+  /**
+   * pass of recording before culling, quads of paths and unions sample distance baked into atlas rather than
+   * evaluating their shapes per pixel, shapes missed in cache are still evaluated this frame and baked for next frames
+   * shapes larger than a tile are always evaluated, baking them would be under resolution of screen
+   * @param bakes shapes to bake are appended
+   */
+  void sample_distance_fields(DistanceFieldCache& cache, std::vector<DistanceFieldBake>& bakes) noexcept;
+
+  /**
+   * pass of recording before build batches, drop quads hidden under later opaque quads
+   * only rectangles which fully cover quad or cover whole one side of it are used, so quads are removed
+   * or shrunk to the uncovered part, without splitting into several quads
+   * @param extent content extent, opaque quads only hide area inside it because content is scissored by it
+   */
+  auto cull_occluded(glm::vec2 extent) noexcept -> OcclusionStats;
+
+  /**
+   * finalize pass of recording, reorder quads into batches of same pixel shader permutation
+   * a quad only moves forward over batches it not overlaps, so blending result is unchanged
+   * cursor quad is always the last batch alone, fullscreen rendering draws it with its own scissor,
+   * drag cache quad is alone too, so content before it can be rendered into drag cache separately,
+   * window shadow quads are recorded first and only batch with each other, renderer draws them out of content area
+   * @param opaque_pass give quads depth by recorded order and move opaque quads into leading opaque batches,
+   *                    renderer draws them front to back with depth write, then the rest are depth tested
+   */
+  void build_batches(bool opaque_pass = false) noexcept;
+};
+
+}}
@@ -2,27 +2,32 @@
 #include "renderer/renderer.hpp"
 #include "renderer/window_manager.hpp"
 #include "ui/ui_context.hpp"
+#include "error_handling.hpp"
 
 using namespace vn::renderer;
 using namespace vn::ui;
 
 namespace vn {
 
-void init() noexcept
+void init(InitOptions const& options) noexcept
 {
+  auto renderer = Renderer::instance();
+  renderer->enable_depth_test     = options.depth_test;
+  renderer->enable_overdraw_stats = options.overdraw_stats;
   WindowManager::instance()->init();
-  Renderer::instance()->init();
+  renderer->init();
 }
 
 void destroy() noexcept
 {
+  if (auto const& cache = UIContext::instance()->layer_cache; cache.stats().hit_count || cache.stats().miss_count)
+    info("[LayerCache] {} hits, {} misses, evicted {}, {} bytes of layers", cache.stats().hit_count, cache.stats().miss_count, cache.stats().evicted_count, cache.byte_size());
   Renderer::instance()->destroy();
 }
 
 void message_process() noexcept
 {
   WindowManager::instance()->message_process();
-  Renderer::instance()->message_process();
   UIContext::instance()->message_process();
 }
 
@@ -0,0 +1,69 @@
+#include "vn/ui/window_render_data.hpp"
+
+#include <print>
+#include <vector>
+#include <chrono>
+#include <utility>
+
+using namespace vn::renderer;
+using namespace vn::ui;
+
+namespace {
+
+constexpr auto Bounds          = DirtyRect{ 0, 0, 4096, 4096 };
+constexpr auto Iteration_Count = 200;
+
+/// grid of overlapping rectangles and circles like a widget heavy window
+auto record(uint32_t quad_count, uint32_t frame) noexcept
+{
+  auto data   = WindowRenderData{};
+  auto offset = uint32_t{};
+  for (auto i = 0u; i < quad_count; ++i)
+  {
+    auto type  = i % 2 ? ShapeProperty::Type::circle : ShapeProperty::Type::rectangle;
+    auto shape = ShapeProperty{ type, { 1.f, i % 7 / 7.f, 0.f, 1.f } };
+    auto min   = glm::vec2{ static_cast<float>(i % 128 * 30), static_cast<float>(i / 128 * 30) };
+    // one quad moves every frame
+    if (i == frame % quad_count) min.x += static_cast<float>(frame % 3);
+    auto max = min + 40.f;
+    data.shape_properties.emplace_back(shape);
+    data.vertices.insert(data.vertices.end(),
+    {
+      Vertex{ { min.x, min.y, 0.f }, { 0.f, 0.f }, offset },
+      Vertex{ { max.x, min.y, 0.f }, { 1.f, 0.f }, offset },
+      Vertex{ { max.x, max.y, 0.f }, { 1.f, 1.f }, offset },
+      Vertex{ { min.x, max.y, 0.f }, { 0.f, 1.f }, offset },
+    });
+    offset += static_cast<uint32_t>(shape.byte_size());
+  }
+  return data;
+}
+
+void run(uint32_t quad_count) noexcept
+{
+  auto frames = std::vector<WindowRenderData>{};
+  for (auto i = 0; i < Iteration_Count; ++i)
+    frames.emplace_back(record(quad_count, i));
+
+  // frames alternate with a swapped pair, so order matching is exercised too
+  for (auto i = 1; i < Iteration_Count; i += 2)
+    std::swap(frames[i].shape_properties[0], frames[i].shape_properties[2]);
+
+  auto tracker    = DirtyTracker{};
+  auto rect_count = size_t{};
+  tracker.update(frames.back(), Bounds);
+  auto begin = std::chrono::steady_clock::now();
+  for (auto const& frame : frames)
+    rect_count += tracker.update(frame, Bounds).size();
+  auto us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - begin).count() / Iteration_Count;
+  std::println("quads {:6} | {:9.1f} us per update | {:.2f} rects per update", quad_count, us, static_cast<double>(rect_count) / Iteration_Count);
+}
+
+}
+
+/// cost of DirtyTracker::update by quad count of window
+int main()
+{
+  for (auto count : { 100u, 1'000u, 10'000u, 50'000u })
+    run(count);
+}
@@ -0,0 +1,85 @@
+#include "vn/mpsc_queue.hpp"
+
+#include <print>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <string>
+#include <cstdint>
+#include <cstdlib>
+
+using namespace vn;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr auto Queue_Capacity     = 4096u;
+constexpr auto Message_Per_Thread = 1'000'000u;
+
+// producer pushes time of push, consumer measures latency when pops it
+struct Message
+{
+  int64_t  timestamp{};
+  uint32_t producer{};
+};
+
+auto now() noexcept
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+}
+
+void run(uint32_t producer_count) noexcept
+{
+  auto queue     = std::make_unique<MPSCQueue<Message, Queue_Capacity>>();
+  auto start     = std::atomic<bool>{};
+  auto total     = producer_count * Message_Per_Thread;
+  auto latencies = std::vector<int64_t>(total);
+
+  auto producers = std::vector<std::jthread>{};
+  for (auto i = 0u; i < producer_count; ++i)
+    producers.emplace_back([&, i]
+    {
+      while (!start.load(std::memory_order_acquire));
+      for (auto j = 0u; j < Message_Per_Thread; ++j)
+        queue->push({ now(), i });
+    });
+
+  auto begin = Clock::now();
+  start.store(true, std::memory_order_release);
+  for (auto count = 0u; count < total;)
+  {
+    auto message = Message{};
+    if (queue->try_pop(message))
+      latencies[count++] = now() - message.timestamp;
+  }
+  auto seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+  producers.clear();
+
+  std::ranges::sort(latencies);
+  auto percentile = [&](double p) { return latencies[static_cast<size_t>(p * (total - 1))]; };
+  std::println("producers {:2} | {:7.2f} Mops/s | latency ns p50 {:7} p99 {:7} p99.9 {:8} max {:9}",
+               producer_count, total / seconds / 1e6, percentile(0.5), percentile(0.99), percentile(0.999), latencies.back());
+}
+
+}
+
+/**
+ * throughput and latency of MPSCQueue under contention of producers
+ * usage: bench_mpsc_queue [producer count...], default sweeps 1 to hardware concurrency
+ */
+int main(int argc, char** argv)
+{
+  auto counts = std::vector<uint32_t>{};
+  for (auto i = 1; i < argc; ++i)
+    counts.emplace_back(std::max(std::atoi(argv[i]), 1));
+  if (counts.empty())
+    for (auto count = 1u; count < std::max(std::thread::hardware_concurrency(), 2u); count *= 2)
+      counts.emplace_back(count);
+
+  std::println("{} messages per producer, queue capacity {}", Message_Per_Thread, Queue_Capacity);
+  for (auto count : counts)
+    run(count);
+}
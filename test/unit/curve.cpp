@@ -0,0 +1,98 @@
+#include "test.hpp"
+#include "vn/ui/curve.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <tuple>
+#include <limits>
+
+using namespace vn::ui;
+
+namespace {
+
+auto quadratic(glm::vec2 p0, glm::vec2 p1, glm::vec2 p2) noexcept
+{
+  return [=](float t) { auto mt = 1.f - t; return p0 * (mt * mt) + p1 * (2.f * mt * t) + p2 * (t * t); };
+}
+
+auto cubic(glm::vec2 p0, glm::vec2 p1, glm::vec2 p2, glm::vec2 p3) noexcept
+{
+  return [=](float t) { auto mt = 1.f - t; return p0 * (mt * mt * mt) + p1 * (3.f * mt * mt * t) + p2 * (3.f * mt * t * t) + p3 * (t * t * t); };
+}
+
+auto distance_to_segment(glm::vec2 p, glm::vec2 a, glm::vec2 b) noexcept
+{
+  auto ab = b - a;
+  auto t  = std::clamp(glm::dot(p - a, ab) / std::max(glm::dot(ab, ab), 1e-12f), 0.f, 1.f);
+  return glm::length(p - (a + ab * t));
+}
+
+/// max distance from densely sampled curve to polyline
+auto max_distance(std::function<glm::vec2(float)> const& curve, std::vector<glm::vec2> const& points) noexcept
+{
+  auto result = 0.f;
+  for (auto i = 0; i <= 4096; ++i)
+  {
+    auto p        = curve(i / 4096.f);
+    auto distance = std::numeric_limits<float>::max();
+    for (auto j = size_t{ 1 }; j < points.size(); ++j)
+      distance = std::min(distance, distance_to_segment(p, points[j - 1], points[j]));
+    result = std::max(result, distance);
+  }
+  return result;
+}
+
+}
+
+TEST(curve_quadratic_within_tolerance)
+{
+  for (auto tolerance : { Default_Curve_Tolerance, 0.1f, 1.f })
+    for (auto [p0, p1, p2] : std::vector<std::tuple<glm::vec2, glm::vec2, glm::vec2>>
+    {
+      { { 0, 0 },   { 50, 100 }, { 100, 0 }   },
+      { { 10, 10 }, { 200, 15 }, { 20, 40 }   }, // sharp turn
+      { { 0, 0 },   { 5, 5 },    { 10, 10 }   }, // straight is one segment
+    })
+    {
+      auto points = std::vector<glm::vec2>{};
+      flatten_quadratic(p0, p1, p2, tolerance, points);
+      CHECK(points.size() == quadratic_segment_count(p0, p1, p2, tolerance) + 1);
+      CHECK(points.front() == p0 && points.back() == p2);
+      CHECK(max_distance(quadratic(p0, p1, p2), points) <= tolerance * 1.01f);
+    }
+  CHECK(quadratic_segment_count({ 0, 0 }, { 5, 5 }, { 10, 10 }, Default_Curve_Tolerance) == 1);
+}
+
+TEST(curve_cubic_within_tolerance)
+{
+  for (auto tolerance : { Default_Curve_Tolerance, 0.1f, 1.f })
+    for (auto [p0, p1, p2, p3] : std::vector<std::tuple<glm::vec2, glm::vec2, glm::vec2, glm::vec2>>
+    {
+      { { 0, 0 },  { 0, 100 },  { 100, 100 }, { 100, 0 } },
+      { { 0, 0 },  { 150, 80 }, { -50, 80 },  { 100, 0 } }, // self intersecting
+      { { 20, 0 }, { 40, 60 },  { 60, -60 },  { 80, 0 }  }, // inflection
+    })
+    {
+      auto points = std::vector<glm::vec2>{};
+      flatten_cubic(p0, p1, p2, p3, tolerance, points);
+      CHECK(points.size() == cubic_segment_count(p0, p1, p2, p3, tolerance) + 1);
+      CHECK(points.front() == p0 && points.back() == p3);
+      CHECK(max_distance(cubic(p0, p1, p2, p3), points) <= tolerance * 1.01f);
+    }
+}
+
+TEST(curve_segment_count_clamped)
+{
+  // huge curves stop at max count, so they are farther from curve than tolerance
+  auto p0 = glm::vec2{ 0, 0 }, p1 = glm::vec2{ 5000, 10000 }, p2 = glm::vec2{ 10000, 0 };
+  CHECK(quadratic_segment_count(p0, p1, p2, Default_Curve_Tolerance) == Max_Curve_Segment_Count);
+  CHECK(cubic_segment_count(p0, p1, p1, p2, Default_Curve_Tolerance) == Max_Curve_Segment_Count);
+
+  auto points = std::vector<glm::vec2>{};
+  flatten_quadratic(p0, p1, p2, Default_Curve_Tolerance, points);
+  CHECK(points.size() == Max_Curve_Segment_Count + 1);
+  CHECK(max_distance(quadratic(p0, p1, p2), points) > Default_Curve_Tolerance);
+
+  // degenerate curve is still one segment
+  CHECK(cubic_segment_count(p0, p0, p0, p0, Default_Curve_Tolerance) == 1);
+}
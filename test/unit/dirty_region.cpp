@@ -0,0 +1,129 @@
+#include "test.hpp"
+#include "vn/ui/window_render_data.hpp"
+
+#include <bit>
+
+using namespace vn::renderer;
+using namespace vn::ui;
+
+namespace {
+
+constexpr auto Bounds = DirtyRect{ 0, 0, 1000, 1000 };
+
+struct Rect
+{
+  glm::vec2     min{};
+  glm::vec2     max{};
+  ShapeProperty shape{ ShapeProperty::Type::rectangle, { 1.f, 0.f, 0.f, 1.f } };
+};
+
+auto record(std::vector<Rect> const& rects) noexcept
+{
+  auto data   = WindowRenderData{};
+  auto offset = uint32_t{};
+  for (auto const& [min, max, shape] : rects)
+  {
+    data.shape_properties.emplace_back(shape);
+    data.vertices.insert(data.vertices.end(),
+    {
+      Vertex{ { min.x, min.y, 0.f }, { 0.f, 0.f }, offset },
+      Vertex{ { max.x, min.y, 0.f }, { 1.f, 0.f }, offset },
+      Vertex{ { max.x, max.y, 0.f }, { 1.f, 1.f }, offset },
+      Vertex{ { min.x, max.y, 0.f }, { 0.f, 1.f }, offset },
+    });
+    offset += static_cast<uint32_t>(shape.byte_size());
+  }
+  return data;
+}
+
+auto covers(std::vector<DirtyRect> const& rects, DirtyRect const& area) noexcept
+{
+  return std::ranges::any_of(rects, [&](auto const& rect) { return rect.intersect(area) == area; });
+}
+
+auto image(uint32_t index, uint32_t generation) noexcept
+{
+  return ShapeProperty{ ShapeProperty::Type::image, {}, {}, {}, { std::bit_cast<float>(index), std::bit_cast<float>(generation) } };
+}
+
+}
+
+TEST(dirty_tracker_first_frame_and_unchanged)
+{
+  auto tracker = DirtyTracker{};
+  auto frame   = record({ { { 10, 10 }, { 20, 20 } }, { { 30, 30 }, { 40, 40 } } });
+  CHECK(tracker.update(frame, Bounds) == std::vector{ Bounds });
+  CHECK(tracker.update(frame, Bounds).empty());
+
+  tracker.reset();
+  CHECK(tracker.update(frame, Bounds) == std::vector{ Bounds });
+}
+
+TEST(dirty_tracker_moved_quad)
+{
+  auto tracker = DirtyTracker{};
+  tracker.update(record({ { { 10, 10 }, { 20, 20 } }, { { 300, 300 }, { 310, 310 } } }), Bounds);
+  auto rects = tracker.update(record({ { { 10, 10 }, { 20, 20 } }, { { 320, 300 }, { 330, 310 } } }), Bounds);
+
+  // old and new place of moved quad, not the unchanged one
+  CHECK(covers(rects, { 300, 300, 310, 310 }));
+  CHECK(covers(rects, { 320, 300, 330, 310 }));
+  CHECK(!covers(rects, { 10, 10, 20, 20 }));
+}
+
+TEST(dirty_tracker_shifted_in_stream)
+{
+  // quad added before others shifts their buffer offsets and order, but they are drawn same
+  auto a       = Rect{ { 10, 10 }, { 20, 20 } };
+  auto b       = Rect{ { 15, 15 }, { 25, 25 }, { ShapeProperty::Type::circle, { 0.f, 1.f, 0.f, .5f } } };
+  auto added   = Rect{ { 500, 500 }, { 510, 510 } };
+  auto tracker = DirtyTracker{};
+  tracker.update(record({ a, b }), Bounds);
+  auto rects = tracker.update(record({ added, a, b }), Bounds);
+  CHECK(rects.size() == 1);
+  CHECK(covers(rects, { 500, 500, 510, 510 }));
+  CHECK(!covers(rects, { 10, 10, 25, 25 }));
+}
+
+TEST(dirty_tracker_z_order_swap)
+{
+  // same quads in swapped order change the overlapped area
+  auto a       = Rect{ { 10, 10 }, { 30, 30 } };
+  auto b       = Rect{ { 20, 20 }, { 40, 40 }, { ShapeProperty::Type::rectangle, { 0.f, 0.f, 1.f, 1.f } } };
+  auto c       = Rect{ { 600, 600 }, { 610, 610 } };
+  auto tracker = DirtyTracker{};
+  tracker.update(record({ c, a, b }), Bounds);
+  auto rects = tracker.update(record({ c, b, a }), Bounds);
+  CHECK(!rects.empty());
+  CHECK(covers(rects, { 20, 20, 30, 30 }));
+  CHECK(!covers(rects, { 600, 600, 610, 610 }));
+
+  // identical quads swapped are not a change
+  tracker.update(record({ a, a, b }), Bounds);
+  CHECK(tracker.update(record({ a, a, b }), Bounds).empty());
+}
+
+TEST(dirty_tracker_image_content)
+{
+  auto background = Rect{ { 0, 0 }, { 1000, 1000 }, image(3, 1) };
+  auto tracker    = DirtyTracker{};
+  tracker.update(record({ background }), Bounds);
+
+  // same image is not redrawn every frame
+  CHECK(tracker.update(record({ background }), Bounds).empty());
+
+  // image reloaded into same descriptor index is another content
+  background.shape = image(3, 2);
+  CHECK(tracker.update(record({ background }), Bounds) == std::vector{ Bounds });
+}
+
+TEST(merge_rects_bounded)
+{
+  auto rects = std::vector<DirtyRect>{ { 0, 0, 10, 10 }, { 10, 0, 20, 10 }, { 100, 100, 110, 110 }, { 200, 0, 210, 10 }, { 5, 5, 5, 50 } };
+  merge_rects(rects, 4);
+  CHECK(rects.size() == 3);
+  CHECK(covers(rects, { 0, 0, 20, 10 }));
+
+  merge_rects(rects, 1);
+  CHECK(rects == std::vector<DirtyRect>{ { 0, 0, 210, 110 } });
+}
@@ -0,0 +1,88 @@
+#include "test.hpp"
+#include "vn/ui/distance_field_cache.hpp"
+
+#include <bit>
+
+using namespace vn::renderer;
+using namespace vn::ui;
+
+namespace {
+
+auto path(glm::vec2 offset, glm::vec4 color = { 1.f, 0.f, 0.f, 1.f }) noexcept
+{
+  auto line   = std::bit_cast<float>(ShapeProperty::Type::path_line);
+  auto bezier = std::bit_cast<float>(ShapeProperty::Type::path_bezier);
+  auto values = std::vector<float>
+  {
+    std::bit_cast<float>(3u),
+    line,   offset.x + 0.f,  offset.y + 0.f,  offset.x + 20.f, offset.y + 0.f,
+    bezier, offset.x + 20.f, offset.y + 0.f,  offset.x + 25.f, offset.y + 10.f, offset.x + 10.5f, offset.y + 20.f,
+    line,   offset.x + 10.5f, offset.y + 20.f, offset.x + 0.f, offset.y + 0.f,
+  };
+  return ShapeProperty{ ShapeProperty::Type::path, color, 0.f, {}, values };
+}
+
+auto key(std::vector<ShapeProperty> const& chain, glm::vec2 origin) noexcept
+{
+  return distance_field_key(chain, origin, { 32, 32 });
+}
+
+}
+
+TEST(distance_field_key_translation_invariant)
+{
+  auto at = [](glm::vec2 offset) { return key({ path(offset) }, glm::floor(offset) - 1.f); };
+  CHECK(at({ 10, 10 }) == at({ 110, 37 }));
+  CHECK(at({ 10.25f, 10.5f }) == at({ 300.25f, 7.5f }));
+
+  // subpixel position changes rasterized distance
+  CHECK(at({ 10, 10 }) != at({ 10.5f, 10 }));
+
+  // union of circle and rectangle moved together
+  auto chain = [](glm::vec2 offset)
+  {
+    auto circle = ShapeProperty{ ShapeProperty::Type::circle, {}, {}, ShapeProperty::Operator::u, { offset.x + 8.f, offset.y + 8.f, 6.f } };
+    auto rect   = ShapeProperty{ ShapeProperty::Type::rectangle, {}, {}, {}, { offset.x + 4.f, offset.y + 4.f, offset.x + 20.f, offset.y + 12.f } };
+    return key({ circle, rect }, offset - 1.f);
+  };
+  CHECK(chain({ 0, 0 }) == chain({ 64, 128 }));
+}
+
+TEST(distance_field_key_by_geometry)
+{
+  auto origin = glm::vec2{ 9, 9 };
+  auto base   = key({ path({ 10, 10 }) }, origin);
+
+  // color is applied when sampling
+  CHECK(base == key({ path({ 10, 10 }, { 0.f, 1.f, 0.f, .5f }) }, origin));
+
+  // shape moved inside same tile origin is another distance
+  CHECK(base != key({ path({ 11, 10 }) }, origin));
+  CHECK(base != distance_field_key(std::vector{ path({ 10, 10 }) }, origin, { 32, 48 }));
+
+  auto circle = [](ShapeProperty::Operator op) { return ShapeProperty{ ShapeProperty::Type::circle, {}, {}, op, { 8.f, 8.f, 6.f } }; };
+  auto rect   = ShapeProperty{ ShapeProperty::Type::rectangle, {}, {}, {}, { 4.f, 4.f, 20.f, 12.f } };
+  CHECK(key({ circle(ShapeProperty::Operator::u), rect }, {}) != key({ circle(ShapeProperty::Operator::discard), rect }, {}));
+}
+
+TEST(distance_field_cache_lru)
+{
+  auto cache = DistanceFieldCache{};
+  cache.begin_frame();
+  auto first = cache.acquire(1);
+  CHECK(first && first->need_bake && first->pos == glm::vec<2, uint32_t>{});
+  auto again = cache.acquire(1);
+  CHECK(again && !again->need_bake && again->pos == first->pos);
+
+  // every tile used by current frame, nothing is evicted
+  for (auto key = size_t{ 2 }; key <= DistanceFieldCache::Tile_Count; ++key)
+    CHECK(cache.acquire(key).has_value());
+  CHECK(!cache.acquire(0));
+
+  // next frame evicts least recently used one, which is key 1
+  cache.begin_frame();
+  auto evicted = cache.acquire(0);
+  CHECK(evicted && evicted->need_bake && evicted->pos == first->pos);
+  auto rebaked = cache.acquire(1);
+  CHECK(rebaked && rebaked->need_bake);
+}
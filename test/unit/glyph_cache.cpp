@@ -0,0 +1,124 @@
+#include "test.hpp"
+#include "vn/ui/glyph_cache.hpp"
+#include "vn/ui/msdf.hpp"
+
+#include <algorithm>
+#include <array>
+#include <ranges>
+#include <chrono>
+#include <thread>
+
+using namespace vn::ui;
+
+namespace {
+
+// square from 4 to 20 in pixels, every side is an edge so corners lie between them
+auto square(bool reversed = false) noexcept
+{
+  auto corners = std::vector<glm::vec2>{ { 4, 4 }, { 20, 4 }, { 20, 20 }, { 4, 20 } };
+  if (reversed) std::ranges::reverse(corners);
+  auto contour = std::vector<std::vector<glm::vec2>>{};
+  for (auto i = size_t{}; i < corners.size(); ++i)
+    contour.push_back({ corners[i], corners[(i + 1) % corners.size()] });
+  return GlyphOutline{ contour };
+}
+
+struct Pixel
+{
+  uint8_t median{};
+  uint8_t distance{};
+};
+
+auto pixel(std::vector<uint8_t> const& pixels, uint32_t width, uint32_t x, uint32_t y) noexcept
+{
+  auto p = &pixels[(y * width + x) * 4];
+  return Pixel{ std::max(std::min(p[0], p[1]), std::min(std::max(p[0], p[1]), p[2])), p[3] };
+}
+
+}
+
+TEST(generate_msdf_inside_positive)
+{
+  auto pixels = generate_msdf(square(), { 24, 24 }, 4.f);
+  CHECK(pixels.size() == 24 * 24 * 4);
+
+  auto center = pixel(pixels, 24, 12, 12);
+  CHECK(center.median > 128 && center.distance > 128);
+  auto outside = pixel(pixels, 24, 1, 1);
+  CHECK(outside.median < 128 && outside.distance < 128);
+
+  // distance beyond half of range is clamped
+  CHECK(center.distance == 255 && outside.distance == 0);
+
+  // just inside and outside of edge
+  CHECK(pixel(pixels, 24, 12, 4).median > 128);
+  CHECK(pixel(pixels, 24, 12, 3).median < 128);
+}
+
+TEST(generate_msdf_sharp_corner)
+{
+  // pixels around corner keep its side, median of channels not rounds it
+  auto pixels = generate_msdf(square(), { 24, 24 }, 4.f);
+  CHECK(pixel(pixels, 24, 19, 19).median > 128);
+  CHECK(pixel(pixels, 24, 20, 20).median < 128);
+  CHECK(pixel(pixels, 24, 20, 19).median < 128);
+  CHECK(pixel(pixels, 24, 19, 20).median < 128);
+}
+
+TEST(generate_msdf_orientation)
+{
+  auto pixels   = generate_msdf(square(),     { 24, 24 }, 4.f);
+  auto reversed = generate_msdf(square(true), { 24, 24 }, 4.f);
+  for (auto y = 0u; y < 24; ++y)
+    for (auto x = 0u; x < 24; ++x)
+      CHECK((pixel(pixels, 24, x, y).median > 128) == (pixel(reversed, 24, x, y).median > 128));
+}
+
+TEST(font_missing_file_is_invalid)
+{
+  auto font = Font{};
+  font.init("missing font.ttf");
+  CHECK(!font.valid());
+}
+
+TEST(glyph_cache_rasterizes_in_background)
+{
+  auto  cache = GlyphCache{};
+  auto& font  = cache.font(default_font());
+  CHECK(font.valid());
+  if (!font.valid()) return;
+
+  // same font of file is loaded once
+  CHECK(&cache.font(default_font()) == &font);
+
+  auto uploads = std::vector<GlyphUpload>{};
+  cache.begin_frame(uploads);
+  auto const& glyph = font.glyph('A');
+  CHECK(!glyph.empty);
+  CHECK(!cache.acquire(font, glyph));
+
+  // ready from a later frame once worker finishes
+  for (auto i = 0; i < 1000 && uploads.empty(); ++i)
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds{ 1 });
+    cache.begin_frame(uploads);
+  }
+  CHECK(uploads.size() == 1 && cache.ready_count() == 1);
+  if (uploads.empty()) return;
+
+  auto const& upload = uploads.front();
+  CHECK(upload.pixels.size() == upload.extent.x * upload.extent.y * 4);
+  CHECK(upload.extent.x <= GlyphCache::Cell_Size - 2 && upload.extent.y <= GlyphCache::Cell_Size - 2);
+
+  auto cached = cache.acquire(font, glyph);
+  CHECK(cached.has_value());
+  if (!cached) return;
+  CHECK(cached->uv_min == glm::vec2{ upload.pos } / static_cast<float>(GlyphCache::Atlas_Size));
+  CHECK(cached->uv_max.x > cached->uv_min.x && cached->uv_max.y > cached->uv_min.y);
+
+  // static blocks keep using glyph while its cell is not given to another one
+  CHECK(cache.touch(std::array{ cached->use }));
+  auto stale = cached->use;
+  ++stale.version;
+  CHECK(!cache.touch(std::array{ stale }));
+}
@@ -0,0 +1,87 @@
+#include "test.hpp"
+#include "vn/ui/hit_grid.hpp"
+
+using namespace vn::ui;
+
+TEST(hit_grid_top_most)
+{
+  auto grid = HitGrid{};
+  grid.reset({ 300, 200 });
+  grid.insert(1, { 0, 0 },     { 300, 200 });
+  grid.insert(2, { 50, 50 },   { 150, 150 }); // spans four cells
+  grid.insert(3, { 100, 100 }, { 200, 180 });
+  CHECK(grid.size() == 3);
+
+  CHECK(grid.query({ 10, 10 })   == 1u);
+  CHECK(grid.query({ 60, 60 })   == 2u);
+  CHECK(grid.query({ 120, 120 }) == 3u);
+  CHECK(grid.query({ 150, 150 }) == 3u);
+  CHECK(grid.query({ 150, 60 })  == 2u); // edges included
+  CHECK(grid.query_index({ 120, 120 }) == 2u);
+
+  // outside of window
+  CHECK(!grid.query({ -1, 10 }));
+  CHECK(!grid.query({ 10, 201 }));
+}
+
+TEST(hit_grid_reset_and_clip)
+{
+  auto grid = HitGrid{};
+  grid.reset({ 300, 200 });
+  grid.insert(1, { 0, 0 }, { 100, 100 });
+
+  // next recording drops widgets of last one
+  grid.reset({ 300, 200 });
+  CHECK(grid.size() == 0 && !grid.query({ 50, 50 }));
+
+  // part outside window is dropped, widgets fully outside are not inserted
+  grid.insert(2, { -100, -100 }, { 20, 20 });
+  grid.insert(3, { 400, 0 },     { 500, 100 });
+  CHECK(grid.size() == 1);
+  CHECK(grid.query({ 0, 0 }) == 2u && !grid.query({ 21, 21 }));
+
+  // resized window covers new area
+  grid.reset({ 600, 400 });
+  grid.insert(4, { 500, 300 }, { 600, 400 });
+  CHECK(grid.query({ 600, 400 }) == 4u);
+}
+
+TEST(hit_grid_click_top_most_at_press_and_release)
+{
+  auto grid = HitGrid{};
+  grid.reset({ 300, 200 });
+  grid.insert(1, { 0, 0 },   { 300, 200 });
+  grid.insert(2, { 50, 50 }, { 150, 150 });
+
+  // only the top-most widget is clicked, widget under it not
+  CHECK(grid.query_click({ 60, 60 }, { 100, 100 }) == 2u);
+  CHECK(grid.query_click({ 10, 10 }, { 20, 20 })   == 1u);
+
+  // released on another widget or out of window clicks nothing
+  CHECK(!grid.query_click({ 60, 60 }, { 10, 10 }));
+  CHECK(!grid.query_click({ 60, 60 }, { 400, 10 }));
+}
+
+TEST(hit_grid_hover_lags_one_recording)
+{
+  // mirrors recording of window, widget under cursor is resolved from last recording then widgets are inserted again
+  auto grid   = HitGrid{};
+  auto cursor = glm::vec2{ 100, 100 };
+  auto record = [&](std::vector<size_t> const& ids)
+  {
+    auto hovered = grid.query(cursor);
+    grid.reset({ 300, 200 });
+    for (auto id : ids)
+      grid.insert(id, { 50, 50 }, { 150, 150 });
+    return hovered;
+  };
+  CHECK(!record({ 1 }));
+
+  // widget drawn over hovered one takes hover from next recording, this lag is deliberate
+  CHECK(record({ 1, 2 }) == 1u);
+  CHECK(record({ 1, 2 }) == 2u);
+
+  // removed widget is still hovered by the recording right after it
+  CHECK(record({ 1 }) == 2u);
+  CHECK(record({ 1 }) == 1u);
+}
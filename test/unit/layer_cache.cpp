@@ -0,0 +1,82 @@
+#include "test.hpp"
+#include "vn/ui/layer_cache.hpp"
+
+using namespace vn::ui;
+
+namespace {
+
+// 8 mb with render target and texture, four of them fill budget
+auto const Large = glm::vec<2, uint32_t>{ 1024, 1024 };
+
+}
+
+TEST(layer_cache_hit_and_extent_change)
+{
+  auto cache = LayerCache{};
+  cache.begin_frame();
+  auto first = cache.acquire(1, 10, { 100, 100 });
+  CHECK(first.need_render);
+  CHECK(cache.byte_size() == layer_byte_size({ 100, 100 }));
+  CHECK(layer_image_extent({ 100, 100 }) == glm::vec<2, uint32_t>{ 128, 128 });
+
+  auto hit = cache.acquire(1, 10, { 100, 100 });
+  CHECK(!hit.need_render && hit.version == first.version);
+
+  // extent change renders again and budget follows new extent
+  auto resized = cache.acquire(1, 10, { 300, 100 });
+  CHECK(resized.need_render && resized.version != first.version);
+  CHECK(cache.byte_size() == layer_byte_size({ 300, 100 }));
+
+  // so does key change
+  auto changed = cache.acquire(1, 11, { 300, 100 });
+  CHECK(changed.need_render && changed.version != resized.version);
+  CHECK(cache.byte_size() == layer_byte_size({ 300, 100 }));
+
+  CHECK(cache.stats().hit_count == 1 && cache.stats().miss_count == 3);
+}
+
+TEST(layer_cache_evicts_least_recently_used)
+{
+  auto cache    = LayerCache{};
+  auto released = std::vector<size_t>{};
+  cache.begin_frame();
+  for (auto id = size_t{ 1 }; id <= 5; ++id)
+    cache.acquire(id, id, Large);
+  CHECK(cache.byte_size() > LayerCache::Memory_Budget);
+
+  // every layer is used by current frame, budget is exceeded until they are unused
+  cache.evict(released);
+  CHECK(released.empty());
+
+  // next frame uses first one again, so second one is least recently used
+  cache.begin_frame();
+  CHECK(!cache.acquire(1, 1, Large).need_render);
+  cache.evict(released);
+  CHECK(released == std::vector<size_t>{ 2 });
+  CHECK(cache.byte_size() == layer_byte_size(Large) * 4);
+  CHECK(cache.stats().evicted_count == 1);
+
+  // evicted layer is rendered again
+  cache.begin_frame();
+  CHECK(cache.acquire(2, 2, Large).need_render);
+  CHECK(!cache.acquire(3, 3, Large).need_render);
+  released.clear();
+  cache.evict(released);
+  CHECK(released == std::vector<size_t>{ 4 });
+}
+
+TEST(layer_cache_count_limit)
+{
+  auto cache    = LayerCache{};
+  auto released = std::vector<size_t>{};
+  cache.begin_frame();
+  for (auto id = size_t{}; id <= LayerCache::Max_Count; ++id)
+    cache.acquire(id, id, { 1, 1 });
+  cache.evict(released);
+  CHECK(released.empty());
+
+  cache.begin_frame();
+  cache.evict(released);
+  CHECK(released == std::vector<size_t>{ 0 });
+  CHECK(cache.byte_size() == layer_byte_size({ 1, 1 }) * LayerCache::Max_Count);
+}
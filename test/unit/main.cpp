@@ -0,0 +1,18 @@
+#include "test.hpp"
+
+using namespace vn::test;
+
+int main()
+{
+  auto failed_cases = 0;
+  for (auto const& test_case : test_cases())
+  {
+    auto failures = failure_count();
+    test_case.func();
+    auto failed = failure_count() != failures;
+    failed_cases += failed;
+    std::println("[{}] {}", failed ? "fail" : " ok ", test_case.name);
+  }
+  std::println("{} of {} tests passed", test_cases().size() - failed_cases, test_cases().size());
+  return failed_cases ? 1 : 0;
+}
@@ -0,0 +1,47 @@
+#include "test.hpp"
+#include "vn/ui/missing_content.hpp"
+
+using namespace vn::ui;
+
+TEST(missing_content_static_block_valid)
+{
+  // block drawing an image still uploading is cached invalid, so it is recorded again next frame
+  auto missing  = MissingContent{};
+  auto snapshot = missing;
+  ++missing.image_count;
+  CHECK(missing.missed_since(snapshot));
+
+  // same for glyphs
+  snapshot = missing;
+  ++missing.glyph_count;
+  CHECK(missing.missed_since(snapshot));
+
+  // once everything is ready nothing is skipped, block is kept
+  snapshot = missing;
+  CHECK(!missing.missed_since(snapshot));
+}
+
+TEST(missing_content_layer_key)
+{
+  auto missing  = MissingContent{};
+  auto snapshot = missing;
+
+  // complete layer keeps key of caller
+  CHECK(missing.stale_key(snapshot, 42, 1, 1) == 42);
+
+  // layer missing an image changes key only when upload count changes
+  ++missing.image_count;
+  auto key = missing.stale_key(snapshot, 42, 1, 1);
+  CHECK(key != 42);
+  CHECK(missing.stale_key(snapshot, 42, 2, 1) == key);
+  CHECK(missing.stale_key(snapshot, 42, 1, 2) != key);
+
+  // layer missing a glyph changes key with ready count of glyphs
+  missing  = {};
+  snapshot = missing;
+  ++missing.glyph_count;
+  key = missing.stale_key(snapshot, 42, 1, 1);
+  CHECK(key != 42);
+  CHECK(missing.stale_key(snapshot, 42, 1, 2) == key);
+  CHECK(missing.stale_key(snapshot, 42, 2, 1) != key);
+}
@@ -0,0 +1,96 @@
+#include "test.hpp"
+#include "vn/object_pool.hpp"
+
+#include <ranges>
+#include <algorithm>
+
+using namespace vn;
+
+namespace {
+
+struct Object
+{
+  uint32_t value{};
+};
+
+// two words of alive bits per block, second one partially used
+using Pool = ObjectPool<Object, 100>;
+
+auto live_values(Pool& pool) noexcept
+{
+  auto values = std::vector<uint32_t>{};
+  pool.for_each([&](Object& object) { values.emplace_back(object.value); });
+  return values;
+}
+
+}
+
+TEST(object_pool_for_each_live)
+{
+  auto pool    = Pool{};
+  auto handles = std::vector<Pool::Handle>{};
+  for (auto i = 0u; i < 250; ++i)
+  {
+    handles.emplace_back(pool.create());
+    pool.get(handles.back())->value = i;
+  }
+
+  // holes around word and block boundaries
+  auto removed = std::vector<uint32_t>{ 0, 63, 64, 65, 99, 100, 163, 164, 249 };
+  for (auto i : removed)
+    pool.destroy(handles[i]);
+  CHECK(pool.size() == 250 - removed.size());
+
+  auto expected = std::views::iota(0u, 250u)
+                | std::views::filter([&](auto i) { return std::ranges::find(removed, i) == removed.end(); })
+                | std::ranges::to<std::vector>();
+  CHECK(live_values(pool) == expected);
+
+  // handles passed to function address same objects
+  auto same = true;
+  pool.for_each([&](Pool::Handle handle, Object& object) { same = same && pool.get(handle) == &object; });
+  CHECK(same);
+
+  pool.destroy_all();
+}
+
+TEST(object_pool_destroy_all)
+{
+  auto pool = Pool{};
+  for (auto i = 0u; i < 150; ++i)
+    pool.get(pool.create())->value = i;
+
+  auto destroyed = 0u;
+  pool.destroy_all([&](Object&) { ++destroyed; });
+  CHECK(destroyed == 150);
+  CHECK(pool.empty() && live_values(pool).empty());
+
+  auto stats = pool.stats();
+  CHECK(stats.alive == 0 && stats.free_slots == 150 && stats.occupancy == 0.f && stats.fragmentation == 1.f);
+
+  // slots are reused rather than growing pool
+  for (auto i = 0u; i < 150; ++i)
+    pool.get(pool.create())->value = i;
+  CHECK(pool.stats().capacity == stats.capacity && pool.stats().free_slots == 0);
+  CHECK(live_values(pool).size() == 150);
+  pool.destroy_all();
+}
+
+TEST(object_pool_generation_of_reused_slot)
+{
+  auto pool   = Pool{};
+  auto handle = pool.create();
+  auto object = pool.get(handle);
+  auto stale  = handle;
+  pool.destroy(handle);
+  CHECK(!handle.valid());
+
+  // same slot is handed out again with a new generation, so stale handle not matches it
+  auto reused = pool.create();
+  CHECK(pool.get(reused) == object);
+  CHECK(reused.valid() && reused != stale);
+
+  auto stats = pool.stats();
+  CHECK(stats.alive == 1 && stats.free_slots == 0 && stats.fragmentation == 0.f);
+  pool.destroy(reused);
+}
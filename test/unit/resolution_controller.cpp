@@ -0,0 +1,52 @@
+#include "test.hpp"
+#include "vn/renderer/resolution_controller.hpp"
+
+using namespace vn::renderer;
+
+TEST(resolution_controller_keeps_scale_in_budget)
+{
+  auto controller = ResolutionController{ 10.f };
+  for (auto i = 0; i < 100; ++i)
+    CHECK(controller.update(9.f) == ResolutionController::Max_Scale);
+}
+
+TEST(resolution_controller_lowers_by_cost)
+{
+  // four times over budget lowers to half at once, as pixel count is a quarter
+  auto controller = ResolutionController{ 10.f };
+  CHECK(controller.update(40.f) == .5f);
+
+  // slightly over budget still lowers at least one step
+  controller.reset();
+  controller.update(10.f);
+  auto scale = controller.update(20.f);
+  CHECK(scale <= ResolutionController::Max_Scale - ResolutionController::Scale_Step);
+  CHECK(scale > .5f);
+
+  // never under min scale
+  for (auto i = 0; i < 10; ++i)
+    scale = controller.update(1000.f);
+  CHECK(scale == ResolutionController::Min_Scale);
+}
+
+TEST(resolution_controller_raises_after_delay)
+{
+  auto controller = ResolutionController{ 10.f };
+  auto scale      = controller.update(40.f);
+
+  // raised one step only after enough frames under budget
+  for (auto i = 1u; i < ResolutionController::Raise_Delay; ++i)
+    CHECK(controller.update(5.f) == scale);
+  CHECK(controller.update(5.f) == scale + ResolutionController::Scale_Step);
+
+  // average between budgets restarts counting
+  for (auto i = 1u; i < ResolutionController::Raise_Delay; ++i)
+    controller.update(5.f);
+  controller.update(29.f);
+  for (auto i = 1u; i < ResolutionController::Raise_Delay; ++i)
+    controller.update(5.f);
+  CHECK(controller.scale() == scale + ResolutionController::Scale_Step);
+
+  controller.reset();
+  CHECK(controller.scale() == ResolutionController::Max_Scale);
+}
@@ -0,0 +1,65 @@
+#include "test.hpp"
+#include "vn/ui/scroll_list.hpp"
+
+#include <cmath>
+
+using namespace vn::ui;
+
+TEST(list_index_tops_and_range)
+{
+  auto index    = ListIndex{};
+  auto measured = 0u;
+  auto height   = [&](uint32_t i) { ++measured; return i % 2 ? 20.f : 10.f; };
+  index.update(6, height, 0);
+  CHECK(index.count() == 6 && index.height() == 90.f);
+  CHECK(index.item_top(3) == 40.f && index.item_height(3) == 20.f);
+
+  // items overlapping view, edges touching view are excluded
+  CHECK(index.range(0.f,   10.f) == std::pair{ 0u, 1u });
+  CHECK(index.range(15.f,  45.f) == std::pair{ 1u, 4u });
+  CHECK(index.range(90.f, 100.f) == std::pair{ 6u, 6u });
+
+  // appended items are measured, existing ones are not
+  measured = 0;
+  index.update(8, height, 0);
+  CHECK(measured == 2 && index.height() == 120.f);
+
+  // removed items drop their tops
+  index.update(4, height, 0);
+  CHECK(measured == 2 && index.count() == 4 && index.height() == 60.f);
+
+  // new version measures all again
+  index.update(4, [&](uint32_t) { ++measured; return 5.f; }, 1);
+  CHECK(measured == 6 && index.height() == 20.f);
+}
+
+TEST(scroll_state_kinetic_by_frame_time)
+{
+  // one notch travels its distance until stopped, no matter frame rate
+  auto travel = [](float delta_time)
+  {
+    auto scroll = ScrollState{};
+    scroll.update(-1.f, delta_time, 1000.f);
+    for (auto i = 0; i < 10000 && scroll.scrolling(); ++i)
+      scroll.update(0.f, delta_time, 1000.f);
+    return scroll.offset;
+  };
+  auto slow = travel(1.f / 30);
+  auto fast = travel(1.f / 240);
+  CHECK(std::abs(slow - fast) < 1.f);
+  CHECK(slow > Scroll_Distance_Of_Notch - 1.f && slow <= Scroll_Distance_Of_Notch);
+}
+
+TEST(scroll_state_clamped)
+{
+  auto scroll = ScrollState{};
+  scroll.update(1.f, 1.f / 60, 500.f);
+  CHECK(scroll.offset == 0.f && !scroll.scrolling());
+
+  scroll.update(-10.f, 1.f, 50.f);
+  CHECK(scroll.offset == 50.f && !scroll.scrolling());
+
+  // content shorter than view never scrolls
+  scroll.update(-1.f, 1.f / 60, -20.f);
+  CHECK(scroll.offset == 0.f);
+}
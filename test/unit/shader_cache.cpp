@@ -0,0 +1,76 @@
+#include "test.hpp"
+#include "vn/renderer/shader_cache.hpp"
+
+using namespace vn::renderer;
+
+namespace {
+
+auto make_entry() noexcept
+{
+  auto entry = ShaderCacheEntry{};
+  entry.vs             = { 1, 2, 3, 4 };
+  entry.ps             = { 5, 6 };
+  entry.root_signature = { 7, 8, 9 };
+  entry.input_elements = { { "POSITION", 0, 16 }, { "TEXCOORD", 1, 41 } };
+  entry.resource_indexs = { { "shape_properties", 0 }, { "images", 3 }, { "samplers", 7 } };
+  return entry;
+}
+
+}
+
+TEST(shader_cache_round_trip)
+{
+  auto entry = make_entry();
+  auto data  = serialize(entry);
+  auto read  = deserialize(data);
+  CHECK(read.has_value());
+  CHECK(read == entry);
+
+  // same entry always produces same bytes, whatever order of resource map is
+  auto other = ShaderCacheEntry{ entry };
+  other.resource_indexs.clear();
+  other.resource_indexs.insert(entry.resource_indexs.begin(), entry.resource_indexs.end());
+  CHECK(serialize(other) == data);
+
+  auto compute = ShaderCacheEntry{};
+  compute.cs = { 42 };
+  CHECK(deserialize(serialize(compute)) == compute);
+}
+
+TEST(shader_cache_rejects_truncated)
+{
+  auto data = serialize(make_entry());
+  for (auto size = size_t{}; size < data.size(); ++size)
+    CHECK(!deserialize(std::span{ data }.first(size)));
+}
+
+TEST(shader_cache_rejects_corrupted)
+{
+  auto data = serialize(make_entry());
+  for (auto i = size_t{}; i < data.size(); ++i)
+  {
+    auto corrupted = data;
+    corrupted[i] ^= 0x10;
+    CHECK(!deserialize(corrupted));
+  }
+
+  // trailing garbage is not part of entry
+  auto appended = data;
+  appended.emplace_back(0);
+  CHECK(!deserialize(appended));
+}
+
+TEST(shader_cache_key_covers_inputs)
+{
+  auto sources      = std::vector<std::string>{ "ab", "c" };
+  auto split        = std::vector<std::string>{ "a", "bc" };
+  auto entry_points = std::vector<std::string_view>{ "vs", "vs_6_0", "ps", "ps_6_0" };
+  auto args         = std::vector<std::wstring_view>{ L"-O3" };
+  auto other_args   = std::vector<std::wstring_view>{ L"-O0" };
+
+  auto key = shader_cache_key(sources, entry_points, args);
+  CHECK(key == shader_cache_key(sources, entry_points, args));
+  CHECK(key != shader_cache_key(split, entry_points, args));
+  CHECK(key != shader_cache_key(sources, std::span{ entry_points }.first(2), args));
+  CHECK(key != shader_cache_key(sources, entry_points, other_args));
+}
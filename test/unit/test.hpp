@@ -0,0 +1,55 @@
+#pragma once
+
+#include <print>
+#include <vector>
+#include <string_view>
+#include <source_location>
+#include <cstdint>
+
+namespace vn { namespace test {
+
+/**
+ * minimal test registry, cases register themselves before main and run in order of registration
+ * failed checks are reported and counted, a case keeps running after them
+ */
+struct TestCase
+{
+  std::string_view name;
+  void           (*func)() noexcept;
+};
+
+inline auto test_cases() noexcept -> std::vector<TestCase>&
+{
+  static auto cases = std::vector<TestCase>{};
+  return cases;
+}
+
+inline auto failure_count() noexcept -> uint32_t&
+{
+  static auto count = uint32_t{};
+  return count;
+}
+
+struct TestRegistrar
+{
+  TestRegistrar(std::string_view name, void (*func)() noexcept) noexcept
+  {
+    test_cases().emplace_back(name, func);
+  }
+};
+
+inline void check(bool result, std::string_view expr, std::source_location location = std::source_location::current()) noexcept
+{
+  if (result) return;
+  ++failure_count();
+  std::println(stderr, "  {}:{}: check failed: {}", location.file_name(), location.line(), expr);
+}
+
+}}
+
+#define TEST(name)                                                                           \
+  static void test_##name() noexcept;                                                        \
+  static auto const test_registrar_##name = vn::test::TestRegistrar{ #name, &test_##name }; \
+  static void test_##name() noexcept
+
+#define CHECK(...) vn::test::check(static_cast<bool>(__VA_ARGS__), #__VA_ARGS__)
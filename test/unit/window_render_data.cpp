@@ -0,0 +1,197 @@
+#include "test.hpp"
+#include "vn/ui/window_render_data.hpp"
+
+#include <algorithm>
+#include <ranges>
+
+using namespace vn::renderer;
+using namespace vn::ui;
+
+namespace {
+
+constexpr auto Red  = glm::vec4{ 1.f, 0.f, 0.f, 1.f };
+constexpr auto Blue = glm::vec4{ 0.f, 0.f, 1.f, .5f };
+
+/// append quad of shape like recording does, @return index of quad
+auto add_quad(WindowRenderData& data, ShapeProperty const& shape, glm::vec2 min, glm::vec2 max) noexcept
+{
+  auto offset = data.shape_properties.empty() ? 0u : data.shape_property_offsets().back() + static_cast<uint32_t>(data.shape_properties.back().byte_size());
+  data.shape_properties.emplace_back(shape);
+
+  auto beg = data.idx_beg;
+  data.vertices.append_range(std::array<Vertex, 4>
+  {
+    Vertex{ { min.x, min.y, 0.f }, { 0.f, 0.f }, offset },
+    Vertex{ { max.x, min.y, 0.f }, { 1.f, 0.f }, offset },
+    Vertex{ { max.x, max.y, 0.f }, { 1.f, 1.f }, offset },
+    Vertex{ { min.x, max.y, 0.f }, { 0.f, 1.f }, offset },
+  });
+  data.indices.append_range(std::array<uint16_t, 6>
+  {
+    static_cast<uint16_t>(beg + 0), static_cast<uint16_t>(beg + 1), static_cast<uint16_t>(beg + 2),
+    static_cast<uint16_t>(beg + 0), static_cast<uint16_t>(beg + 2), static_cast<uint16_t>(beg + 3),
+  });
+  data.idx_beg += 4;
+  return static_cast<uint32_t>(beg / 4);
+}
+
+/// quads in drawing order after build_batches
+auto drawn_quads(WindowRenderData const& data) noexcept
+{
+  return data.indices | std::views::stride(6) | std::views::transform([](auto index) { return static_cast<uint32_t>(index / 4); }) | std::ranges::to<std::vector>();
+}
+
+auto drawn_before(std::vector<uint32_t> const& order, uint32_t a, uint32_t b) noexcept
+{
+  return std::ranges::find(order, a) < std::ranges::find(order, b);
+}
+
+auto rectangle(glm::vec4 color = Blue) noexcept { return ShapeProperty{ ShapeProperty::Type::rectangle, color }; }
+auto circle(glm::vec4 color = Blue)    noexcept { return ShapeProperty{ ShapeProperty::Type::circle, color }; }
+
+}
+
+TEST(build_batches_merges_disjoint_quads)
+{
+  // circle between two rectangles not overlapping them, second rectangle moves forward into first batch
+  auto data = WindowRenderData{};
+  auto a    = add_quad(data, rectangle(), { 0, 0 },   { 10, 10 });
+  auto b    = add_quad(data, circle(),    { 20, 0 },  { 30, 10 });
+  auto c    = add_quad(data, rectangle(), { 40, 0 },  { 50, 10 });
+  data.build_batches();
+
+  CHECK(data.batches.size() == 2);
+  CHECK(data.batches[0].permutation == PixelShaderPermutation::rectangle);
+  CHECK(data.batches[0].index_count == 12);
+  CHECK(data.batches[1].permutation == PixelShaderPermutation::circle);
+  CHECK(drawn_quads(data) == std::vector{ a, c, b });
+}
+
+TEST(build_batches_keeps_order_under_overlap)
+{
+  // circle overlaps the later rectangle, so rectangle can not move before circle
+  auto data = WindowRenderData{};
+  auto a    = add_quad(data, rectangle(), { 0, 0 },  { 10, 10 });
+  auto b    = add_quad(data, circle(),    { 5, 5 },  { 15, 15 });
+  auto c    = add_quad(data, rectangle(), { 12, 12 }, { 20, 20 });
+  data.build_batches();
+
+  CHECK(data.batches.size() == 3);
+  auto order = drawn_quads(data);
+  CHECK(drawn_before(order, a, b));
+  CHECK(drawn_before(order, b, c));
+
+  // every pair of overlapping quads keeps recorded order
+  auto overlap_data = WindowRenderData{};
+  auto quads        = std::vector<std::pair<glm::vec2, glm::vec2>>{};
+  for (auto i = 0; i < 24; ++i)
+  {
+    auto min = glm::vec2{ static_cast<float>(i * 7 % 40), static_cast<float>(i * 13 % 40) };
+    auto max = min + 12.f;
+    add_quad(overlap_data, i % 3 == 0 ? rectangle() : i % 3 == 1 ? circle() : ShapeProperty{ ShapeProperty::Type::line, Blue }, min, max);
+    quads.emplace_back(min, max);
+  }
+  overlap_data.build_batches();
+  order = drawn_quads(overlap_data);
+  CHECK(order.size() == quads.size());
+  for (auto i = 0u; i < quads.size(); ++i)
+    for (auto j = i + 1; j < quads.size(); ++j)
+    {
+      auto [min_i, max_i] = quads[i];
+      auto [min_j, max_j] = quads[j];
+      if (min_i.x < max_j.x && min_j.x < max_i.x && min_i.y < max_j.y && min_j.y < max_i.y)
+        CHECK(drawn_before(order, i, j));
+    }
+}
+
+TEST(build_batches_seals_cursor_and_drag_cache)
+{
+  auto data   = WindowRenderData{};
+  auto a      = add_quad(data, ShapeProperty{ ShapeProperty::Type::image }, { 0, 0 }, { 10, 10 });
+  auto drag   = add_quad(data, ShapeProperty{ ShapeProperty::Type::drag_cache }, { 0, 0 }, { 100, 100 });
+  auto cursor = add_quad(data, ShapeProperty{ ShapeProperty::Type::cursor }, { 50, 50 }, { 60, 60 });
+  data.build_batches();
+
+  // same permutation, but sealed quads never join other batches
+  CHECK(data.batches.size() == 3);
+  CHECK(drawn_quads(data) == std::vector{ a, drag, cursor });
+  CHECK(data.batches.back().index_count == 6);
+
+  // renderer splits content captured into drag cache at flagged batch
+  CHECK(std::ranges::count_if(data.batches, &DrawBatch::drag_cache) == 1);
+  CHECK(data.batches[1].drag_cache);
+}
+
+TEST(build_batches_opaque_pass)
+{
+  // opaque quads lead and are drawn front to back, translucent ones keep order after them
+  auto data = WindowRenderData{};
+  auto a    = add_quad(data, rectangle(Red), { 0, 0 },  { 10, 10 });
+  auto b    = add_quad(data, circle(),       { 5, 5 },  { 15, 15 });
+  auto c    = add_quad(data, rectangle(Red), { 8, 8 },  { 20, 20 });
+  data.build_batches(true);
+
+  CHECK(data.batches.size() == 2);
+  CHECK(data.batches[0].opaque);
+  CHECK(!data.batches[1].opaque);
+  CHECK(drawn_quads(data) == std::vector{ c, a, b });
+
+  // later quad is nearer
+  CHECK(data.vertices[c * 4].pos.z < data.vertices[b * 4].pos.z);
+  CHECK(data.vertices[b * 4].pos.z < data.vertices[a * 4].pos.z);
+}
+
+TEST(cull_occluded_removes_covered_quads)
+{
+  // opaque rectangle over a circle and a translucent rectangle hides them, the one outside stays
+  auto data    = WindowRenderData{};
+  add_quad(data, circle(), { 10, 10 }, { 20, 20 });
+  auto visible = add_quad(data, circle(),       { 200, 10 }, { 220, 20 });
+  auto clipped = add_quad(data, rectangle(),    { 0, 40 },  { 50, 80 });
+  auto cover   = add_quad(data, rectangle(Red), { 0, 0 },   { 100, 60 });
+  auto stats   = data.cull_occluded({ 1000, 1000 });
+
+  CHECK(stats.quad_count == 4);
+  CHECK(stats.culled_count == 1);
+  CHECK(stats.clipped_count == 1);
+  CHECK(data.vertices.size() == 3 * 4);
+  CHECK(data.indices.size() == 3 * 6);
+  CHECK(data.idx_beg == 3 * 4);
+
+  // first quad is culled, so later ones move forward by one
+  // clipped quad keeps uncovered bottom, uv follows so shape is not stretched
+  auto const& v0 = data.vertices[(clipped - 1) * 4];
+  auto const& v2 = data.vertices[(clipped - 1) * 4 + 2];
+  CHECK(v0.pos.y == 60.f);
+  CHECK(v2.pos.y == 80.f);
+  CHECK(v0.uv.y == .5f);
+  CHECK(v2.uv.y == 1.f);
+
+  CHECK(data.vertices[(visible - 1) * 4].pos.x == 200.f);
+  CHECK(data.vertices[(cover - 1) * 4 + 2].pos.x == 100.f);
+}
+
+TEST(cull_occluded_only_later_opaque_hides)
+{
+  // translucent cover and quads drawn after opaque one are never culled
+  auto data = WindowRenderData{};
+  add_quad(data, rectangle(Red), { 0, 0 },   { 100, 100 });
+  add_quad(data, circle(),       { 10, 10 }, { 20, 20 });
+  add_quad(data, rectangle(),    { 0, 0 },   { 100, 100 });
+  auto stats = data.cull_occluded({ 1000, 1000 });
+  CHECK(stats.culled_count == 0);
+  CHECK(stats.clipped_count == 0);
+  CHECK(data.vertices.size() == 3 * 4);
+
+  // content is scissored, opaque quad out of extent not hides quads there
+  auto outside = WindowRenderData{};
+  add_quad(outside, circle(),       { 150, 10 }, { 160, 20 });
+  add_quad(outside, rectangle(Red), { 0, 0 },    { 200, 100 });
+  CHECK(outside.cull_occluded({ 100, 100 }).culled_count == 0);
+
+  // opaque flag makes shapes which are not opaque by type hide others
+  auto flagged = WindowRenderData{};
+  add_quad(flagged, circle(), { 10, 10 }, { 20, 20 });
+  add_quad(flagged, ShapeProperty{ ShapeProperty::Type::image, {}, {}, {}, {}, ShapeProperty::Flag::opaque }, { 0, 0 }, { 50, 50 });
+  CHECK(flagged.cull_occluded({ 1000, 1000 }).culled_count == 1);
+}
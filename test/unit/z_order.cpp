@@ -0,0 +1,63 @@
+#include "test.hpp"
+#include "vn/renderer/z_order.hpp"
+
+using namespace vn::renderer;
+
+namespace {
+
+auto ids(ZOrder const& order) noexcept
+{
+  return std::vector<uint32_t>{ order.ids().begin(), order.ids().end() };
+}
+
+}
+
+TEST(z_order_raise_lower)
+{
+  auto order = ZOrder{};
+  order.raise(1);
+  order.raise(2);
+  order.raise(3);
+  CHECK(ids(order) == std::vector<uint32_t>{ 3, 2, 1 });
+
+  // raising existing window moves it rather than adding another
+  order.raise(1);
+  CHECK(ids(order) == std::vector<uint32_t>{ 1, 3, 2 });
+
+  order.lower(3);
+  order.lower(4);
+  CHECK(ids(order) == std::vector<uint32_t>{ 1, 2, 3, 4 });
+
+  order.erase(2);
+  CHECK(ids(order) == std::vector<uint32_t>{ 1, 3, 4 });
+}
+
+TEST(z_order_place_under)
+{
+  auto order = ZOrder{};
+  order.assign({ 1, 2, 3 });
+
+  order.place_under(3, 1);
+  CHECK(ids(order) == std::vector<uint32_t>{ 1, 3, 2 });
+
+  // top-most window moves down under other one
+  order.place_under(1, 2);
+  CHECK(ids(order) == std::vector<uint32_t>{ 3, 2, 1 });
+
+  // other one not in order raises window
+  order.place_under(1, 9);
+  CHECK(ids(order) == std::vector<uint32_t>{ 1, 3, 2 });
+
+  // new window is added under other one
+  order.place_under(5, 3);
+  CHECK(ids(order) == std::vector<uint32_t>{ 1, 3, 5, 2 });
+}
+
+TEST(z_order_find_top_most)
+{
+  auto order = ZOrder{};
+  order.assign({ 4, 2, 7 });
+  CHECK(order.find([](auto id) { return id != 4; }) == 2u);
+  CHECK(order.find([](auto id) { return id > 5; })  == 7u);
+  CHECK(order.find([](auto)    { return false; })   == 0u);
+}